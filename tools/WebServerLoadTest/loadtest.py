@@ -0,0 +1,253 @@
+#!/usr/bin/env python
+#
+#      Copyright (C) 2005-2012 Team XBMC
+#      http://www.xbmc.org
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with XBMC; see the file COPYING.  If not, see
+#  <http://www.gnu.org/licenses/>.
+#
+
+"""
+Load test for XBMC's webserver.
+
+Runs a number of concurrent clients against a webserver (by default the one
+listening on the loopback interface) and reports the latency of JSON-RPC
+calls while other clients are busy downloading files. This shows whether
+slow file transfers block JSON-RPC requests and how the webserver behaves
+with different <webserver> settings in advancedsettings.xml.
+
+Every client repeatedly requests one of the following (see --mix):
+  jsonrpc  JSONRPC.Ping through /jsonrpc
+  file     the whole file given with --file (through /vfs/)
+  range    a random 64 kB range of the file given with --file
+  image    the image given with --image twice, the second time with the
+           ETag of the first response (expects 304 Not Modified)
+
+With --hold-files N another N clients start a download of --file each and
+read it very slowly until the end of the test, so that N file transfer slots
+stay busy the whole time. Together with --max-latency this checks that
+JSON-RPC stays responsive while all file slots are taken, e.g. with the
+default <webserver> settings (4 threads, maxfiletransfers 3):
+
+  loadtest.py --mix jsonrpc --clients 4 --hold-files 4 --max-latency 500 \
+    --file /media/movies/movie.mkv
+
+The fourth held download is expected to get 503 Service Unavailable.
+
+Example:
+  loadtest.py --file /media/movies/movie.mkv --image special://xbmc/media/icon.png
+"""
+
+import base64
+import json
+import optparse
+import random
+import sys
+import threading
+import time
+
+try:
+  import httplib
+  from urllib import quote
+except ImportError:
+  import http.client as httplib
+  from urllib.parse import quote
+
+class Statistics:
+  def __init__(self):
+    self.lock = threading.Lock()
+    self.latencies = {}
+    self.statuses = {}
+    self.bytes = 0
+    self.errors = 0
+
+  def add(self, kind, latency, status, size):
+    self.lock.acquire()
+    try:
+      self.latencies.setdefault(kind, []).append(latency)
+      key = "%s %d" % (kind, status)
+      self.statuses[key] = self.statuses.get(key, 0) + 1
+      self.bytes += size
+    finally:
+      self.lock.release()
+
+  def error(self):
+    self.lock.acquire()
+    self.errors += 1
+    self.lock.release()
+
+  def report(self, duration):
+    print("%-8s %8s %10s %10s %10s %10s" % ("request", "count", "avg ms", "p50 ms", "p95 ms", "max ms"))
+    for kind in sorted(self.latencies.keys()):
+      values = sorted(self.latencies[kind])
+      count = len(values)
+      print("%-8s %8d %10.1f %10.1f %10.1f %10.1f" % (kind, count,
+            1000.0 * sum(values) / count,
+            1000.0 * values[count // 2],
+            1000.0 * values[min(count - 1, int(count * 0.95))],
+            1000.0 * values[-1]))
+    print("")
+    for key in sorted(self.statuses.keys()):
+      print("%-20s %d" % (key, self.statuses[key]))
+    print("")
+    print("errors: %d" % self.errors)
+    print("throughput: %.1f MB/s" % (self.bytes / duration / 1024.0 / 1024.0))
+
+class Client(threading.Thread):
+  def __init__(self, options, mix, statistics, deadline):
+    threading.Thread.__init__(self)
+    self.options = options
+    self.mix = mix
+    self.statistics = statistics
+    self.deadline = deadline
+    self.headers = {}
+    if options.username:
+      credentials = "%s:%s" % (options.username, options.password)
+      self.headers["Authorization"] = "Basic " + base64.b64encode(credentials.encode("utf-8")).decode("ascii")
+
+  def request(self, method, url, body=None, headers={}):
+    allheaders = dict(self.headers)
+    allheaders.update(headers)
+    connection = httplib.HTTPConnection(self.options.host, self.options.port, timeout=self.options.timeout)
+    try:
+      start = time.time()
+      connection.request(method, url, body, allheaders)
+      response = connection.getresponse()
+      size = 0
+      while True:
+        data = response.read(65536)
+        if not data:
+          break
+        size += len(data)
+      return time.time() - start, response, size
+    finally:
+      connection.close()
+
+  def jsonrpc(self):
+    body = json.dumps({ "jsonrpc": "2.0", "method": "JSONRPC.Ping", "id": 1 })
+    latency, response, size = self.request("POST", "/jsonrpc", body, { "Content-Type": "application/json" })
+    self.statistics.add("jsonrpc", latency, response.status, size)
+
+  def file(self):
+    latency, response, size = self.request("GET", "/vfs/" + quote(self.options.file, ""))
+    self.statistics.add("file", latency, response.status, size)
+
+  def range(self):
+    start = random.randint(0, max(0, self.options.filesize - 65536))
+    headers = { "Range": "bytes=%d-%d" % (start, start + 65535) }
+    latency, response, size = self.request("GET", "/vfs/" + quote(self.options.file, ""), headers=headers)
+    self.statistics.add("range", latency, response.status, size)
+
+  def image(self):
+    url = "/image/" + quote(self.options.image, "")
+    latency, response, size = self.request("GET", url)
+    self.statistics.add("image", latency, response.status, size)
+    etag = response.getheader("ETag")
+    if etag:
+      latency, response, size = self.request("GET", url, headers={ "If-None-Match": etag })
+      self.statistics.add("image", latency, response.status, size)
+
+  def run(self):
+    while time.time() < self.deadline:
+      try:
+        getattr(self, random.choice(self.mix))()
+      except Exception:
+        self.statistics.error()
+
+class HoldingClient(Client):
+  """Keeps a file transfer slot busy by reading a download very slowly"""
+  def run(self):
+    connection = httplib.HTTPConnection(self.options.host, self.options.port, timeout=self.options.timeout)
+    try:
+      start = time.time()
+      connection.request("GET", "/vfs/" + quote(self.options.file, ""), None, self.headers)
+      response = connection.getresponse()
+      self.statistics.add("held", time.time() - start, response.status, 0)
+      if response.status != 200:
+        return
+      while time.time() < self.deadline and response.read(1024):
+        time.sleep(1.0)
+    except Exception:
+      self.statistics.error()
+    finally:
+      connection.close()
+
+def main():
+  parser = optparse.OptionParser(usage="%prog [options]")
+  parser.add_option("--host", default="127.0.0.1", help="host of the webserver [%default]")
+  parser.add_option("--port", type="int", default=8080, help="port of the webserver [%default]")
+  parser.add_option("--username", default="xbmc", help="username [%default]")
+  parser.add_option("--password", default="", help="password (no authentication if empty)")
+  parser.add_option("--clients", type="int", default=16, help="number of concurrent clients [%default]")
+  parser.add_option("--duration", type="int", default=30, help="duration of the test in seconds [%default]")
+  parser.add_option("--timeout", type="int", default=60, help="timeout of a request in seconds [%default]")
+  parser.add_option("--mix", default="jsonrpc,file,range,image", help="comma separated list of request types [%default]")
+  parser.add_option("--file", help="path of a (big) file accessible through /vfs/")
+  parser.add_option("--image", help="path of an image accessible through /image/")
+  parser.add_option("--hold-files", type="int", default=0, help="number of slow downloads of --file kept open during the test [%default]")
+  parser.add_option("--max-latency", type="int", default=0, help="fail if a JSON-RPC call takes longer (in ms, 0 = no check) [%default]")
+  options, args = parser.parse_args()
+
+  mix = [kind.strip() for kind in options.mix.split(",") if kind.strip()]
+  if ("file" in mix or "range" in mix) and not options.file:
+    mix = [kind for kind in mix if kind not in ("file", "range")]
+  if "image" in mix and not options.image:
+    mix.remove("image")
+  if not mix:
+    parser.error("nothing to request")
+  if options.hold_files > 0 and not options.file:
+    parser.error("--hold-files needs --file")
+  if not options.password:
+    options.username = None
+
+  options.filesize = 0
+  if "range" in mix:
+    client = Client(options, mix, Statistics(), 0)
+    latency, response, size = client.request("HEAD", "/vfs/" + quote(options.file, ""))
+    options.filesize = int(response.getheader("Content-Length", "0"))
+
+  statistics = Statistics()
+  deadline = time.time() + options.duration
+  holders = [HoldingClient(options, mix, statistics, deadline) for index in range(options.hold_files)]
+  for holder in holders:
+    holder.start()
+  # give the held downloads time to take their slots
+  if holders:
+    time.sleep(1.0)
+
+  clients = [Client(options, mix, statistics, deadline) for index in range(options.clients)]
+  start = time.time()
+  for client in clients:
+    client.start()
+  for client in clients + holders:
+    client.join()
+
+  statistics.report(time.time() - start)
+
+  if options.max_latency > 0:
+    latencies = statistics.latencies.get("jsonrpc", [])
+    if not latencies:
+      print("FAILED: no JSON-RPC call was answered")
+      return 1
+    if 1000.0 * max(latencies) > options.max_latency:
+      print("FAILED: a JSON-RPC call took %.1f ms" % (1000.0 * max(latencies)))
+      return 1
+    if statistics.statuses.get("jsonrpc 200", 0) != len(latencies):
+      print("FAILED: not every JSON-RPC call was answered with 200")
+      return 1
+    print("PASSED: JSON-RPC answered within %d ms" % options.max_latency)
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -169,6 +169,7 @@
 #include "peripherals/dialogs/GUIDialogPeripheralSettings.h"
 #include "peripherals/devices/PeripheralImon.h"
 #include "music/infoscanner/MusicInfoScanner.h"
+#include "music/infoscanner/ReplayGainScanner.h"
 
 // Windows includes
 #include "guilib/GUIWindowManager.h"
@@ -3530,6 +3531,9 @@ void CApplication::Stop(int exitCode)
     if (m_musicInfoScanner->IsScanning())
       m_musicInfoScanner->Stop();
 
+    if (CReplayGainScanner::Get().IsScanning())
+      CReplayGainScanner::Get().Stop();
+
     if (m_videoInfoScanner->IsScanning())
       m_videoInfoScanner->Stop();
 
@@ -21,6 +21,7 @@
 #include "threads/SystemClock.h"
 #include "GUILargeTextureManager.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
 #include "guilib/Texture.h"
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
@@ -78,6 +79,7 @@ CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
   m_path = path;
   m_refCount = 1;
   m_timeToDelete = 0;
+  m_uploadScheduled = false;
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -123,8 +125,20 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
 }
 
+unsigned int CGUILargeTextureManager::CLargeTexture::GetSize() const
+{
+  unsigned int size = 0;
+  for (unsigned int i = 0; i < m_texture.m_textures.size(); i++)
+  {
+    CBaseTexture *texture = m_texture.m_textures[i];
+    size += texture->GetPitch() * texture->GetRows();
+  }
+  return size;
+}
+
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
+  m_uploadFrame = 0;
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
@@ -144,6 +158,12 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
     else
       ++it;
   }
+  // a flush starts the upload accounting afresh
+  if (immediately)
+  {
+    m_uploadCurrent = CUploadStats();
+    m_uploadLast = CUploadStats();
+  }
 }
 
 // if available, increment reference count, and return the image.
@@ -158,6 +178,8 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
     {
       if (firstRequest)
         image->AddRef();
+      if (!ScheduleUpload(image))
+        return true; // over budget for this frame - treat as still loading
       texture = image->GetTexture();
       return texture.size() > 0;
     }
@@ -196,6 +218,50 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
   }
 }
 
+// decide whether a loaded image may be handed out for upload during this frame
+bool CGUILargeTextureManager::ScheduleUpload(CLargeTexture *image)
+{
+  if (image->IsUploadScheduled())
+    return true;
+
+  UpdateUploadFrame();
+
+  // always allow at least one texture per frame so that a single large image can't starve
+  unsigned int size = image->GetSize();
+  unsigned int budget = g_advancedSettings.m_guiTextureUploadBudget * 1024;
+  if (budget && m_uploadCurrent.m_textures && m_uploadCurrent.m_bytes + size > budget)
+  {
+    m_uploadCurrent.m_deferred++;
+    return false;
+  }
+
+  m_uploadCurrent.m_textures++;
+  m_uploadCurrent.m_bytes += size;
+  image->SetUploadScheduled();
+  return true;
+}
+
+// start the accounting of a new frame, keeping the totals of the one just finished
+void CGUILargeTextureManager::UpdateUploadFrame()
+{
+  unsigned int frameTime = CTimeUtils::GetFrameTime();
+  if (frameTime != m_uploadFrame)
+  {
+    m_uploadLast = m_uploadCurrent;
+    m_uploadCurrent = CUploadStats();
+    m_uploadFrame = frameTime;
+  }
+}
+
+void CGUILargeTextureManager::GetUploadStats(unsigned int &textures, unsigned int &bytes, unsigned int &deferred)
+{
+  CSingleLock lock(m_listSection);
+  UpdateUploadFrame(); // so that frames without any requests report nothing
+  textures = m_uploadLast.m_textures;
+  bytes = m_uploadLast.m_bytes;
+  deferred = m_uploadLast.m_deferred;
+}
+
 // queue the image, and start the background loader if necessary
 void CGUILargeTextureManager::QueueImage(const CStdString &path)
 {
@@ -111,7 +111,32 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Fetch upload statistics for the last complete frame.
+
+   Loaded textures are handed out subject to a per-frame budget (see the <gui><textureuploadbudget>
+   advanced setting), so that a page full of fanart is uploaded to the GPU over several frames
+   rather than stalling a single one.
+
+   \param textures [out] the number of textures handed out for upload.
+   \param bytes [out] the size of the textures handed out for upload.
+   \param deferred [out] the number of requests for loaded textures deferred to a later frame.
+   */
+  void GetUploadStats(unsigned int &textures, unsigned int &bytes, unsigned int &deferred);
+
 private:
+  /*!
+   \brief Per-frame accounting of textures handed out for upload
+   */
+  class CUploadStats
+  {
+  public:
+    CUploadStats() : m_textures(0), m_bytes(0), m_deferred(0) {};
+    unsigned int m_textures;
+    unsigned int m_bytes;
+    unsigned int m_deferred;
+  };
+
   class CLargeTexture
   {
   public:
@@ -125,6 +150,10 @@ private:
 
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    unsigned int GetSize() const;
+
+    bool IsUploadScheduled() const { return m_uploadScheduled; };
+    void SetUploadScheduled() { m_uploadScheduled = true; };
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
@@ -133,9 +162,12 @@ private:
     CStdString m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    bool m_uploadScheduled;
   };
 
   void QueueImage(const CStdString &path);
+  bool ScheduleUpload(CLargeTexture *image);
+  void UpdateUploadFrame();
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
@@ -143,6 +175,10 @@ private:
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
 
   CCriticalSection m_listSection;
+
+  unsigned int m_uploadFrame;     ///< frame time the current upload accounting belongs to
+  CUploadStats m_uploadCurrent;   ///< textures handed out during the current frame
+  CUploadStats m_uploadLast;      ///< textures handed out during the last complete frame
 };
 
 extern CGUILargeTextureManager g_largeTextureManager;
@@ -22,7 +22,7 @@
 #include "DVDClock.h"
 #include "cores/VideoRenderers/RenderManager.h"
 #include "utils/log.h"
-#include "utils/fastmemcpy.h"
+#include "utils/YUVUtils.h"
 #include "DllSwScale.h"
 
 // allocate a new picture (PIX_FMT_YUV420P)
@@ -68,94 +68,29 @@ void CDVDCodecUtils::FreePicture(DVDVideoPicture* pPicture)
 
 bool CDVDCodecUtils::CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc)
 {
-  BYTE *s, *d;
   int w = pSrc->iWidth;
   int h = pSrc->iHeight;
 
-  s = pSrc->data[0];
-  d = pDst->data[0];
-
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[0];
-    d += pDst->iLineSize[0];
-  }
+  CYUVUtils::CopyPlane(pDst->data[0], pDst->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
 
   w >>= 1;
   h >>= 1;
 
-  s = pSrc->data[1];
-  d = pDst->data[1];
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[1];
-    d += pDst->iLineSize[1];
-  }
-
-  s = pSrc->data[2];
-  d = pDst->data[2];
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[2];
-    d += pDst->iLineSize[2];
-  }
+  CYUVUtils::CopyPlane(pDst->data[1], pDst->iLineSize[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CYUVUtils::CopyPlane(pDst->data[2], pDst->iLineSize[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
 bool CDVDCodecUtils::CopyPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  BYTE *s = pSrc->data[0];
-  BYTE *d = pImage->plane[0];
   int w = pImage->width * pImage->bpp;
   int h = pImage->height;
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  s = pSrc->data[1];
-  d = pImage->plane[1];
+  CYUVUtils::CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
+
   w =(pImage->width  >> pImage->cshift_x) * pImage->bpp;
   h =(pImage->height >> pImage->cshift_y);
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
-  s = pSrc->data[2];
-  d = pImage->plane[2];
-  if ((w==pSrc->iLineSize[2]) && ((unsigned int) pSrc->iLineSize[2]==pImage->stride[2]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[2];
-      d += pImage->stride[2];
-    }
-  }
+  CYUVUtils::CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CYUVUtils::CopyPlane(pImage->plane[2], pImage->stride[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
@@ -185,27 +120,14 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToNV12Picture(DVDVideoPicture *pSrc)
       pPicture->format = RENDER_FMT_NV12;
       
       // copy luma
-      uint8_t *s = pSrc->data[0];
-      uint8_t *d = pPicture->data[0];
-      for (int y = 0; y < (int)pSrc->iHeight; y++)
-      {
-        fast_memcpy(d, s, pSrc->iWidth);
-        s += pSrc->iLineSize[0];
-        d += pPicture->iLineSize[0];
-      }
+      CYUVUtils::CopyPlane(pPicture->data[0], pPicture->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0],
+                           pSrc->iWidth, pSrc->iHeight);
 
       //copy chroma
-      uint8_t *s_u, *s_v, *d_uv;
-      for (int y = 0; y < (int)pSrc->iHeight/2; y++) {
-        s_u = pSrc->data[1] + (y * pSrc->iLineSize[1]);
-        s_v = pSrc->data[2] + (y * pSrc->iLineSize[2]);
-        d_uv = pPicture->data[1] + (y * pPicture->iLineSize[1]);
-        for (int x = 0; x < (int)pSrc->iWidth/2; x++) {
-          *d_uv++ = *s_u++;
-          *d_uv++ = *s_v++;
-        }
-      }
-      
+      CYUVUtils::InterleaveUV(pPicture->data[1], pPicture->iLineSize[1],
+                              pSrc->data[1], pSrc->iLineSize[1],
+                              pSrc->data[2], pSrc->iLineSize[2],
+                              pSrc->iWidth / 2, pSrc->iHeight / 2);
     }
     else
     {
@@ -225,7 +147,9 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
   {
     *pPicture = *pSrc;
 
-    int totalsize = pPicture->iWidth * pPicture->iHeight * 2;
+    // a macropixel holds two pixels, so odd widths take one more pixel
+    int linesize = ((pPicture->iWidth + 1) & ~1) * 2;
+    int totalsize = linesize * pPicture->iHeight;
     BYTE* data = new BYTE[totalsize];
 
     if (data)
@@ -234,39 +158,17 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
       pPicture->data[1] = NULL;
       pPicture->data[2] = NULL;
       pPicture->data[3] = NULL;
-      pPicture->iLineSize[0] = pPicture->iWidth * 2;
+      pPicture->iLineSize[0] = linesize;
       pPicture->iLineSize[1] = 0;
       pPicture->iLineSize[2] = 0;
       pPicture->iLineSize[3] = 0;
       pPicture->format = format;
 
-      //if this is going to be used for anything else than testing the renderer
-      //the library should not be loaded on every function call
-      DllSwScale  dllSwScale;
-      if (!dllSwScale.Load())
-      {
-        CLog::Log(LOGERROR,"CDVDCodecUtils::ConvertToYUY2Picture - failed to load rescale libraries!");
-      }
-      else
-      {
-        // Perform the scaling.
-        uint8_t* src[] =       { pSrc->data[0],          pSrc->data[1],      pSrc->data[2],      NULL };
-        int      srcStride[] = { pSrc->iLineSize[0],     pSrc->iLineSize[1], pSrc->iLineSize[2], 0    };
-        uint8_t* dst[] =       { pPicture->data[0],      NULL,               NULL,               NULL };
-        int      dstStride[] = { pPicture->iLineSize[0], 0,                  0,                  0    };
-
-        int dstformat;
-        if (format == RENDER_FMT_UYVY422)
-          dstformat = PIX_FMT_UYVY422;
-        else
-          dstformat = PIX_FMT_YUYV422;
-
-        struct SwsContext *ctx = dllSwScale.sws_getContext(pSrc->iWidth, pSrc->iHeight, PIX_FMT_YUV420P,
-                                                           pPicture->iWidth, pPicture->iHeight, dstformat,
-                                                           SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-        dllSwScale.sws_scale(ctx, src, srcStride, 0, pSrc->iHeight, dst, dstStride);
-        dllSwScale.sws_freeContext(ctx);
-      }
+      CYUVUtils::PackYUV422(pPicture->data[0], pPicture->iLineSize[0],
+                            pSrc->data[0], pSrc->iLineSize[0],
+                            pSrc->data[1], pSrc->iLineSize[1],
+                            pSrc->data[2], pSrc->iLineSize[2],
+                            pSrc->iWidth, pSrc->iHeight, format == RENDER_FMT_UYVY422);
     }
     else
     {
@@ -280,69 +182,23 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
 
 bool CDVDCodecUtils::CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  BYTE *s = pSrc->data[0];
-  BYTE *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
   // Copy Y
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w = pSrc->iWidth;
-  h = pSrc->iHeight >> 1;
+  CYUVUtils::CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+                       pSrc->iWidth, pSrc->iHeight);
+
   // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
+  CYUVUtils::CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1],
+                       pSrc->iWidth, pSrc->iHeight >> 1);
 
   return true;
 }
 
 bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  BYTE *s = pSrc->data[0];
-  BYTE *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
-
   // Copy YUYV
-  if ((w * 2 == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h*2);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w*2);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
+  CYUVUtils::CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+                       pSrc->iWidth * 2, pSrc->iHeight);
+
   return true;
 }
 
@@ -134,6 +134,9 @@ CDVDVideoCodec* CDVDFactoryCodec::CreateVideoCodec(CDVDStreamInfo &hint, unsigne
   else
     options.m_formats = formats;
 
+  if(hint.realtime)
+    options.m_keys.push_back(CDVDCodecOption("threading", "lowlatency"));
+
   //when support for a hardware decoder is not compiled in
   //only print it if it's actually available on the platform
   CStdString hwSupport;
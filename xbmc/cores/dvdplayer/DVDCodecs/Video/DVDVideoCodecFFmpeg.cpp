@@ -142,6 +142,8 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
   m_started = false;
+  m_bDropRequested = false;
+  m_bReopen = false;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -245,10 +247,6 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
-  /* Only allow slice threading, since frame threading is more
-   * sensitive to changes in frame sizes, and it causes crashes
-   * during HW accell */
-  m_pCodecContext->thread_type = FF_THREAD_SLICE;
 
 #if defined(TARGET_DARWIN_IOS)
   // ffmpeg with enabled neon will crash and burn if this is enabled
@@ -283,19 +281,27 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   }
 
   // set any special options
+  CDVDVideoThreadingPolicy::EMode threading = CDVDVideoThreadingPolicy::MODE_AUTO;
   for(std::vector<CDVDCodecOption>::iterator it = options.m_keys.begin(); it != options.m_keys.end(); it++)
   {
-    if (it->m_name == "surfaces")
+    if (it->m_name == "threading")
+      threading = CDVDVideoThreadingPolicy::ModeFromString(it->m_value);
+    else if (it->m_name == "surfaces")
       m_uSurfacesCount = std::atoi(it->m_value.c_str());
+    else if (it->m_name == "lowres") // avcodec_open2 fails on more than the decoder supports
+      m_pCodecContext->lowres = std::min(std::atoi(it->m_value.c_str()), (int)pCodec->max_lowres);
     else
       m_dllAvUtil.av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
   }
 
-  int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-  if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
-  && ( pCodec->id == CODEC_ID_H264
-    || pCodec->id == CODEC_ID_MPEG4 ))
-    m_pCodecContext->thread_count = num_threads;
+  /* frame threading causes crashes during HW accell. It is only switched to
+   * once decoding turned out to run in software, see Decode() */
+  m_threading.Attach();
+  if(m_pHardware == NULL)
+    m_threading.Configure(threading, hints.width, hints.height
+                        , (pCodec->capabilities & CODEC_CAP_SLICE_THREADS) != 0
+                        , (pCodec->capabilities & CODEC_CAP_FRAME_THREADS) != 0);
+  ApplyThreading();
 
   if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
@@ -328,6 +334,7 @@ void CDVDVideoCodecFFmpeg::Dispose()
     m_pCodecContext = NULL;
   }
   SAFE_RELEASE(m_pHardware);
+  m_threading.Detach();
 
   FilterClose();
 
@@ -336,8 +343,46 @@ void CDVDVideoCodecFFmpeg::Dispose()
   m_dllAvFilter.Unload();
 }
 
+void CDVDVideoCodecFFmpeg::ApplyThreading()
+{
+  switch(m_threading.GetType())
+  {
+    case CDVDVideoThreadingPolicy::TYPE_FRAME:
+      m_pCodecContext->thread_type = FF_THREAD_FRAME;
+      break;
+    default:
+      m_pCodecContext->thread_type = FF_THREAD_SLICE;
+      break;
+  }
+  m_pCodecContext->thread_count = m_threading.GetCount();
+}
+
+bool CDVDVideoCodecFFmpeg::ReopenCodec()
+{
+  AVCodec* pCodec = m_pCodecContext->codec;
+
+  // the decoder was running in software all along, keep GetFormat from
+  // handing it to a hardware decoder that can't cope with frame threads
+  m_bSoftware = true;
+
+  m_dllAvCodec.avcodec_close(m_pCodecContext);
+  ApplyThreading();
+  if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
+  {
+    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::ReopenCodec() Unable to reopen codec");
+    return false;
+  }
+
+  // output resumes with the next keyframe
+  m_started = false;
+  UpdateName();
+  return true;
+}
+
 void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
 {
+  m_bDropRequested = bDrop;
+
   if( m_pCodecContext )
   {
     // i don't know exactly how high this should be set
@@ -425,12 +470,21 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
 {
   int iGotPicture = 0, len = 0;
 
-  if (!m_pCodecContext)
+  if (!m_pCodecContext || !m_pCodecContext->codec)
     return VC_ERROR;
 
   if(pData)
     m_iLastKeyframe++;
 
+  // switch threading as soon as the policy asks for it. The reference frames
+  // are lost, so output is held back until the next keyframe like after a seek.
+  if(m_bReopen && pData)
+  {
+    m_bReopen = false;
+    if(!ReopenCodec())
+      return VC_ERROR;
+  }
+
   shared_ptr<CSingleLock> lock;
   if(m_pHardware)
   {
@@ -487,6 +541,12 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
   }
 
+  // the player asks for drops when decoding falls behind, more threads may
+  // help. Only software decoding is accounted, GetFormat has had its chance
+  // to hand over to a hardware decoder by now.
+  if(m_pHardware == NULL && m_threading.Update(m_bDropRequested))
+    m_bReopen = true;
+
   /* put a limit on convergence count to avoid huge mem usage on streams without keyframes */
   if(m_iLastKeyframe > 300)
     m_iLastKeyframe = 300;
@@ -27,6 +27,7 @@
 #include "DllAvUtil.h"
 #include "DllSwScale.h"
 #include "DllAvFilter.h"
+#include "DVDVideoThreadingPolicy.h"
 
 class CVDPAU;
 class CCriticalSection;
@@ -77,6 +78,9 @@ protected:
   void FilterClose();
   int  FilterProcess(AVFrame* frame);
 
+  void ApplyThreading();
+  bool ReopenCodec();
+
   void UpdateName()
   {
     if(m_pCodecContext->codec->name)
@@ -86,6 +90,8 @@ protected:
 
     if(m_pHardware)
       m_name += "-" + m_pHardware->Name();
+    else if(m_threading.GetCount() > 1)
+      m_name += " (" + m_threading.GetDescription() + ")";
   }
 
   AVFrame* m_pFrame;
@@ -119,4 +125,7 @@ protected:
   double m_dts;
   bool   m_started;
   std::vector<PixelFormat> m_formats;
+  CDVDVideoThreadingPolicy m_threading;
+  bool   m_bDropRequested;
+  bool   m_bReopen;
 };
@@ -0,0 +1,161 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDVideoThreadingPolicy.h"
+#include "threads/Atomics.h"
+#include "utils/CPUInfo.h"
+#include "utils/StdString.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+// frames looked at before deciding whether the decoder keeps up
+#define THREADING_WINDOW 250
+
+long CDVDVideoThreadingPolicy::m_decoders = 0;
+
+CDVDVideoThreadingPolicy::CDVDVideoThreadingPolicy()
+{
+  m_mode         = MODE_AUTO;
+  m_type         = TYPE_NONE;
+  m_count        = 1;
+  m_pixels       = 0;
+  m_frameThreads = false;
+  m_escalated    = false;
+  m_attached     = false;
+  m_frames       = 0;
+  m_dropped      = 0;
+}
+
+CDVDVideoThreadingPolicy::EMode CDVDVideoThreadingPolicy::ModeFromString(const std::string &mode)
+{
+  if (mode == "lowlatency")
+    return MODE_LOWLATENCY;
+  if (mode == "single")
+    return MODE_SINGLE;
+  return MODE_AUTO;
+}
+
+const char* CDVDVideoThreadingPolicy::ModeToString(EMode mode)
+{
+  switch (mode)
+  {
+  case MODE_LOWLATENCY: return "lowlatency";
+  case MODE_SINGLE:     return "single";
+  default:              return "auto";
+  }
+}
+
+void CDVDVideoThreadingPolicy::Attach()
+{
+  if (!m_attached)
+    AtomicIncrement(&m_decoders);
+  m_attached = true;
+}
+
+void CDVDVideoThreadingPolicy::Detach()
+{
+  if (m_attached)
+    AtomicDecrement(&m_decoders);
+  m_attached = false;
+}
+
+int CDVDVideoThreadingPolicy::GetBudget() const
+{
+  // share the cores between all decoders that are open, thumbnails are
+  // extracted while something plays
+  int decoders = std::max(1L, m_decoders);
+  int budget   = std::max(1, g_cpuInfo.getCPUCount() / decoders);
+
+  // small pictures do not have enough work to keep many threads busy
+  int limit;
+  if (m_pixels <= 720 * 576)
+    limit = 2;
+  else if (m_pixels <= 1280 * 720)
+    limit = 4;
+  else
+    limit = 8;
+
+  return std::min(budget, limit);
+}
+
+void CDVDVideoThreadingPolicy::Configure(EMode mode, int width, int height, bool sliceThreads, bool frameThreads)
+{
+  m_mode         = mode;
+  m_pixels       = width * height;
+  m_frameThreads = frameThreads;
+  m_escalated    = false;
+  m_frames       = 0;
+  m_dropped      = 0;
+  m_count        = GetBudget();
+  m_type         = TYPE_NONE;
+
+  // frame threading delays output, it is only taken on once the decoder
+  // turns out to fall behind
+  if (m_count > 1 && m_mode != MODE_SINGLE && sliceThreads)
+    m_type = TYPE_SLICE;
+  if (m_type == TYPE_NONE)
+    m_count = 1;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoThreadingPolicy::Configure - mode:%s size:%dx%d decoders:%ld -> %s",
+            ModeToString(m_mode), width, height, m_decoders, GetDescription().c_str());
+}
+
+bool CDVDVideoThreadingPolicy::Update(bool dropped)
+{
+  if (m_mode != MODE_AUTO || m_escalated || !m_frameThreads)
+    return false;
+
+  m_frames++;
+  if (dropped)
+    m_dropped++;
+
+  if (m_frames < THREADING_WINDOW)
+    return false;
+
+  bool behind = m_dropped * 10 > m_frames;
+  m_frames  = 0;
+  m_dropped = 0;
+  if (!behind)
+    return false;
+
+  // only ever step up once, reopening the decoder costs a gop of frames
+  m_escalated = true;
+  int count = GetBudget();
+  if (count <= 1)
+    return false;
+
+  m_type  = TYPE_FRAME;
+  m_count = count;
+  CLog::Log(LOGNOTICE, "CDVDVideoThreadingPolicy::Update - decoder is falling behind, switching to %s", GetDescription().c_str());
+  return true;
+}
+
+std::string CDVDVideoThreadingPolicy::GetDescription() const
+{
+  CStdString description;
+  switch (m_type)
+  {
+  case TYPE_FRAME: description.Format("frame x%d", m_count); break;
+  case TYPE_SLICE: description.Format("slice x%d", m_count); break;
+  default:         description = "single";                   break;
+  }
+  return description;
+}
@@ -0,0 +1,95 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+/*!
+ \brief Decides how many threads a software video decoder runs, and whether
+  it threads over slices or over frames.
+
+ Slice threading adds no delay but only helps streams that are coded with
+ several slices. Frame threading scales with any stream but holds back one
+ frame per thread before output, which costs latency and makes the decoder
+ sensitive to mid stream changes.
+ */
+class CDVDVideoThreadingPolicy
+{
+public:
+  enum EMode
+  {
+    MODE_AUTO,        //!< start with low latency, move to frame threading when frames drop
+    MODE_LOWLATENCY,  //!< never add decoding delay, e.g. live tv
+    MODE_SINGLE       //!< no threads at all, e.g. thumbnails which only decode a few frames
+  };
+
+  enum EType
+  {
+    TYPE_NONE,
+    TYPE_SLICE,
+    TYPE_FRAME
+  };
+
+  CDVDVideoThreadingPolicy();
+
+  static EMode       ModeFromString(const std::string &mode);
+  static const char* ModeToString(EMode mode);
+
+  /*!
+   \brief Choose the initial threading, before the decoder is opened.
+   \param mode what the decoder is used for.
+   \param width, height size of the video.
+   \param sliceThreads, frameThreads which kinds of threading the codec supports.
+   */
+  void Configure(EMode mode, int width, int height, bool sliceThreads, bool frameThreads);
+
+  /*!
+   \brief Account one frame decoded in software, and whether the player had to drop it.
+   Frame threading is only ever chosen here, so callers must not account frames
+   of a hardware decoder, those do not cope with frame threading.
+   \return true if the decoder should be reopened with GetType()/GetCount().
+   */
+  bool Update(bool dropped);
+
+  EType       GetType() const  { return m_type; }
+  int         GetCount() const { return m_count; }
+  std::string GetDescription() const;
+
+  /*!
+   \brief Register an open decoder, the cores are shared between all of them.
+   */
+  void Attach();
+  void Detach();
+
+private:
+  int  GetBudget() const;
+
+  EMode        m_mode;
+  EType        m_type;
+  int          m_count;
+  int          m_pixels;
+  bool         m_frameThreads;
+  bool         m_escalated;
+  bool         m_attached;
+  unsigned int m_frames;
+  unsigned int m_dropped;
+
+  static long  m_decoders;
+};
@@ -0,0 +1,351 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "DVDDemuxDecodeBenchmark.h"
+#include "DVDClock.h"
+#include "DVDStreamInfo.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Audio/DVDAudioCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "filesystem/File.h"
+#include "threads/SystemClock.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <math.h>
+
+// microseconds between two host counter values
+static double ElapsedUs(int64_t start, int64_t end)
+{
+  return (double)(end - start) * 1000000.0 / (double)CurrentHostFrequency();
+}
+
+bool CDVDDemuxDecodeBenchmark::Run(const CStdString &path, bool realtime, CVariant &result)
+{
+  result = CVariant(CVariant::VariantTypeObject);
+  result["file"] = path;
+  result["mode"] = realtime ? "realtime" : "fast";
+
+  int64_t open = CurrentHostCounter();
+
+  CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, path, "");
+  if (!pInputStream)
+  {
+    CLog::Log(LOGERROR, "%s - Error creating stream for %s", __FUNCTION__, path.c_str());
+    return false;
+  }
+
+  if (pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD) || !pInputStream->Open(path.c_str(), ""))
+  {
+    CLog::Log(LOGERROR, "%s - Error opening %s", __FUNCTION__, path.c_str());
+    delete pInputStream;
+    return false;
+  }
+
+  CDVDDemux *pDemuxer = NULL;
+  try
+  {
+    pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream);
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Exception thrown when opening demuxer", __FUNCTION__);
+    pDemuxer = NULL;
+  }
+  if (!pDemuxer)
+  {
+    CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
+    delete pInputStream;
+    return false;
+  }
+  double openTime = ElapsedUs(open, CurrentHostCounter());
+  double firstFrameTime = -1.0;
+
+  int nVideoStream = -1;
+  int nAudioStream = -1;
+  for (int i = 0; i < pDemuxer->GetNrOfStreams(); i++)
+  {
+    CDemuxStream *pStream = pDemuxer->GetStream(i);
+    if (!pStream)
+      continue;
+    if (pStream->type == STREAM_VIDEO && nVideoStream < 0)
+      nVideoStream = i;
+    else if (pStream->type == STREAM_AUDIO && nAudioStream < 0)
+      nAudioStream = i;
+    else
+      pStream->SetDiscard(AVDISCARD_ALL);
+  }
+
+  CDVDVideoCodec *pVideoCodec = NULL;
+  CDVDAudioCodec *pAudioCodec = NULL;
+  if (nVideoStream >= 0)
+  {
+    CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
+    hint.software = true;
+    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint);
+  }
+  if (nAudioStream >= 0)
+  {
+    CDVDStreamInfo hint(*pDemuxer->GetStream(nAudioStream), true);
+    pAudioCodec = CDVDFactoryCodec::CreateAudioCodec(hint, false);
+  }
+
+  if (!pVideoCodec && !pAudioCodec)
+  {
+    CLog::Log(LOGERROR, "%s - No decodable streams in %s", __FUNCTION__, path.c_str());
+    delete pDemuxer;
+    delete pInputStream;
+    return false;
+  }
+
+  unsigned int demuxPackets = 0;
+  double demuxTime = 0.0;
+
+  unsigned int videoFrames = 0, videoDropped = 0, videoLate = 0, videoErrors = 0;
+  double videoTime = 0.0, videoMaxTime = 0.0;
+  double videoClock = DVD_NOPTS_VALUE;
+  bool requestDrop = false;
+
+  unsigned int audioPackets = 0, audioErrors = 0;
+  uint64_t audioBytes = 0;
+  double audioTime = 0.0, audioMaxTime = 0.0, audioDuration = 0.0;
+  double audioClock = DVD_NOPTS_VALUE;
+
+  double maxInterleave = 0.0;
+  double startPts = DVD_NOPTS_VALUE;
+
+  int64_t start = CurrentHostCounter();
+  while (true)
+  {
+    int64_t t0 = CurrentHostCounter();
+    DemuxPacket *pPacket = pDemuxer->Read();
+    int64_t t1 = CurrentHostCounter();
+    demuxTime += ElapsedUs(t0, t1);
+    if (!pPacket)
+      break;
+    demuxPackets++;
+
+    if (pVideoCodec && pPacket->iStreamId == nVideoStream)
+    {
+      pVideoCodec->SetDropState(requestDrop);
+      int iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      while (!(iDecoderState & VC_ERROR))
+      {
+        if (iDecoderState & VC_PICTURE)
+        {
+          DVDVideoPicture picture;
+          memset(&picture, 0, sizeof(picture));
+          if (pVideoCodec->GetPicture(&picture))
+          {
+            if (picture.pts != DVD_NOPTS_VALUE)
+              videoClock = picture.pts;
+            else if (videoClock != DVD_NOPTS_VALUE)
+              videoClock += picture.iDuration;
+
+            if (picture.iFlags & DVP_FLAG_DROPPED)
+              videoDropped++;
+            else
+              videoFrames++;
+
+            if (firstFrameTime < 0.0)
+              firstFrameTime = ElapsedUs(open, CurrentHostCounter());
+
+            if (videoClock != DVD_NOPTS_VALUE && audioClock != DVD_NOPTS_VALUE)
+              maxInterleave = std::max(maxInterleave, fabs(videoClock - audioClock - audioDuration));
+
+            if (realtime && videoClock != DVD_NOPTS_VALUE)
+            {
+              if (startPts == DVD_NOPTS_VALUE)
+              {
+                startPts = videoClock;
+                start = CurrentHostCounter();
+              }
+              double due = videoClock - startPts;
+              double now = ElapsedUs(start, CurrentHostCounter());
+              if (due > now)
+              {
+                Sleep((unsigned int)((due - now) / 1000));
+                requestDrop = false;
+              }
+              else
+              {
+                // same threshold the player uses before it starts dropping in the decoder
+                requestDrop = now - due > picture.iDuration;
+                if (requestDrop)
+                  videoLate++;
+              }
+            }
+          }
+          pVideoCodec->ClearPicture(&picture);
+        }
+        if (iDecoderState & VC_BUFFER)
+          break;
+        iDecoderState = pVideoCodec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+      }
+      if (iDecoderState & VC_ERROR)
+        videoErrors++;
+
+      double elapsed = ElapsedUs(t1, CurrentHostCounter());
+      videoTime += elapsed;
+      videoMaxTime = std::max(videoMaxTime, elapsed);
+    }
+    else if (pAudioCodec && pPacket->iStreamId == nAudioStream)
+    {
+      audioPackets++;
+      double pts = pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts;
+      if (pts != DVD_NOPTS_VALUE)
+      {
+        audioClock = pts;
+        audioDuration = 0.0;
+      }
+
+      BYTE *data = pPacket->pData;
+      int size = pPacket->iSize;
+      while (size > 0)
+      {
+        int len = pAudioCodec->Decode(data, size);
+        if (len < 0 || len > size)
+        {
+          audioErrors++;
+          pAudioCodec->Reset();
+          break;
+        }
+        data += len;
+        size -= len;
+
+        BYTE *decoded;
+        int decodedSize = pAudioCodec->GetData(&decoded);
+        if (decodedSize <= 0)
+          continue;
+        audioBytes += decodedSize;
+
+        int n = (pAudioCodec->GetChannels() * CAEUtil::DataFormatToBits(pAudioCodec->GetDataFormat()) * pAudioCodec->GetSampleRate()) >> 3;
+        if (n > 0)
+          audioDuration += ((double)decodedSize * DVD_TIME_BASE) / n;
+      }
+
+      double elapsed = ElapsedUs(t1, CurrentHostCounter());
+      audioTime += elapsed;
+      audioMaxTime = std::max(audioMaxTime, elapsed);
+    }
+
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+  }
+  double wallTime = ElapsedUs(start, CurrentHostCounter());
+
+  result["walltime_ms"] = wallTime / 1000.0;
+
+  CVariant startup(CVariant::VariantTypeObject);
+  CDVDDemuxFFmpeg *pDemuxerFFmpeg = dynamic_cast<CDVDDemuxFFmpeg*>(pDemuxer);
+  startup["streaminfo"] = pDemuxerFFmpeg && pDemuxerFFmpeg->IsStreamInfoCached() ? "short probe" : "full probe";
+  startup["open_ms"] = openTime / 1000.0;
+  if (firstFrameTime >= 0.0)
+    startup["first_frame_ms"] = firstFrameTime / 1000.0;
+  result["startup"] = startup;
+
+  CVariant demux(CVariant::VariantTypeObject);
+  demux["packets"] = demuxPackets;
+  demux["time_ms"] = demuxTime / 1000.0;
+  result["demux"] = demux;
+
+  if (pVideoCodec)
+  {
+    CVariant video(CVariant::VariantTypeObject);
+    video["codec"] = pVideoCodec->GetName();
+    video["frames"] = videoFrames;
+    video["dropped"] = videoDropped;
+    video["late"] = videoLate;
+    video["errors"] = videoErrors;
+    video["time_ms"] = videoTime / 1000.0;
+    video["max_packet_ms"] = videoMaxTime / 1000.0;
+    video["fps"] = videoTime > 0.0 ? (double)videoFrames * 1000000.0 / videoTime : 0.0;
+    result["video"] = video;
+  }
+
+  if (pAudioCodec)
+  {
+    CVariant audio(CVariant::VariantTypeObject);
+    audio["codec"] = pAudioCodec->GetName();
+    audio["packets"] = audioPackets;
+    audio["bytes"] = audioBytes;
+    audio["errors"] = audioErrors;
+    audio["time_ms"] = audioTime / 1000.0;
+    audio["max_packet_ms"] = audioMaxTime / 1000.0;
+    result["audio"] = audio;
+  }
+
+  if (videoClock != DVD_NOPTS_VALUE && audioClock != DVD_NOPTS_VALUE)
+  {
+    // how far apart the demuxer delivers the streams, not the player's sync
+    CVariant interleave(CVariant::VariantTypeObject);
+    interleave["final_ms"] = (videoClock - audioClock - audioDuration) / 1000.0;
+    interleave["max_ms"] = maxInterleave / 1000.0;
+    result["interleave"] = interleave;
+  }
+
+  if (pVideoCodec)
+  {
+    pVideoCodec->Dispose();
+    delete pVideoCodec;
+  }
+  if (pAudioCodec)
+  {
+    pAudioCodec->Dispose();
+    delete pAudioCodec;
+  }
+  delete pDemuxer;
+  delete pInputStream;
+
+  return true;
+}
+
+int CDVDDemuxDecodeBenchmark::RunToFile(const CStdString &path, bool realtime, const CStdString &output)
+{
+  CVariant result;
+  bool ok = Run(path, realtime, result);
+  std::string json = CJSONVariantWriter::Write(result, false);
+
+  CLog::Log(LOGNOTICE, "%s - %s", __FUNCTION__, CJSONVariantWriter::Write(result, true).c_str());
+
+  if (output.empty())
+    printf("%s\n", json.c_str());
+  else
+  {
+    XFILE::CFile file;
+    if (!file.OpenForWrite(output, true) || file.Write(json.c_str(), json.size()) != (int)json.size())
+    {
+      CLog::Log(LOGERROR, "%s - Unable to write results to %s", __FUNCTION__, output.c_str());
+      return 1;
+    }
+    file.Close();
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+
+class CVariant;
+
+/*!
+ \brief Runs a file through the dvdplayer demuxer and software decoders,
+  without a player, renderer or audio sink.
+
+ Every packet of the first video and audio stream is decoded on the calling
+ thread, either as fast as possible or paced against the wall clock as
+ playback would be. Timings are gathered per stage, so the demux and decode
+ throughput of a build can be compared on machines that have no display.
+
+ As no CDVDPlayer is involved, nothing is measured about its message queues
+ or its A/V sync. The reported interleave is the distance between the video
+ and the audio timestamps at the point the demuxer hands them out.
+ */
+class CDVDDemuxDecodeBenchmark
+{
+public:
+  /*!
+   \brief Decode the given file and collect the results.
+   \param path the file to decode.
+   \param realtime pace decoding against the stream timestamps and drop
+    frames that are late, otherwise decode as fast as possible.
+   \param result receives the timings, frame counters and interleave.
+   \return true if at least one stream could be decoded.
+   */
+  static bool Run(const CStdString &path, bool realtime, CVariant &result);
+
+  /*!
+   \brief Run the benchmark and write the result as JSON.
+   \param path the file to decode.
+   \param realtime see Run().
+   \param output file the JSON is written to, stdout if empty.
+   \return 0 on success, 1 otherwise. Suitable as a process exit code.
+   */
+  static int RunToFile(const CStdString &path, bool realtime, const CStdString &output);
+};
@@ -0,0 +1,277 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxReader.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+// time to wait before retrying a failed read
+#define READ_RETRY_DELAY 100
+
+CDVDDemuxReader::CDVDDemuxReader()
+  : CThread("CDVDDemuxReader")
+{
+  m_demuxer    = NULL;
+  m_input      = NULL;
+  m_maxBytes   = 0;
+  m_maxPackets = 0;
+  m_bytes      = 0;
+  m_eof        = false;
+  m_failed     = false;
+  m_idle       = false;
+  m_read       = 0;
+  m_taken      = 0;
+  m_consumed   = 0;
+  m_retired    = 0;
+  m_retiredAt  = 0;
+}
+
+CDVDDemuxReader::~CDVDDemuxReader()
+{
+  Stop();
+}
+
+void CDVDDemuxReader::Start(CDVDDemux* demuxer, CDVDInputStream* input, unsigned int maxbytes, unsigned int maxpackets)
+{
+  Stop();
+
+  m_demuxer    = demuxer;
+  m_input      = input;
+  m_maxBytes   = maxbytes;
+  m_maxPackets = maxpackets;
+  m_eof        = false;
+  m_failed     = false;
+  m_idle       = true;
+  m_read       = 0;
+  m_taken      = 0;
+  m_consumed   = 0;
+  m_retired    = demuxer->GetRetiredStreamCount();
+  m_retiredAt  = 0;
+  m_ready.Reset();
+  m_wake.Reset();
+
+  CLog::Log(LOGDEBUG, "%s - reading ahead up to %u bytes, %u packets", __FUNCTION__, maxbytes, maxpackets);
+  Create();
+}
+
+void CDVDDemuxReader::Stop()
+{
+  if (!m_demuxer)
+    return;
+
+  // keep aborting until the thread is out of the demuxer
+  StopThread(false);
+  while (!WaitForThreadExit(10))
+    m_demuxer->Abort();
+  m_demuxer->ResetAbort();
+
+  Clear();
+  m_demuxer = NULL;
+  m_input   = NULL;
+}
+
+void CDVDDemuxReader::Flush()
+{
+  if (!m_demuxer)
+    return;
+
+  {
+    CSingleLock lock(m_section);
+    m_idle = true;
+  }
+
+  // abort the read in progress, repeatedly since the thread may only
+  // be about to enter the demuxer when the first abort is issued
+  bool aborted = false;
+  CSingleTryLock demux(m_demuxSection);
+  while (!demux.IsOwner())
+  {
+    m_demuxer->Abort();
+    aborted = true;
+    Sleep(1);
+    demux.try_lock();
+  }
+  if (aborted)
+    m_demuxer->ResetAbort();
+
+  Clear();
+}
+
+void CDVDDemuxReader::Clear()
+{
+  CSingleLock lock(m_section);
+  for (std::deque<SPacket>::iterator it = m_queue.begin(); it != m_queue.end(); ++it)
+    CDVDDemuxUtils::FreeDemuxPacket(it->packet);
+  m_queue.clear();
+  m_bytes  = 0;
+  m_eof    = false;
+  m_failed = false;
+
+  // the dropped packets don't reference anything anymore
+  m_taken    = m_read;
+  m_consumed = m_read;
+  m_ready.Reset();
+}
+
+bool CDVDDemuxReader::Read(DemuxPacket*& packet, CDemuxStream*& stream, unsigned int timeout)
+{
+  packet = NULL;
+  stream = NULL;
+
+  CSingleLock lock(m_section);
+  if (m_idle)
+  {
+    m_idle = false;
+    m_wake.Set();
+  }
+
+  // the player is done with the packets it took before
+  m_consumed = m_taken;
+
+  if (m_queue.empty())
+  {
+    if (m_eof || m_failed)
+      return false;
+
+    lock.Leave();
+    m_ready.WaitMSec(timeout);
+    lock.Enter();
+
+    if (m_queue.empty())
+      return !m_eof && !m_failed;
+  }
+
+  packet = m_queue.front().packet;
+  stream = m_queue.front().stream;
+  m_queue.pop_front();
+  m_bytes -= packet->iSize;
+  m_taken++;
+  if (m_queue.empty() && !m_eof && !m_failed)
+    m_ready.Reset();
+
+  m_wake.Set();
+  return true;
+}
+
+bool CDVDDemuxReader::IsEOF() const
+{
+  CSingleLock lock(m_section);
+  return (m_eof || m_failed) && m_queue.empty();
+}
+
+void CDVDDemuxReader::Process()
+{
+  while (!m_bStop)
+  {
+    bool retry;
+    {
+      CSingleLock lock(m_section);
+      if (m_idle || m_eof || m_bytes >= m_maxBytes || m_queue.size() >= m_maxPackets)
+      {
+        lock.Leave();
+        AbortableWait(m_wake, 100);
+        continue;
+      }
+      retry = m_failed;
+    }
+
+    if (retry)
+      Sleep(READ_RETRY_DELAY);
+
+    DemuxPacket*  packet = NULL;
+    CDemuxStream* stream = NULL;
+    bool          eof    = false;
+    {
+      CSingleLock demux(m_demuxSection);
+      bool dispose;
+      {
+        CSingleLock lock(m_section);
+        if (m_idle)
+          continue;
+
+        // free the replaced streams once no packet references them anymore
+        dispose = m_retiredAt > 0 && m_consumed >= m_retiredAt;
+      }
+
+      if (dispose)
+      {
+        m_demuxer->DisposeRetiredStreams();
+        m_retired = 0;
+        m_retiredAt = 0;
+      }
+
+      packet = m_demuxer->Read();
+
+      // resolve the stream now, a later read may replace it
+      if (packet && packet->iStreamId >= 0)
+        stream = m_demuxer->GetStream(packet->iStreamId);
+
+      // streams replaced by this read may be referenced by any packet read
+      // so far, including this one
+      unsigned int retired = m_demuxer->GetRetiredStreamCount();
+      if (retired != m_retired)
+      {
+        CSingleLock lock(m_section);
+        m_retired = retired;
+        m_retiredAt = m_read + 1;
+      }
+
+      if (!packet)
+        eof = m_input && m_input->IsEOF();
+    }
+
+    CSingleLock lock(m_section);
+    if (m_idle || m_bStop)
+    {
+      // flushed while reading, the packet belongs to the old position
+      if (packet)
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+
+    if (packet)
+    {
+      SPacket entry;
+      entry.packet = packet;
+      entry.stream = stream;
+      m_queue.push_back(entry);
+      m_bytes += packet->iSize;
+      m_read++;
+      m_failed = false;
+    }
+    else if (eof)
+      m_eof = true;
+    else
+    {
+      // a read error or a stalled network source, the player treats it like
+      // the end of the stream once the queue runs dry but keeps trying to
+      // read as long as its players have data left, like it does without
+      // reading ahead
+      if (!m_failed)
+        CLog::Log(LOGDEBUG, "%s - read failed, retrying", __FUNCTION__);
+      m_failed = true;
+    }
+
+    m_ready.Set();
+  }
+}
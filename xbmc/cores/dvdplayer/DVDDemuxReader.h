@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Thread.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include <deque>
+
+class CDVDDemux;
+class CDVDInputStream;
+class CDemuxStream;
+struct DemuxPacket;
+
+/*!
+ \brief Reads packets from a demuxer on its own thread into a bounded queue.
+
+ The player thread takes packets from the queue, so a slow read from a network
+ source no longer holds up message handling, and packets read ahead keep the
+ decoders fed while the next read is in progress.
+
+ All demuxer calls that reposition or recreate the demuxer must be preceded by
+ Flush(), which interrupts the read in progress and drops everything queued.
+ Calls that only inspect or adjust the demuxer should hold the lock returned by
+ GetDemuxSection() instead, which waits for the current read to finish.
+
+ Streams the demuxer replaces while reading are freed by the reading thread
+ once the player is done with all packets read before the replacement.
+ */
+class CDVDDemuxReader : private CThread
+{
+public:
+  CDVDDemuxReader();
+  virtual ~CDVDDemuxReader();
+
+  /*!
+   \brief Start the reading thread for the given demuxer.
+   Reading begins with the first call to Read(), so the demuxer may still be
+   seeked to the start position until then.
+   \param demuxer the demuxer to read from, it must outlive Stop().
+   \param input the input stream of the demuxer, used to tell the end of the
+   stream from a failed read.
+   \param maxbytes the maximum payload size of the queued packets.
+   \param maxpackets the maximum number of queued packets.
+   */
+  void Start(CDVDDemux* demuxer, CDVDInputStream* input, unsigned int maxbytes, unsigned int maxpackets);
+
+  /*!
+   \brief Stop the reading thread and free all queued packets.
+   */
+  void Stop();
+
+  /*!
+   \brief Interrupt the current read and free all queued packets.
+   The reader is idle on return and resumes on the next call to Read().
+   */
+  void Flush();
+
+  /*!
+   \brief Take the next packet from the queue.
+   \param packet receives the packet, NULL if none is available.
+   \param stream receives the stream of the packet, as it was right after the packet was read.
+   \param timeout time to wait for a packet, in milliseconds.
+   \return false if the queue is empty and the demuxer reached the end of the
+   stream or the last read failed. Failed reads are retried, so packets might
+   still follow.
+   */
+  bool Read(DemuxPacket*& packet, CDemuxStream*& stream, unsigned int timeout);
+
+  bool IsActive() const { return m_demuxer != NULL; }
+  bool IsEOF() const;
+
+  CCriticalSection& GetDemuxSection() { return m_demuxSection; }
+
+protected:
+  virtual void Process();
+
+private:
+  struct SPacket
+  {
+    DemuxPacket*  packet;
+    CDemuxStream* stream;
+  };
+
+  void Clear();
+
+  CDVDDemux*             m_demuxer;
+  CDVDInputStream*       m_input;
+  unsigned int           m_maxBytes;
+  unsigned int           m_maxPackets;
+
+  mutable CCriticalSection m_section;      ///< protects the queue and state below
+  CCriticalSection       m_demuxSection;   ///< held while the thread is inside the demuxer
+  CEvent                 m_wake;           ///< room in the queue or a resume request
+  CEvent                 m_ready;          ///< a packet was queued or end of stream reached
+
+  std::deque<SPacket>    m_queue;
+  unsigned int           m_bytes;
+  bool                   m_eof;            ///< the input stream reached its end
+  bool                   m_failed;         ///< the last read failed, it is retried
+  bool                   m_idle;
+
+  unsigned int           m_read;           ///< packets queued since Start()
+  unsigned int           m_taken;          ///< packets taken by Read()
+  unsigned int           m_consumed;       ///< packets the player is done with
+  unsigned int           m_retired;        ///< streams retired by the demuxer
+  unsigned int           m_retiredAt;      ///< packets queued when a stream was last retired
+};
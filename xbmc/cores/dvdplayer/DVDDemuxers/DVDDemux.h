@@ -247,6 +247,23 @@ public:
    */
   virtual void Abort() = 0;
 
+  /*
+   * Undo a previous Abort() once nothing is reading anymore, so the
+   * demuxer can be seeked and read from again
+   */
+  virtual void ResetAbort() {}
+
+  /*
+   * Number of streams replaced since the last DisposeRetiredStreams(), they
+   * are kept alive as packets read before might still reference them
+   */
+  virtual unsigned int GetRetiredStreamCount() { return 0; }
+
+  /*
+   * Free the replaced streams, nothing may reference them anymore
+   */
+  virtual void DisposeRetiredStreams() {}
+
   /*
    * Flush the demuxer, if any data is kept in buffers, this should be freed now
    */
@@ -43,6 +43,8 @@
 #include "filesystem/File.h"
 #include "filesystem/Directory.h"
 #include "utils/log.h"
+#include "utils/Crc32.h"
+#include "utils/DiskLRUCache.h"
 #include "threads/Thread.h"
 #include "threads/SystemClock.h"
 #include "utils/TimeUtils.h"
@@ -214,6 +216,11 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_bAVI = false;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
+  m_seekIndexStream = -1;
+  m_seekIndexEntries = 0;
+  m_seekIndexLength = 0;
+  m_seekIndexTime = 0;
+  m_streamInfoCached = false;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -440,23 +447,32 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
     if(m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       m_pFormatContext->max_analyze_duration = 500000;
 
-
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
-    if (iErr < 0)
+    unsigned int probeStart = XbmcThreads::SystemClockMillis();
+    m_streamInfoCached = ShortProbeStreamInfo();
+    if (!m_streamInfoCached)
     {
-      CLog::Log(LOGWARNING,"could not find codec parameters for %s", strFile.c_str());
-      if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) || (m_pFormatContext->nb_streams == 1 && m_pFormatContext->streams[0]->codec->codec_id == CODEC_ID_AC3))
+      // continues a short probe that came up incomplete, what it read is
+      // still buffered in lavf
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      int iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr < 0)
       {
-        // special case, our codecs can still handle it.
+        CLog::Log(LOGWARNING,"could not find codec parameters for %s", strFile.c_str());
+        if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) || (m_pFormatContext->nb_streams == 1 && m_pFormatContext->streams[0]->codec->codec_id == CODEC_ID_AC3))
+        {
+          // special case, our codecs can still handle it.
+        }
+        else
+        {
+          Dispose();
+          return false;
+        }
       }
       else
-      {
-        Dispose();
-        return false;
-      }
+        SaveStreamInfo();
+      CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
     }
-    CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
+    CLog::Log(LOGDEBUG, "%s - stream info %s in %u ms", __FUNCTION__, m_streamInfoCached ? "short probe" : "full probe", XbmcThreads::SystemClockMillis() - probeStart);
   }
   // reset any timeout
   m_timeout.SetInfinite();
@@ -495,6 +511,8 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       AddStream(i);
   }
 
+  LoadSeekIndex();
+
   return true;
 }
 
@@ -509,8 +527,10 @@ void CDVDDemuxFFmpeg::Dispose()
       CLog::Log(LOGWARNING, "CDVDDemuxFFmpeg::Dispose - demuxer changed our byte context behind our back, possible memleak");
       m_ioContext = m_pFormatContext->pb;
     }
+    SaveSeekIndex();
     m_dllAvFormat.avformat_close_input(&m_pFormatContext);
   }
+  m_seekIndexStream = -1;
 
   if(m_ioContext)
   {
@@ -532,6 +552,7 @@ void CDVDDemuxFFmpeg::Dispose()
     }
     m_streams[i] = NULL;
   }
+  DisposeRetiredStreams();
   m_pInput = NULL;
 
   m_dllAvFormat.Unload();
@@ -562,6 +583,27 @@ void CDVDDemuxFFmpeg::Abort()
   m_timeout.SetExpired();
 }
 
+void CDVDDemuxFFmpeg::ResetAbort()
+{
+  m_timeout.SetInfinite();
+}
+
+unsigned int CDVDDemuxFFmpeg::GetRetiredStreamCount()
+{
+  return m_retired.size();
+}
+
+void CDVDDemuxFFmpeg::DisposeRetiredStreams()
+{
+  for (std::vector<CDemuxStream*>::iterator it = m_retired.begin(); it != m_retired.end(); ++it)
+  {
+    if ((*it)->ExtraData)
+      delete[] (BYTE*)((*it)->ExtraData);
+    delete *it;
+  }
+  m_retired.clear();
+}
+
 void CDVDDemuxFFmpeg::SetSpeed(int iSpeed)
 {
   g_demuxer.set(this);
@@ -677,6 +719,10 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
     {
       AVStream *stream = m_pFormatContext->streams[pkt.stream_index];
 
+      if (pkt.stream_index == m_seekIndexStream && (pkt.flags & AV_PKT_FLAG_KEY)
+      &&  pkt.pos >= 0 && pkt.dts != (int64_t)AV_NOPTS_VALUE)
+        m_dllAvFormat.av_add_index_entry(stream, pkt.pos, pkt.dts, 0, 0, AVINDEX_KEYFRAME);
+
       if (m_program != UINT_MAX)
       {
         /* check so packet belongs to selected program */
@@ -880,6 +926,274 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   return (ret >= 0);
 }
 
+#define SEEK_INDEX_MAGIC  "XSI2"
+#define SEEK_INDEX_FOLDER "special://temp/seekindex/"
+#define SEEK_INDEX_SIZE   (16 * 1024 * 1024)
+
+static CDiskLRUCache seekIndexCache(SEEK_INDEX_FOLDER, SEEK_INDEX_SIZE);
+
+// the modification time tells a rewritten file of the same length apart
+static int64_t GetModificationTime(const CStdString &strFile)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(strFile, &st) != 0)
+    return 0;
+  return st.st_mtime;
+}
+
+struct SeekIndexEntry
+{
+  int64_t pos;
+  int64_t timestamp;
+};
+
+void CDVDDemuxFFmpeg::LoadSeekIndex()
+{
+  m_seekIndexStream = -1;
+  m_seekIndexEntries = 0;
+
+  if (!m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) || !m_pFormatContext->pb || !m_pFormatContext->pb->seekable)
+    return;
+
+  // the index is kept in dts, which only matches what lavf bisects on for
+  // program streams. Transport streams are bisected on the pcr.
+  if (strcmp(m_pFormatContext->iformat->name, "mpeg") != 0)
+    return;
+
+  // seeking without a stream uses the first video stream, or the first stream if there is no video
+  if (m_pFormatContext->nb_streams == 0)
+    return;
+  m_seekIndexStream = 0;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    if (m_pFormatContext->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO)
+    {
+      m_seekIndexStream = i;
+      break;
+    }
+  }
+
+  Crc32 crc;
+  crc.ComputeFromLowerCase(m_pInput->GetFileName());
+  m_seekIndexFile.Format("%08x.idx", (uint32_t)crc);
+  m_seekIndexLength = m_pInput->GetLength();
+  m_seekIndexTime = GetModificationTime(m_pInput->GetFileName());
+
+  XFILE::CFile file;
+  if (!file.Open(seekIndexCache.GetEntryPath(m_seekIndexFile)))
+    return;
+
+  char magic[4];
+  int64_t length, time;
+  uint32_t count;
+  if (file.Read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, SEEK_INDEX_MAGIC, sizeof(magic)) != 0
+  ||  file.Read(&length, sizeof(length)) != sizeof(length) || length != m_seekIndexLength
+  ||  file.Read(&time, sizeof(time)) != sizeof(time) || time != m_seekIndexTime
+  ||  file.Read(&count, sizeof(count)) != sizeof(count) || count == 0)
+    return;
+
+  std::vector<SeekIndexEntry> entries(count);
+  if (file.Read(&entries[0], count * sizeof(SeekIndexEntry)) != count * sizeof(SeekIndexEntry))
+    return;
+
+  AVStream *stream = m_pFormatContext->streams[m_seekIndexStream];
+  for (std::vector<SeekIndexEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    m_dllAvFormat.av_add_index_entry(stream, it->pos, it->timestamp, 0, 0, AVINDEX_KEYFRAME);
+  m_seekIndexEntries = stream->nb_index_entries;
+  seekIndexCache.Touch(m_seekIndexFile);
+
+  CLog::Log(LOGDEBUG, "%s - loaded %d keyframes for %s", __FUNCTION__, m_seekIndexEntries, m_pInput->GetFileName().c_str());
+}
+
+void CDVDDemuxFFmpeg::SaveSeekIndex()
+{
+  if (m_seekIndexStream < 0)
+    return;
+
+  // only write the index if we found new keyframes
+  AVStream *stream = m_pFormatContext->streams[m_seekIndexStream];
+  if (stream->nb_index_entries <= m_seekIndexEntries)
+    return;
+
+  std::vector<SeekIndexEntry> entries;
+  entries.reserve(stream->nb_index_entries);
+  for (int i = 0; i < stream->nb_index_entries; i++)
+  {
+    if (stream->index_entries[i].flags & AVINDEX_KEYFRAME)
+    {
+      SeekIndexEntry entry = { stream->index_entries[i].pos, stream->index_entries[i].timestamp };
+      entries.push_back(entry);
+    }
+  }
+  if (entries.empty())
+    return;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(seekIndexCache.GetEntryPath(m_seekIndexFile), true))
+    return;
+
+  uint32_t count = entries.size();
+  file.Write(SEEK_INDEX_MAGIC, 4);
+  file.Write(&m_seekIndexLength, sizeof(m_seekIndexLength));
+  file.Write(&m_seekIndexTime, sizeof(m_seekIndexTime));
+  file.Write(&count, sizeof(count));
+  file.Write(&entries[0], count * sizeof(SeekIndexEntry));
+  int64_t size = file.GetPosition();
+  file.Close();
+  seekIndexCache.Add(m_seekIndexFile, size);
+
+  CLog::Log(LOGDEBUG, "%s - stored %u keyframes in %s", __FUNCTION__, count, m_seekIndexFile.c_str());
+}
+
+#define STREAM_INFO_MAGIC  "XSN3"
+#define STREAM_INFO_FOLDER "special://temp/streaminfo/"
+#define STREAM_INFO_SIZE   (1 * 1024 * 1024)
+
+static CDiskLRUCache streamInfoCache(STREAM_INFO_FOLDER, STREAM_INFO_SIZE);
+
+struct StreamInfoHeader
+{
+  char     magic[4];
+  char     format[16];
+  int64_t  length;
+  int64_t  time;
+  uint32_t streams;
+};
+
+// what the full probe found for a stream, a short probe is only good
+// enough if it finds the same. Must not have padding, entries are compared
+// with memcmp.
+struct StreamInfoEntry
+{
+  int32_t  codec_type;
+  int32_t  codec_id;
+  int32_t  width;
+  int32_t  height;
+  int32_t  sample_rate;
+  int32_t  channels;
+  AVRational r_frame_rate;
+  int32_t  extradata_size;
+};
+
+static CStdString GetStreamInfoName(CDVDInputStream* input)
+{
+  // the probe is expensive on network files, which are plain files or http
+  if (!input->IsStreamType(DVDSTREAM_TYPE_FILE) && !input->IsStreamType(DVDSTREAM_TYPE_HTTP))
+    return "";
+  if (input->GetLength() <= 0)
+    return "";
+
+  Crc32 crc;
+  crc.ComputeFromLowerCase(input->GetFileName());
+  CStdString file;
+  file.Format("%08x.inf", (uint32_t)crc);
+  return file;
+}
+
+static void GetStreamInfoEntry(const AVStream *stream, StreamInfoEntry &entry)
+{
+  const AVCodecContext *codec = stream->codec;
+  memset(&entry, 0, sizeof(entry));
+  entry.codec_type  = codec->codec_type;
+  entry.codec_id    = codec->codec_id;
+  entry.width       = codec->width;
+  entry.height      = codec->height;
+  entry.sample_rate = codec->sample_rate;
+  entry.channels    = codec->channels;
+  entry.r_frame_rate   = stream->r_frame_rate;
+  entry.extradata_size = codec->extradata ? codec->extradata_size : 0;
+}
+
+bool CDVDDemuxFFmpeg::ShortProbeStreamInfo()
+{
+  CStdString name = GetStreamInfoName(m_pInput);
+  if (name.IsEmpty())
+    return false;
+
+  XFILE::CFile file;
+  if (!file.Open(streamInfoCache.GetEntryPath(name)))
+    return false;
+
+  StreamInfoHeader header;
+  if (file.Read(&header, sizeof(header)) != sizeof(header)
+  ||  memcmp(header.magic, STREAM_INFO_MAGIC, sizeof(header.magic)) != 0
+  ||  header.length != m_pInput->GetLength()
+  ||  header.time != GetModificationTime(m_pInput->GetFileName())
+  ||  strncmp(header.format, m_pFormatContext->iformat->name, sizeof(header.format)) != 0
+  ||  header.streams == 0 || header.streams > MAX_STREAMS)
+    return false;
+
+  std::vector<StreamInfoEntry> entries(header.streams);
+  if (file.Read(&entries[0], header.streams * sizeof(StreamInfoEntry)) != header.streams * sizeof(StreamInfoEntry))
+    return false;
+  file.Close();
+
+  // the full probe runs to its limits whenever a stream never yields its
+  // parameters, knowing what it found lets a much shorter one stop early
+  unsigned int probesize = m_pFormatContext->probesize;
+  int          duration  = m_pFormatContext->max_analyze_duration;
+  m_pFormatContext->probesize            = std::min(probesize, 1024U * 1024U);
+  m_pFormatContext->max_analyze_duration = std::min(duration, 500000);
+  int result = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+  m_pFormatContext->probesize            = probesize;
+  m_pFormatContext->max_analyze_duration = duration;
+  if (result < 0)
+    return false;
+
+  if (m_pFormatContext->nb_streams != header.streams)
+  {
+    CLog::Log(LOGDEBUG, "%s - short probe found %u streams, %u stored", __FUNCTION__, m_pFormatContext->nb_streams, header.streams);
+    return false;
+  }
+
+  for (unsigned int i = 0; i < header.streams; i++)
+  {
+    // anything the full probe found has to be found exactly the same
+    StreamInfoEntry probed;
+    GetStreamInfoEntry(m_pFormatContext->streams[i], probed);
+    if (memcmp(&probed, &entries[i], sizeof(probed)) != 0)
+    {
+      CLog::Log(LOGDEBUG, "%s - short probe found different parameters for stream %u", __FUNCTION__, i);
+      return false;
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "%s - short probe found all %u streams of %s", __FUNCTION__, header.streams, m_pInput->GetFileName().c_str());
+  return true;
+}
+
+void CDVDDemuxFFmpeg::SaveStreamInfo()
+{
+  CStdString name = GetStreamInfoName(m_pInput);
+  if (name.IsEmpty() || m_pFormatContext->nb_streams == 0 || m_pFormatContext->nb_streams > MAX_STREAMS)
+    return;
+
+  StreamInfoHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, STREAM_INFO_MAGIC, sizeof(header.magic));
+  strncpy(header.format, m_pFormatContext->iformat->name, sizeof(header.format));
+  header.length  = m_pInput->GetLength();
+  header.time    = GetModificationTime(m_pInput->GetFileName());
+  header.streams = m_pFormatContext->nb_streams;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(streamInfoCache.GetEntryPath(name), true))
+    return;
+
+  file.Write(&header, sizeof(header));
+  for (unsigned int i = 0; i < header.streams; i++)
+  {
+    StreamInfoEntry entry;
+    GetStreamInfoEntry(m_pFormatContext->streams[i], entry);
+    file.Write(&entry, sizeof(entry));
+  }
+  int64_t size = file.GetPosition();
+  file.Close();
+  streamInfoCache.Add(name, size);
+
+  CLog::Log(LOGDEBUG, "%s - stored %u streams in %s", __FUNCTION__, header.streams, name.c_str());
+}
+
 void CDVDDemuxFFmpeg::UpdateCurrentPTS()
 {
   m_iCurrentPts = DVD_NOPTS_VALUE;
@@ -1106,14 +1420,12 @@ void CDVDDemuxFFmpeg::AddStream(int iId)
       }
     }
 
-    // delete old stream after new is created
-    // since dvdplayer uses the pointer to know
-    // if something changed in the demuxer
+    // keep old stream around until the packets read before
+    // are consumed, dvdplayer uses the pointer to know if
+    // something changed in the demuxer and its read ahead
+    // thread may still hold packets referencing the old one
     if (old)
-    {
-      if( old->ExtraData ) delete[] (BYTE*)(old->ExtraData);
-      delete old;
-    }
+      m_retired.push_back(old);
 
     // generic stuff
     if (pStream->duration != (int64_t)AV_NOPTS_VALUE) m_streams[iId]->iDuration = (int)((pStream->duration / AV_TIME_BASE) & 0xFFFFFFFF);
@@ -28,6 +28,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 
+#include <vector>
+
 class CDVDDemuxFFmpeg;
 
 class CDemuxStreamVideoFFmpeg
@@ -91,6 +93,9 @@ public:
   void Reset();
   void Flush();
   void Abort();
+  void ResetAbort();
+  unsigned int GetRetiredStreamCount();
+  void DisposeRetiredStreams();
   void SetSpeed(int iSpeed);
   virtual std::string GetFileName();
 
@@ -110,6 +115,10 @@ public:
 
   bool Aborted();
 
+  /*! \brief Whether a short probe was enough, thanks to the streams stored on a previous open
+   */
+  bool IsStreamInfoCached() const { return m_streamInfoCached; }
+
   AVFormatContext* m_pFormatContext;
 
 protected:
@@ -123,9 +132,26 @@ protected:
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
 
+  /*! \brief Load the stored keyframe index of the file, and start collecting keyframes
+   Only done for MPEG-PS, which seeks by bisecting the file on the dts, where a known
+   keyframe position close to the target saves reading large parts of the file. MPEG-TS
+   bisects on the pcr, which a dts index would only mislead.
+   */
+  void LoadSeekIndex();
+  void SaveSeekIndex();
+
+  /*! \brief Probe briefly if the streams a full probe found on a previous open are known
+   Nothing is taken from the stored info, it only tells whether the short probe found
+   every stream and the parameters the full probe had found for it.
+   \return true if the short probe was enough, false if the probe has to go on.
+   */
+  bool ShortProbeStreamInfo();
+  void SaveStreamInfo();
+
   CCriticalSection m_critSection;
   #define MAX_STREAMS 100
   CDemuxStream* m_streams[MAX_STREAMS]; // maximum number of streams that ffmpeg can handle
+  std::vector<CDemuxStream*> m_retired; // replaced streams, kept alive until no packet references them
 
   AVIOContext* m_ioContext;
 
@@ -140,6 +166,14 @@ protected:
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
 
+  int        m_seekIndexStream;  ///< stream the keyframe index is kept for, -1 if none
+  int        m_seekIndexEntries; ///< number of keyframes in the stored index
+  int64_t    m_seekIndexLength;  ///< length of the file the index belongs to
+  int64_t    m_seekIndexTime;    ///< modification time of the file the index belongs to
+  CStdString m_seekIndexFile;    ///< name of the index in the seek index cache
+
+  bool       m_streamInfoCached; ///< a short probe found everything the stored info listed
+
   CDVDInputStream* m_pInput;
 };
 
@@ -24,6 +24,9 @@
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
 #include "utils/log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include <vector>
 extern "C" {
 #if (defined USE_EXTERNAL_FFMPEG)
   #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
@@ -36,13 +39,154 @@ extern "C" {
 #endif
 }
 
+// Packet payloads are recycled through a pool of size classes, as demuxing
+// allocates and frees one for every packet. The size classes step by a quarter
+// of a power of two, so a payload is at most 25% larger than requested.
+// Every payload is preceded by a header recording its size class, so that it
+// can be returned to the right list when the packet is freed.
+#define PACKET_POOL_MIN_SIZE    512
+#define PACKET_POOL_CLASSES     49                  // up to 2MB
+#define PACKET_POOL_MAX_BYTES   (4 * 1024 * 1024)   // maximum memory held by free payloads
+#define PACKET_POOL_MAX_PACKETS 256                 // maximum free packet structures held
+#define PACKET_HEADER_SIZE      16                  // keeps the payload 16 byte aligned
+
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool()
+  {
+    m_allocated = 0;
+    m_reused = 0;
+    m_pooledBytes = 0;
+  }
+
+  ~CDemuxPacketPool()
+  {
+    for (unsigned int i = 0; i < PACKET_POOL_CLASSES; i++)
+    {
+      for (std::vector<unsigned char*>::iterator it = m_payloads[i].begin(); it != m_payloads[i].end(); ++it)
+        _aligned_free(*it);
+    }
+    for (std::vector<DemuxPacket*>::iterator it = m_packets.begin(); it != m_packets.end(); ++it)
+      delete *it;
+  }
+
+  DemuxPacket *GetPacket()
+  {
+    CSingleLock lock(m_section);
+    if (m_packets.empty())
+      return new DemuxPacket;
+    DemuxPacket *packet = m_packets.back();
+    m_packets.pop_back();
+    return packet;
+  }
+
+  void ReleasePacket(DemuxPacket *packet)
+  {
+    CSingleLock lock(m_section);
+    if (m_packets.size() < PACKET_POOL_MAX_PACKETS)
+      m_packets.push_back(packet);
+    else
+      delete packet;
+  }
+
+  unsigned char *GetPayload(int size)
+  {
+    int classSize;
+    int sizeClass = GetSizeClass(size, classSize);
+    if (sizeClass >= 0)
+    {
+      CSingleLock lock(m_section);
+      if (!m_payloads[sizeClass].empty())
+      {
+        unsigned char *block = m_payloads[sizeClass].back();
+        m_payloads[sizeClass].pop_back();
+        m_pooledBytes -= classSize;
+        m_reused++;
+        return block + PACKET_HEADER_SIZE;
+      }
+      m_allocated++;
+    }
+    else
+    {
+      CSingleLock lock(m_section);
+      m_allocated++;
+      classSize = size;
+    }
+
+    unsigned char *block = (unsigned char*)_aligned_malloc(PACKET_HEADER_SIZE + classSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+    if (!block)
+      return NULL;
+    *(int*)block = sizeClass;
+    return block + PACKET_HEADER_SIZE;
+  }
+
+  void ReleasePayload(unsigned char *payload)
+  {
+    unsigned char *block = payload - PACKET_HEADER_SIZE;
+    int sizeClass = *(int*)block;
+    if (sizeClass >= 0)
+    {
+      int classSize = GetClassSize(sizeClass);
+      CSingleLock lock(m_section);
+      if (m_pooledBytes + classSize <= PACKET_POOL_MAX_BYTES)
+      {
+        m_payloads[sizeClass].push_back(block);
+        m_pooledBytes += classSize;
+        return;
+      }
+    }
+    _aligned_free(block);
+  }
+
+  void GetStats(unsigned int &allocated, unsigned int &reused, unsigned int &pooledBytes)
+  {
+    CSingleLock lock(m_section);
+    allocated = m_allocated;
+    reused = m_reused;
+    pooledBytes = m_pooledBytes;
+  }
+
+private:
+  /*! \brief Find the smallest size class that holds size bytes
+   \return the index of the class, or -1 if size is too large to pool.
+   */
+  static int GetSizeClass(int size, int &classSize)
+  {
+    for (int i = 0; i < PACKET_POOL_CLASSES; i++)
+    {
+      classSize = GetClassSize(i);
+      if (size <= classSize)
+        return i;
+    }
+    return -1;
+  }
+
+  static int GetClassSize(int sizeClass)
+  {
+    if (sizeClass == 0)
+      return PACKET_POOL_MIN_SIZE;
+    int base = PACKET_POOL_MIN_SIZE << ((sizeClass - 1) / 4);
+    return base + base / 4 * ((sizeClass - 1) % 4 + 1);
+  }
+
+  CCriticalSection m_section;
+  std::vector<unsigned char*> m_payloads[PACKET_POOL_CLASSES];
+  std::vector<DemuxPacket*> m_packets;
+  unsigned int m_allocated;
+  unsigned int m_reused;
+  unsigned int m_pooledBytes;
+};
+
+static CDemuxPacketPool g_packetPool;
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      if (pPacket->pData) g_packetPool.ReleasePayload(pPacket->pData);
+      g_packetPool.ReleasePacket(pPacket);
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -52,7 +196,7 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
+  DemuxPacket* pPacket = g_packetPool.GetPacket();
   if (!pPacket) return NULL;
 
   try
@@ -70,7 +214,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      pPacket->pData = g_packetPool.GetPayload(iDataSize);
       if (!pPacket->pData)
       {
         FreeDemuxPacket(pPacket);
@@ -94,3 +238,8 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   }
   return pPacket;
 }
+
+void CDVDDemuxUtils::GetPoolStats(unsigned int &allocated, unsigned int &reused, unsigned int &pooledBytes)
+{
+  g_packetPool.GetStats(allocated, reused, pooledBytes);
+}
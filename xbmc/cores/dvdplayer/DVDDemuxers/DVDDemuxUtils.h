@@ -27,5 +27,12 @@ class CDVDDemuxUtils
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  /*! \brief Retrieve statistics of the packet pool
+   \param allocated number of packet payloads allocated from the heap.
+   \param reused number of packet payloads taken from the pool instead.
+   \param pooledBytes number of bytes currently held in the pool.
+   */
+  static void GetPoolStats(unsigned int &allocated, unsigned int &reused, unsigned int &pooledBytes);
 };
 
@@ -162,17 +162,28 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
+    // always use ffmpeg, as libmpeg2 is not thread safe, and ffmpeg lets us
+    // cut the decoding cost. Only keyframes are decoded, and at a reduced
+    // resolution when the video is at least twice the size of the thumb.
+    // Decoding is single threaded, frame threads would hold back the few
+    // frames we decode.
+    CDVDCodecOptions dvdOptions;
+    dvdOptions.m_formats.push_back(RENDER_FMT_YUV420P);
+    dvdOptions.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+    dvdOptions.m_keys.push_back(CDVDCodecOption("threading", "single"));
+
+    int lowres = 0;
+    while (lowres < 3 && (unsigned int)(hint.width >> (lowres + 1)) >= g_advancedSettings.GetThumbSize())
+      lowres++;
+    if (lowres > 0)
     {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
+      CStdString value;
+      value.Format("%d", lowres);
+      dvdOptions.m_keys.push_back(CDVDCodecOption("lowres", value));
     }
 
+    pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
+
     if (pVideoCodec)
     {
       int nTotalLen = pDemuxer->GetStreamLength();
@@ -24,6 +24,8 @@
 #include "threads/SingleLock.h"
 #include "DVDClock.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/StdString.h"
 
 using namespace std;
 
@@ -40,6 +42,7 @@ CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
   m_TimeFront     = DVD_NOPTS_VALUE;
   m_TimeSize      = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize  = 0;
+  memset(m_latency, 0, sizeof(m_latency));
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
@@ -56,6 +59,7 @@ void CDVDMessageQueue::Init()
   m_bInitialized  = true;
   m_TimeBack      = DVD_NOPTS_VALUE;
   m_TimeFront     = DVD_NOPTS_VALUE;
+  memset(m_latency, 0, sizeof(m_latency));
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
@@ -116,14 +120,22 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
+  DVDMessageListItem item(pMsg, priority);
+  item.time = CurrentHostCounter();
+
+  if(m_list.empty() || priority <= m_list.front().priority)
+    m_list.push_front(item);
+  else
   {
-    if(priority <= it->priority)
-      break;
-    it++;
+    SList::iterator it = m_list.begin();
+    while(it != m_list.end())
+    {
+      if(priority <= it->priority)
+        break;
+      it++;
+    }
+    m_list.insert(it, item);
   }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
   {
@@ -193,6 +205,13 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
       }
 
       *pMsg = item.message->Acquire();
+
+      int64_t waited = (CurrentHostCounter() - item.time) * 1000 / CurrentHostFrequency();
+      unsigned int bucket = 0;
+      for (int64_t bound = 1; bucket < MSGQ_LATENCY_BUCKETS - 1 && waited >= bound; bound *= 4)
+        bucket++;
+      m_latency[bucket]++;
+
       m_list.pop_back();
 
       ret = MSGQ_OK;
@@ -269,6 +288,40 @@ int CDVDMessageQueue::GetTimeSize() const
     return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
 }
 
+void CDVDMessageQueue::GetLatencyHistogram(unsigned int (&counts)[MSGQ_LATENCY_BUCKETS]) const
+{
+  CSingleLock lock(m_section);
+  memcpy(counts, m_latency, sizeof(m_latency));
+}
+
+std::string CDVDMessageQueue::GetLatencyInfo() const
+{
+  unsigned int counts[MSGQ_LATENCY_BUCKETS];
+  GetLatencyHistogram(counts);
+
+  unsigned int total = 0;
+  for (unsigned int i = 0; i < MSGQ_LATENCY_BUCKETS; i++)
+    total += counts[i];
+  if (total == 0)
+    return "-";
+
+  // find the buckets holding the median and 95th percentile
+  unsigned int median = 0, high = 0, count = 0;
+  for (unsigned int i = 0; i < MSGQ_LATENCY_BUCKETS; i++)
+  {
+    if (count * 2 < total)
+      median = i;
+    if (count * 20 < total * 19)
+      high = i;
+    count += counts[i];
+  }
+
+  static const char *bounds[MSGQ_LATENCY_BUCKETS] = { "<1", "<4", "<16", "<64", "<256", ">256" };
+  CStdString info;
+  info.Format("%s/%sms", bounds[median], bounds[high]);
+  return info;
+}
+
 bool CDVDMessageQueue::IsDataBased() const
 {
   return (m_TimeBack == DVD_NOPTS_VALUE  ||
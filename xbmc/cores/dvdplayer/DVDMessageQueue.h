@@ -22,7 +22,8 @@
 
 #include "DVDMessage.h"
 #include <string>
-#include <list>
+#include <deque>
+#include <stdint.h>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -32,11 +33,13 @@ struct DVDMessageListItem
   {
     message  = msg->Acquire();
     priority = prio;
+    time     = 0;
   }
   DVDMessageListItem()
   {
     message  = NULL;
     priority = 0;
+    time     = 0;
   }
   DVDMessageListItem(const DVDMessageListItem& item)
   {
@@ -45,6 +48,7 @@ struct DVDMessageListItem
     else
       message = NULL;
     priority = item.priority;
+    time     = item.time;
   }
  ~DVDMessageListItem()
   {
@@ -61,11 +65,13 @@ struct DVDMessageListItem
     else
       message = NULL;
     priority = item.priority;
+    time     = item.time;
     return *this;
   }
 
   CDVDMsg* message;
   int      priority;
+  int64_t  time;     ///< host counter when the message was queued
 };
 
 enum MsgQueueReturnCode
@@ -80,6 +86,8 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+#define MSGQ_LATENCY_BUCKETS 6 // < 1, 4, 16, 64, 256 ms and the rest
+
 class CDVDMessageQueue
 {
 public:
@@ -122,6 +130,15 @@ public:
   bool IsInited() const                 { return m_bInitialized; }
   bool IsDataBased() const;
 
+  /*! \brief Get a histogram of the time messages spent in the queue since Init()
+   \param counts number of messages taken from the queue within 1, 4, 16, 64 and 256 ms, and after that.
+   */
+  void GetLatencyHistogram(unsigned int (&counts)[MSGQ_LATENCY_BUCKETS]) const;
+
+  /*! \brief Summarise the queue latency for the player debug info, as the bounds of the median and 95th percentile
+   */
+  std::string GetLatencyInfo() const;
+
 private:
 
   CEvent m_hEvent;
@@ -140,7 +157,11 @@ private:
   bool m_bEmptied;
   std::string m_owner;
 
-  typedef std::list<DVDMessageListItem> SList;
+  // kept in order of priority with the next message at the back, in a
+  // deque so queueing a message doesn't need an allocation
+  typedef std::deque<DVDMessageListItem> SList;
   SList m_list;
+
+  unsigned int m_latency[MSGQ_LATENCY_BUCKETS];
 };
 
@@ -414,6 +414,7 @@ CDVDPlayer::CDVDPlayer(IPlayerCallback& callback)
   m_State.Clear();
   m_EdlAutoSkipMarkers.Clear();
   m_UpdateApplication = 0;
+  m_openTime = 0;
 
   m_bAbortRequest = false;
   m_errorCount = 0;
@@ -454,6 +455,7 @@ bool CDVDPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
     m_State.Clear();
     m_UpdateApplication = 0;
     m_offset_pts = 0;
+    m_openTime = XbmcThreads::SystemClockMillis();
 
     m_PlayerOptions = options;
     m_item     = file;
@@ -634,6 +636,7 @@ bool CDVDPlayer::OpenInputStream()
 
 bool CDVDPlayer::OpenDemuxStream()
 {
+  m_demuxReader.Stop();
   if(m_pDemuxer)
     SAFE_DELETE(m_pDemuxer);
 
@@ -679,6 +682,14 @@ bool CDVDPlayer::OpenDemuxStream()
   if(len > 0 && tim > 0)
     m_pInputStream->SetReadRate(len * 1000 / tim);
 
+  // navigators and channels hand out events between packets,
+  // only plain files and network streams are read ahead
+  if(g_advancedSettings.m_videoDemuxReadAhead > 0
+  && (m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE)
+   || m_pInputStream->IsStreamType(DVDSTREAM_TYPE_HTTP)
+   || m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FFMPEG)))
+    m_demuxReader.Start(m_pDemuxer, m_pInputStream, g_advancedSettings.m_videoDemuxReadAhead * 1024, 4096);
+
   return true;
 }
 
@@ -778,14 +789,22 @@ bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
   }
 
   // read a data frame from stream.
-  if(m_pDemuxer)
+  CDemuxStream* readstream = NULL;
+  if(m_demuxReader.IsActive())
+    m_demuxReader.Read(packet, readstream, 20);
+  else if(m_pDemuxer)
+  {
+    // the previous packet has been processed
+    m_pDemuxer->DisposeRetiredStreams();
     packet = m_pDemuxer->Read();
+  }
 
   if(packet)
   {
     // stream changed, update and open defaults
     if(packet->iStreamId == DMX_SPECIALID_STREAMCHANGE)
     {
+        CSingleLock lock(m_demuxReader.GetDemuxSection());
         m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
         m_SelectionStreams.Update(m_pInputStream, m_pDemuxer);
         OpenDefaultStreams(false);
@@ -804,7 +823,10 @@ bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 
     if(m_pDemuxer)
     {
-      stream = m_pDemuxer->GetStream(packet->iStreamId);
+      if(m_demuxReader.IsActive())
+        stream = readstream;
+      else
+        stream = m_pDemuxer->GetStream(packet->iStreamId);
       if (!stream)
       {
         CLog::Log(LOGERROR, "%s - Error demux packet doesn't belong to a valid stream", __FUNCTION__);
@@ -812,6 +834,7 @@ bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
       }
       if(stream->source == STREAM_SOURCE_NONE)
       {
+        CSingleLock lock(m_demuxReader.GetDemuxSection());
         m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
         m_SelectionStreams.Update(m_pInputStream, m_pDemuxer);
       }
@@ -840,6 +863,7 @@ bool CDVDPlayer::IsValidStream(CCurrentStream& stream)
   }
   if(source == STREAM_SOURCE_DEMUX)
   {
+    CSingleLock lock(m_demuxReader.GetDemuxSection());
     CDemuxStream* st = m_pDemuxer->GetStream(stream.id);
     if(st == NULL || st->disabled)
       return false;
@@ -994,6 +1018,7 @@ void CDVDPlayer::Process()
     double startpts = DVD_NOPTS_VALUE;
     if(m_pDemuxer)
     {
+      m_demuxReader.Flush();
       if (m_pDemuxer->SeekTime(starttime, false, &startpts))
         CLog::Log(LOGDEBUG, "%s - starting demuxer from: %d", __FUNCTION__, starttime);
       else
@@ -1096,6 +1121,12 @@ void CDVDPlayer::Process()
     DemuxPacket* pPacket = NULL;
     CDemuxStream *pStream = NULL;
     ReadPacket(pPacket, pStream);
+    if (!pPacket && m_demuxReader.IsActive() && !m_demuxReader.IsEOF())
+    {
+      // nothing read ahead yet, go back to handling messages
+      continue;
+    }
+
     if (pPacket && !pStream)
     {
       /* probably a empty packet, just free it and move on */
@@ -1135,6 +1166,7 @@ void CDVDPlayer::Process()
       CDVDInputStream::ENextStream next = m_pInputStream->NextStream();
       if(next == CDVDInputStream::NEXTSTREAM_OPEN)
       {
+        m_demuxReader.Stop();
         SAFE_DELETE(m_pDemuxer);
         m_CurrentAudio.stream = NULL;
         m_CurrentVideo.stream = NULL;
@@ -1416,7 +1448,13 @@ bool CDVDPlayer::GetCachingTimes(double& level, double& delay, double& offset)
   if(cached < 0 || length <= 0 || remain < 0)
     return false;
 
-  double play_sbp  = DVD_MSEC_TO_TIME(m_pDemuxer->GetStreamLength()) / length;
+  int64_t streamLength;
+  {
+    CSingleLock lock(m_demuxReader.GetDemuxSection());
+    streamLength = m_pDemuxer->GetStreamLength();
+  }
+
+  double play_sbp  = DVD_MSEC_TO_TIME(streamLength) / length;
   double queued = 1000.0 * GetQueueTime() / play_sbp;
 
   delay  = 0.0;
@@ -1489,8 +1527,10 @@ void CDVDPlayer::HandlePlaySpeed()
 
   if (caching == CACHESTATE_PVR)
   {
+    CSingleLock lock(m_demuxReader.GetDemuxSection());
     bool bGotAudio(m_pDemuxer->GetNrOfAudioStreams() > 0);
     bool bGotVideo(m_pDemuxer->GetNrOfVideoStreams() > 0);
+    lock.Leave();
     bool bAudioLevelOk(m_dvdPlayerAudio.GetLevel() > g_advancedSettings.m_iPVRMinAudioCacheLevel);
     bool bVideoLevelOk(m_dvdPlayerVideo.GetLevel() > g_advancedSettings.m_iPVRMinVideoCacheLevel);
     bool bAudioFull(!m_dvdPlayerAudio.AcceptsData());
@@ -1936,6 +1976,7 @@ void CDVDPlayer::OnExit()
       CloseTeletextStream(!m_bAbortRequest);
     }
     // destroy the demuxer
+    m_demuxReader.Stop();
     if (m_pDemuxer)
     {
       CLog::Log(LOGNOTICE, "CDVDPlayer::OnExit() deleting demuxer");
@@ -1943,6 +1984,10 @@ void CDVDPlayer::OnExit()
     }
     m_pDemuxer = NULL;
 
+    unsigned int allocated, reused, pooled;
+    CDVDDemuxUtils::GetPoolStats(allocated, reused, pooled);
+    CLog::Log(LOGDEBUG, "CDVDPlayer::OnExit() packet pool: %u allocated, %u reused, %u KB held", allocated, reused, pooled / 1024);
+
     if (m_pSubtitleDemuxer)
     {
       CLog::Log(LOGNOTICE, "CDVDPlayer::OnExit() deleting subtitle demuxer");
@@ -2022,6 +2067,7 @@ void CDVDPlayer::HandleMessages()
           time -= DVD_TIME_TO_MSEC(m_State.time_offset);
 
         CLog::Log(LOGDEBUG, "demuxer seek to: %d", time);
+        m_demuxReader.Flush();
         if (m_pDemuxer && m_pDemuxer->SeekTime(time, msg.GetBackward(), &start))
         {
           CLog::Log(LOGDEBUG, "demuxer seek to: %d, success", time);
@@ -2053,6 +2099,7 @@ void CDVDPlayer::HandleMessages()
         double start = DVD_NOPTS_VALUE;
 
         // This should always be the case.
+        m_demuxReader.Flush();
         if(m_pDemuxer && m_pDemuxer->SeekChapter(msg.GetChapter(), &start))
         {
           FlushBuffers(false, start, true);
@@ -2068,6 +2115,7 @@ void CDVDPlayer::HandleMessages()
           m_CurrentSubtitle.stream = NULL;
 
           // we need to reset the demuxer, probably because the streams have changed
+          m_demuxReader.Flush();
           if(m_pDemuxer)
             m_pDemuxer->Reset();
           if(m_pSubtitleDemuxer)
@@ -2198,7 +2246,10 @@ void CDVDPlayer::HandleMessages()
         // TODO - we really shouldn't pause demuxer
         //        until our buffers are somewhat filled
         if(m_pDemuxer)
+        {
+          CSingleLock lock(m_demuxReader.GetDemuxSection());
           m_pDemuxer->SetSpeed(speed);
+        }
       }
       else if (pMsg->IsType(CDVDMsg::PLAYER_CHANNEL_SELECT_NUMBER) && m_messenger.GetPacketCount(CDVDMsg::PLAYER_CHANNEL_SELECT_NUMBER) == 0)
       {
@@ -2206,6 +2257,7 @@ void CDVDPlayer::HandleMessages()
         CDVDInputStream::IChannel* input = dynamic_cast<CDVDInputStream::IChannel*>(m_pInputStream);
         if(input && input->SelectChannelByNumber(static_cast<CDVDMsgInt*>(pMsg)->m_value))
         {
+          m_demuxReader.Stop();
           SAFE_DELETE(m_pDemuxer);
         }else
         {
@@ -2219,6 +2271,7 @@ void CDVDPlayer::HandleMessages()
         CDVDInputStream::IChannel* input = dynamic_cast<CDVDInputStream::IChannel*>(m_pInputStream);
         if(input && input->SelectChannel(static_cast<CDVDMsgType <CPVRChannel> *>(pMsg)->m_value))
         {
+          m_demuxReader.Stop();
           SAFE_DELETE(m_pDemuxer);
         }else
         {
@@ -2255,6 +2308,7 @@ void CDVDPlayer::HandleMessages()
             else
             {
               m_iChannelEntryTimeOut = 0;
+              m_demuxReader.Stop();
               SAFE_DELETE(m_pDemuxer);
 
               g_infoManager.SetDisplayAfterSeek();
@@ -2277,6 +2331,14 @@ void CDVDPlayer::HandleMessages()
         if(player == DVDPLAYER_VIDEO)
           m_CurrentVideo.started = true;
         CLog::Log(LOGDEBUG, "CDVDPlayer::HandleMessages - player started %d", player);
+
+        if(player == DVDPLAYER_VIDEO && m_openTime)
+        {
+          CDVDDemuxFFmpeg* demuxer = dynamic_cast<CDVDDemuxFFmpeg*>(m_pDemuxer);
+          CLog::Log(LOGDEBUG, "CDVDPlayer::HandleMessages - first frame after %u ms, stream info %s", XbmcThreads::SystemClockMillis() - m_openTime
+                            , demuxer && demuxer->IsStreamInfoCached() ? "short probe" : "full probe");
+          m_openTime = 0;
+        }
       }
     }
     catch (...)
@@ -2788,6 +2850,9 @@ bool CDVDPlayer::OpenAudioStream(int iStream, int source, bool reset)
   if (!m_pDemuxer)
     return false;
 
+  // held until the stream has been opened, the reading thread could
+  // replace it otherwise
+  CSingleLock lock(m_demuxReader.GetDemuxSection());
   CDemuxStream* pStream = m_pDemuxer->GetStream(iStream);
   if (!pStream || pStream->disabled)
     return false;
@@ -2846,6 +2911,9 @@ bool CDVDPlayer::OpenVideoStream(int iStream, int source, bool reset)
   if (!m_pDemuxer)
     return false;
 
+  // held until the stream has been opened, the reading thread could
+  // replace it otherwise
+  CSingleLock lock(m_demuxReader.GetDemuxSection());
   CDemuxStream* pStream = m_pDemuxer->GetStream(iStream);
   if(!pStream || pStream->disabled)
     return false;
@@ -2882,6 +2950,10 @@ bool CDVDPlayer::OpenVideoStream(int iStream, int source, bool reset)
   if(pMenus && pMenus->IsInMenu())
     hint.stills = true;
 
+  if(m_pInputStream && (m_pInputStream->IsStreamType(DVDSTREAM_TYPE_TV)
+                     || m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER)))
+    hint.realtime = true;
+
   if(m_CurrentVideo.id    < 0
   || m_CurrentVideo.hint != hint)
   {
@@ -2929,6 +3001,10 @@ bool CDVDPlayer::OpenSubtitleStream(int iStream, int source)
 {
   CLog::Log(LOGNOTICE, "Opening Subtitle stream: %i source: %i", iStream, source);
 
+  // held until the stream has been opened, the reading thread could
+  // replace it otherwise
+  CSingleLock lock(m_demuxReader.GetDemuxSection());
+
   CDemuxStream* pStream = NULL;
   std::string filename;
   CDVDStreamInfo hint;
@@ -3026,6 +3102,9 @@ bool CDVDPlayer::OpenTeletextStream(int iStream, int source)
   if (!m_pDemuxer)
     return false;
 
+  // held until the stream has been opened, the reading thread could
+  // replace it otherwise
+  CSingleLock lock(m_demuxReader.GetDemuxSection());
   CDemuxStream* pStream = m_pDemuxer->GetStream(iStream);
   if(!pStream || pStream->disabled)
     return false;
@@ -3813,7 +3892,10 @@ void CDVDPlayer::UpdatePlayState(double timeout)
   else
     state.dts = m_clock.GetClock();
 
-  if(m_pDemuxer)
+  // the values of the last update are kept while the reading thread is
+  // inside the demuxer, this is called too often to wait for it
+  CSingleTryLock demuxLock(m_demuxReader.GetDemuxSection());
+  if(m_pDemuxer && demuxLock.IsOwner())
   {
     state.chapter       = m_pDemuxer->GetChapter();
     state.chapter_count = m_pDemuxer->GetChapterCount();
@@ -3885,7 +3967,7 @@ void CDVDPlayer::UpdatePlayState(double timeout)
 
   if (m_CurrentAudio.id >= 0 && m_pDemuxer)
   {
-    CDemuxStream* pStream = m_pDemuxer->GetStream(m_CurrentAudio.id);
+    CDemuxStream* pStream = demuxLock.IsOwner() ? m_pDemuxer->GetStream(m_CurrentAudio.id) : NULL;
     if (pStream && pStream->type == STREAM_AUDIO)
       ((CDemuxStreamAudio*)pStream)->GetStreamInfo(state.demux_audio);
   }
@@ -3894,12 +3976,13 @@ void CDVDPlayer::UpdatePlayState(double timeout)
 
   if (m_CurrentVideo.id >= 0 && m_pDemuxer)
   {
-    CDemuxStream* pStream = m_pDemuxer->GetStream(m_CurrentVideo.id);
+    CDemuxStream* pStream = demuxLock.IsOwner() ? m_pDemuxer->GetStream(m_CurrentVideo.id) : NULL;
     if (pStream && pStream->type == STREAM_VIDEO)
       ((CDemuxStreamVideo*)pStream)->GetStreamInfo(state.demux_video);
   }
   else
     state.demux_video = "";
+  demuxLock.Leave();
 
   double level, delay, offset;
   if(GetCachingTimes(level, delay, offset))
@@ -31,6 +31,7 @@
 #include "DVDPlayerVideo.h"
 #include "DVDPlayerSubtitle.h"
 #include "DVDPlayerTeletext.h"
+#include "DVDDemuxReader.h"
 
 //#include "DVDChapterReader.h"
 #include "DVDSubtitles/DVDFactorySubtitle.h"
@@ -347,6 +348,7 @@ protected:
   ECacheState  m_caching;
   CFileItem    m_item;
   unsigned int m_iChannelEntryTimeOut;
+  unsigned int m_openTime;   // when the file was opened, until the first frame is shown
 
 
   CCurrentStream m_CurrentAudio;
@@ -379,6 +381,7 @@ protected:
   CDVDInputStream* m_pInputStream;  // input stream for current playing file
   CDVDDemux* m_pDemuxer;            // demuxer for current playing file
   CDVDDemux* m_pSubtitleDemuxer;
+  CDVDDemuxReader m_demuxReader;    // reads ahead from m_pDemuxer on its own thread
 
   CStdString m_lastSub;
 
@@ -260,6 +260,8 @@ void CDVDPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
   m_hints   = hint;
   m_stalled = m_messageQueue.GetPacketCount(CDVDMsg::DEMUXER_PACKET) == 0;
   m_started = false;
+
+  CSingleLock lock(m_codecnameSection);
   m_codecname = m_pVideoCodec->GetName();
 }
 
@@ -697,9 +699,15 @@ void CDVDPlayerVideo::Process()
             CDVDCodecUtils::FreePicture(pTempYUVPackedPicture);
 #endif
 
-            if(m_started == false)
+            // the name also tells how the codec is threaded, which can change while playing
+            if(m_codecname != m_pVideoCodec->GetName())
             {
+              CSingleLock lock(m_codecnameSection);
               m_codecname = m_pVideoCodec->GetName();
+            }
+
+            if(m_started == false)
+            {
               m_started = true;
               m_messageParent.Put(new CDVDMsgInt(CDVDMsg::PLAYER_STARTED, DVDPLAYER_VIDEO));
             }
@@ -1531,7 +1539,11 @@ std::string CDVDPlayerVideo::GetPlayerInfo()
   std::ostringstream s;
   s << "fr:"     << fixed << setprecision(3) << m_fFrameRate;
   s << ", vq:"   << setw(2) << min(99,GetLevel()) << "%";
-  s << ", dc:"   << m_codecname;
+  s << ", vql:"  << m_messageQueue.GetLatencyInfo();
+  {
+    CSingleLock lock(m_codecnameSection);
+    s << ", dc:"   << m_codecname;
+  }
   s << ", Mb/s:" << fixed << setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", drop:" << m_iDroppedFrames;
 
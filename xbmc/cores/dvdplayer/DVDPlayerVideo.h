@@ -21,12 +21,14 @@
  */
 
 #include "threads/Thread.h"
+#include "threads/CriticalSection.h"
 #include "DVDMessageQueue.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDCodecs/Video/DVDVideoCodec.h"
 #include "DVDClock.h"
 #include "DVDOverlayContainer.h"
 #include "DVDTSCorrection.h"
+#include <list>
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
 #endif
@@ -177,6 +179,7 @@ protected:
   bool m_stalled;
   bool m_started;
   std::string m_codecname;
+  CCriticalSection m_codecnameSection; ///< m_codecname is read by GetPlayerInfo() from other threads
 
   /* autosync decides on how much of clock we should use when deciding sleep time */
   /* the value is the same as 63% timeconstant, ie that the step response of */
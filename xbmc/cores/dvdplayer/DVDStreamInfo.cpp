@@ -41,6 +41,7 @@ void CDVDStreamInfo::Clear()
   codec = CODEC_ID_NONE;
   type = STREAM_NONE;
   software = false;
+  realtime = false;
   codec_tag  = 0;
 
   if( extradata && extrasize ) free(extradata);
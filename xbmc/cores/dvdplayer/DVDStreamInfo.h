@@ -62,6 +62,7 @@ public:
   CodecID codec;
   StreamType type;
   bool software;  //force software decoding
+  bool realtime;  //live stream, decoding should not add latency
 
 
   // VIDEO
@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoThreadingPolicy.h"
+#include "utils/CPUInfo.h"
+
+#include "gtest/gtest.h"
+
+// frames the policy looks at before deciding, see DVDVideoThreadingPolicy.cpp
+static const unsigned int window = 250;
+
+class TestDVDVideoThreadingPolicy : public testing::Test
+{
+protected:
+  TestDVDVideoThreadingPolicy() { policy.Attach(); }
+  ~TestDVDVideoThreadingPolicy() { policy.Detach(); }
+
+  // feed frames with every nth dropped, returns the frame that asked for a reopen, or 0
+  unsigned int Feed(unsigned int frames, unsigned int dropEvery)
+  {
+    unsigned int reopen = 0;
+    for (unsigned int i = 1; i <= frames; i++)
+    {
+      if (policy.Update(dropEvery && i % dropEvery == 0))
+      {
+        EXPECT_EQ(0U, reopen) << "asked for a reopen twice";
+        reopen = i;
+      }
+    }
+    return reopen;
+  }
+
+  static bool MultiCore() { return g_cpuInfo.getCPUCount() > 1; }
+
+  CDVDVideoThreadingPolicy policy;
+};
+
+TEST_F(TestDVDVideoThreadingPolicy, StartsWithSliceThreads)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_AUTO, 1920, 1080, true, true);
+  if (!MultiCore())
+  {
+    EXPECT_EQ(CDVDVideoThreadingPolicy::TYPE_NONE, policy.GetType());
+    return;
+  }
+  EXPECT_EQ(CDVDVideoThreadingPolicy::TYPE_SLICE, policy.GetType());
+  EXPECT_LT(1, policy.GetCount());
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, EscalatesWhenFramesDrop)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_AUTO, 1920, 1080, true, true);
+
+  // one in five dropped is well beyond what the policy tolerates
+  unsigned int reopen = Feed(window * 4, 5);
+  if (!MultiCore())
+  {
+    EXPECT_EQ(0U, reopen);
+    return;
+  }
+  EXPECT_EQ(window, reopen);
+  EXPECT_EQ(CDVDVideoThreadingPolicy::TYPE_FRAME, policy.GetType());
+  EXPECT_LT(1, policy.GetCount());
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, EscalatesWithoutSliceThreads)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_AUTO, 1920, 1080, false, true);
+  EXPECT_EQ(CDVDVideoThreadingPolicy::TYPE_NONE, policy.GetType());
+  EXPECT_EQ(1, policy.GetCount());
+
+  unsigned int reopen = Feed(window, 2);
+  if (MultiCore())
+  {
+    EXPECT_EQ(window, reopen);
+    EXPECT_EQ(CDVDVideoThreadingPolicy::TYPE_FRAME, policy.GetType());
+  }
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, KeepsUpWithoutDrops)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_AUTO, 1920, 1080, true, true);
+  CDVDVideoThreadingPolicy::EType type = policy.GetType();
+
+  // an occasional drop is not worth a reopen
+  EXPECT_EQ(0U, Feed(window * 4, 20));
+  EXPECT_EQ(type, policy.GetType());
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, NoEscalationWithoutFrameThreads)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_AUTO, 1920, 1080, true, false);
+  EXPECT_EQ(0U, Feed(window * 4, 2));
+  EXPECT_NE(CDVDVideoThreadingPolicy::TYPE_FRAME, policy.GetType());
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, LowLatencyNeverEscalates)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_LOWLATENCY, 1920, 1080, true, true);
+  EXPECT_EQ(0U, Feed(window * 4, 2));
+  EXPECT_NE(CDVDVideoThreadingPolicy::TYPE_FRAME, policy.GetType());
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, SingleHasNoThreads)
+{
+  policy.Configure(CDVDVideoThreadingPolicy::MODE_SINGLE, 1920, 1080, true, true);
+  EXPECT_EQ(CDVDVideoThreadingPolicy::TYPE_NONE, policy.GetType());
+  EXPECT_EQ(1, policy.GetCount());
+  EXPECT_EQ(0U, Feed(window * 4, 2));
+}
+
+TEST_F(TestDVDVideoThreadingPolicy, ModeStrings)
+{
+  EXPECT_EQ(CDVDVideoThreadingPolicy::MODE_LOWLATENCY, CDVDVideoThreadingPolicy::ModeFromString("lowlatency"));
+  EXPECT_EQ(CDVDVideoThreadingPolicy::MODE_SINGLE, CDVDVideoThreadingPolicy::ModeFromString("single"));
+  EXPECT_EQ(CDVDVideoThreadingPolicy::MODE_AUTO, CDVDVideoThreadingPolicy::ModeFromString("anything else"));
+  EXPECT_STREQ("single", CDVDVideoThreadingPolicy::ModeToString(CDVDVideoThreadingPolicy::MODE_SINGLE));
+}
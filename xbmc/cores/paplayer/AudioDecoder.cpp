@@ -19,9 +19,11 @@
  */
 
 #include "AudioDecoder.h"
+#include "AudioRenderCache.h"
 #include "CodecFactory.h"
 #include "settings/GUISettings.h"
 #include "FileItem.h"
+#include "music/MusicDatabase.h"
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -56,7 +58,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds)
 {
   Destroy();
 
@@ -74,14 +76,20 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
   else if ( file.IsOnLAN() )
     filecache = g_guiSettings.GetInt("cacheaudio.lan");
 
-  // create our codec
-  m_codec=CodecFactory::CreateCodecDemux(file.GetPath(), file.GetMimeType(), filecache * 1024);
+  // synthesized audio that has been rendered before is read from the cache
+  m_codec = CAudioRenderCache::Get().OpenCodec(file);
 
-  if (!m_codec || !m_codec->Init(file.GetPath(), filecache * 1024))
+  if (!m_codec)
   {
-    CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", file.GetPath().c_str());
-    Destroy();
-    return false;
+    // create our codec
+    m_codec=CodecFactory::CreateCodecDemux(file.GetPath(), file.GetMimeType(), filecache * 1024);
+
+    if (!m_codec || !m_codec->Init(file.GetPath(), filecache * 1024))
+    {
+      CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", file.GetPath().c_str());
+      Destroy();
+      return false;
+    }
   }
   unsigned int blockSize = (m_codec->m_BitsPerSample >> 3) * m_codec->GetChannelInfo().Count();
 
@@ -92,8 +100,20 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  // fall back to the values measured by the music library if the file has no ReplayGain tags
+  if (!m_codec->m_tag.HasReplayGainInfo() && g_guiSettings.m_replayGain.iType != REPLAY_GAIN_NONE &&
+      !file.IsInternetStream())
+  {
+    CMusicDatabase database;
+    if (database.Open())
+    {
+      database.GetReplayGain(file.GetPath(), m_codec->m_tag);
+      database.Close();
+    }
+  }
+
+  /* allocate the pcmBuffer for the requested seconds of audio */
+  m_pcmBuffer.Create(bufferSeconds * blockSize * m_codec->m_SampleRate);
 
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
@@ -56,7 +56,11 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  /*!
+   \brief Opens the codec for the given file
+   \param bufferSeconds Seconds of decoded audio the decoder buffers
+   */
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds = 2);
   void Destroy();
 
   int ReadSamples(int numsamples);
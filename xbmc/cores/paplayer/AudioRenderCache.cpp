@@ -0,0 +1,293 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AudioRenderCache.h"
+#include "CodecFactory.h"
+#include "RenderCacheCodec.h"
+#include "FileItem.h"
+#include "PlayListPlayer.h"
+#include "URL.h"
+#include "filesystem/File.h"
+#include "music/tags/MusicInfoTag.h"
+#include "playlists/PlayList.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/md5.h"
+#include "utils/URIUtils.h"
+
+#include <vector>
+
+using namespace std;
+using namespace XFILE;
+using namespace PLAYLIST;
+
+#define RENDER_CACHE_PATH  "special://temp/audiocache/"
+
+// bytes rendered at once
+#define RENDER_BUFFER_SIZE (64 * 1024)
+
+/* renders a file to a cache entry, the entry is written to a temporary file
+   that is renamed once the whole file has been rendered */
+class CAudioRenderJob : public CJob
+{
+public:
+  CAudioRenderJob(const CFileItem &file, const string &name, const string &path, int64_t maxSize)
+    : m_file(file), m_name(name), m_path(path), m_maxSize(maxSize), m_size(0)
+  {
+  }
+
+  virtual const char *GetType() const { return "audiorender"; }
+
+  virtual bool operator==(const CJob *job) const
+  {
+    if (strcmp(job->GetType(), GetType()) == 0)
+    {
+      const CAudioRenderJob *renderJob = dynamic_cast<const CAudioRenderJob*>(job);
+      if (renderJob && renderJob->m_name == m_name)
+        return true;
+    }
+    return false;
+  }
+
+  virtual bool DoWork()
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+
+    // synthesizing codecs load the whole file themselves, so no file cache is needed
+    ICodec *codec = CodecFactory::CreateCodecDemux(m_file.GetPath(), m_file.GetMimeType(), 0);
+    if (!codec || !codec->Init(m_file.GetPath(), 0))
+    {
+      delete codec;
+      return false;
+    }
+
+    // the length of most of these formats is unknown, so they play as long as the tag says
+    if (m_file.HasMusicInfoTag() && m_file.GetMusicInfoTag()->GetDuration())
+      codec->SetTotalTime(m_file.GetMusicInfoTag()->GetDuration());
+
+    unsigned int blockSize = (codec->m_BitsPerSample >> 3) * codec->GetChannelInfo().Count();
+    CStdString temp = m_path + ".tmp";
+    CFile output;
+    bool result = blockSize > 0 && output.OpenForWrite(temp, true) &&
+                  RenderCacheCodec::WriteHeader(output, *codec);
+
+    vector<BYTE> buffer(RENDER_BUFFER_SIZE);
+    int bufferSize = blockSize > 0 ? RENDER_BUFFER_SIZE - RENDER_BUFFER_SIZE % blockSize : 0;
+    while (result)
+    {
+      if (ShouldCancel(0, 0))
+      {
+        result = false;
+        break;
+      }
+
+      // trackers signal the end of a song by a short read reported as an
+      // error, for everyone else an error means the rendering failed
+      int size = 0;
+      int ret = codec->ReadPCM(&buffer[0], bufferSize, &size);
+      if (ret == READ_ERROR && !codec->ReadErrorIsEOF())
+      {
+        result = false;
+        break;
+      }
+
+      if (size > 0)
+      {
+        if (output.Write(&buffer[0], size) != size)
+        {
+          result = false;
+          break;
+        }
+        m_size += size;
+      }
+
+      if (ret != READ_SUCCESS)
+        break;
+
+      // endlessly looping songs would fill up the disk
+      if (m_size > m_maxSize)
+        result = false;
+    }
+    output.Close();
+    delete codec;
+
+    if (result && m_size > 0)
+      result = CFile::Rename(temp, m_path);
+    else
+      result = false;
+
+    if (!result)
+    {
+      CFile::Delete(temp);
+      return false;
+    }
+
+    CLog::Log(LOGDEBUG, "CAudioRenderJob: rendered %s (%"PRId64" bytes) in %u ms", m_file.GetPath().c_str(),
+              m_size, XbmcThreads::SystemClockMillis() - start);
+    return true;
+  }
+
+  const string &GetName() const { return m_name; }
+  int64_t GetSize() const { return m_size; }
+
+private:
+  CFileItem m_file;
+  string    m_name;
+  string    m_path;
+  int64_t   m_maxSize;
+  int64_t   m_size;
+};
+
+CAudioRenderCache &CAudioRenderCache::Get()
+{
+  static CAudioRenderCache audioRenderCache;
+  return audioRenderCache;
+}
+
+CAudioRenderCache::CAudioRenderCache()
+  : CJobQueue(false, 1, CJob::PRIORITY_LOW),
+    m_maxSize((int64_t)g_advancedSettings.m_audioRenderCacheSize * 1024 * 1024),
+    m_prefetch(g_advancedSettings.m_audioRenderCachePrefetch),
+    m_cache(RENDER_CACHE_PATH, m_maxSize)
+{
+}
+
+bool CAudioRenderCache::IsCacheable(const CFileItem &file)
+{
+  if (file.IsInternetStream())
+    return false;
+
+  ICodec *codec = CodecFactory::CreateCodec(CURL(file.GetPath()).GetFileType());
+  bool cacheable = codec && codec->IsSynthesized();
+  delete codec;
+  return cacheable;
+}
+
+ICodec *CAudioRenderCache::OpenCodec(const CFileItem &file)
+{
+  if (!IsEnabled() || !IsCacheable(file))
+    return NULL;
+
+  // touching only rewrites the index every few plays
+  string name = GetEntryName(file);
+  if (!m_cache.Touch(name))
+    return NULL;
+
+  RenderCacheCodec *codec = new RenderCacheCodec();
+  if (!codec->Init(m_cache.GetEntryPath(name), 0))
+  {
+    delete codec;
+    m_cache.Remove(name);
+    return NULL;
+  }
+
+  CLog::Log(LOGDEBUG, "CAudioRenderCache: playing %s from the cache", file.GetPath().c_str());
+  return codec;
+}
+
+void CAudioRenderCache::Prefetch(const CFileItem &file)
+{
+  if (!IsEnabled())
+    return;
+
+  Queue(file);
+
+  int playlist = g_playlistPlayer.GetCurrentPlaylist();
+  if (playlist == PLAYLIST_NONE)
+    return;
+
+  // the file is either the current item (playback started) or the next one
+  // (queued for a gapless transition)
+  const CPlayList &items = g_playlistPlayer.GetPlaylist(playlist);
+  int offset = -1;
+  for (int i = 0; i <= 1 && offset < 0; i++)
+  {
+    int index = g_playlistPlayer.GetNextSong(i);
+    if (index >= 0 && index < items.size() && items[index]->IsSamePath(&file))
+      offset = i;
+  }
+  if (offset < 0)
+    return;
+
+  for (unsigned int i = 1; i <= m_prefetch; i++)
+  {
+    int index = g_playlistPlayer.GetNextSong(offset + i);
+    if (index < 0 || index >= items.size())
+      break;
+    Queue(*items[index]);
+  }
+}
+
+void CAudioRenderCache::Queue(const CFileItem &file)
+{
+  if (!IsCacheable(file))
+    return;
+
+  string name = GetEntryName(file);
+
+  CSingleLock lock(m_critSection);
+  if (m_cache.Has(name) || !m_rendering.insert(name).second)
+    return;
+
+  AddJob(new CAudioRenderJob(file, name, m_cache.GetEntryPath(name), m_maxSize));
+}
+
+void CAudioRenderCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CAudioRenderJob *renderJob = static_cast<CAudioRenderJob*>(job);
+  {
+    CSingleLock lock(m_critSection);
+    m_rendering.erase(renderJob->GetName());
+    if (success)
+      m_cache.Add(renderJob->GetName(), renderJob->GetSize());
+  }
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
+
+string CAudioRenderCache::GetEntryName(const CFileItem &file) const
+{
+  CStdString key = file.GetPath();
+
+  // stream files of a subtrack (sidstream, nsfstream) are located inside the
+  // file they are rendered from
+  struct __stat64 st;
+  if (CFile::Stat(file.GetPath(), &st) != 0)
+  {
+    CStdString strFile;
+    URIUtils::GetDirectory(file.GetPath(), strFile);
+    URIUtils::RemoveSlashAtEnd(strFile);
+    if (CFile::Stat(strFile, &st) != 0)
+      memset(&st, 0, sizeof(st));
+  }
+
+  CStdString details;
+  details.Format("|%"PRId64"|%"PRId64, (int64_t)st.st_size, (int64_t)st.st_mtime);
+  key += details;
+
+  if (file.HasMusicInfoTag())
+  {
+    details.Format("|%i", file.GetMusicInfoTag()->GetDuration());
+    key += details;
+  }
+
+  return XBMC::XBMC_MD5::GetMD5(key) + ".pcm";
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <set>
+#include <string>
+
+#include "threads/CriticalSection.h"
+#include "utils/DiskLRUCache.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+
+class CFileItem;
+class ICodec;
+
+/*!
+ \brief Renders the output of synthesizing codecs (SID, NSF, SPC, MIDI,
+ trackers, ...) to disk, so replaying and seeking become plain file reads
+
+ Entries are keyed by the path (including the subtrack of stream files),
+ the size and modification time of the file and its duration. They are
+ rendered in the background for the current and the upcoming items of the
+ playlist. The least recently used entries are removed once the cache
+ exceeds its size limit (<audio><rendercachesize> in MB, 0 disables it).
+ */
+class CAudioRenderCache : public CJobQueue
+{
+public:
+  static CAudioRenderCache &Get();
+
+  bool IsEnabled() const { return m_maxSize > 0; }
+
+  /*!
+   \brief Opens a codec reading the rendered audio of the given file
+   \return The initialized codec or NULL if the file has not been rendered yet
+   */
+  ICodec *OpenCodec(const CFileItem &file);
+
+  /*!
+   \brief Queues the given file and the items following it in the active
+   playlist for rendering
+   */
+  void Prefetch(const CFileItem &file);
+
+  /*!
+   \brief Whether the file is played by a codec that synthesizes its output
+   */
+  static bool IsCacheable(const CFileItem &file);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  CAudioRenderCache();
+
+  void Queue(const CFileItem &file);
+  std::string GetEntryName(const CFileItem &file) const;
+
+  CCriticalSection m_critSection;
+  int64_t      m_maxSize;
+  unsigned int m_prefetch;
+  CDiskLRUCache m_cache;
+  std::set<std::string> m_rendering; ///< entries queued or being rendered
+};
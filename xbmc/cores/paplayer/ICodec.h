@@ -89,6 +89,17 @@ public:
   // set the total time - useful when info comes from a preset tag
   virtual void SetTotalTime(int64_t totaltime) {}
 
+  // IsSynthesized()
+  // Should return true if the audio is synthesized (emulated chips, trackers, MIDI),
+  // which makes decoding expensive and seeking slow. The rendered output of such
+  // codecs can be kept in the CAudioRenderCache.
+  virtual bool IsSynthesized() const {return false;}
+
+  // ReadErrorIsEOF()
+  // Should return true if ReadPCM() reports the end of the song as READ_ERROR,
+  // as trackers do with their last, short read.
+  virtual bool ReadErrorIsEOF() const {return false;}
+
   virtual bool IsCaching()    const    {return false;}
   virtual int GetCacheLevel() const    {return -1;}
 
@@ -34,6 +34,8 @@ public:
   virtual int64_t Seek(int64_t iSeekTime);
   virtual int ReadPCM(BYTE *pBuffer, int size, int *actualsize);
   virtual bool CanInit();
+  virtual bool IsSynthesized() const { return true; }
+  virtual bool ReadErrorIsEOF() const { return true; }
 private:
   ModPlugFile *m_module;
   DllModplug m_dll;
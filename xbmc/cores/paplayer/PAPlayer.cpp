@@ -19,6 +19,7 @@
  */
 
 #include "PAPlayer.h"
+#include "AudioRenderCache.h"
 #include "CodecFactory.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
@@ -26,15 +27,17 @@
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
 #include "utils/TimeUtils.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
 
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 
-#define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
+#define TIME_TO_CACHE_NEXT_FILE 5000 /* at least 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -43,6 +46,44 @@ CAEChannelInfo ICodec::GetChannelInfo()
   return CAEUtil::GuessChLayout(m_Channels);
 }
 
+/* opens the queued file and decodes its beginning while the current file is playing */
+class CDecodeAheadJob : public CJob
+{
+public:
+  CDecodeAheadJob(const CFileItem &file, PAPlayer::StreamInfo *si, bool fadeIn) :
+    m_file(file), m_si(si), m_fadeIn(fadeIn)
+  {
+  }
+
+  virtual ~CDecodeAheadJob()
+  {
+    /* the stream is only handed over to the player if it was completed */
+    delete m_si;
+  }
+
+  virtual const char *GetType() const { return "paplayerdecodeahead"; }
+
+  virtual bool DoWork()
+  {
+    return PAPlayer::OpenDecoder(m_si, m_file, g_advancedSettings.m_audioDecodeAhead, this);
+  }
+
+  PAPlayer::StreamInfo *Detach()
+  {
+    PAPlayer::StreamInfo *si = m_si;
+    m_si = NULL;
+    return si;
+  }
+
+  const CFileItem &GetFile() const { return m_file; }
+  bool GetFadeIn() const { return m_fadeIn; }
+
+private:
+  CFileItem             m_file;
+  PAPlayer::StreamInfo *m_si;
+  bool                  m_fadeIn;
+};
+
 // PAP: Psycho-acoustic Audio Player
 // Supporting all open  audio codec standards.
 // First one being nullsoft's nsv audio decoder format
@@ -59,7 +100,14 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_upcomingCrossfadeMS(0),
   m_currentStream      (NULL ),
   m_audioCallback      (NULL ),
-  m_FileItem           (new CFileItem())
+  m_FileItem           (new CFileItem()),
+  m_decodeAheadJob     (0),
+  m_streamEndsAt       (0),
+  m_transitions        (0),
+  m_lateTransitions    (0),
+  m_lastGapMS          (0),
+  m_maxGapMS           (0),
+  m_lastOpenMS         (0)
 {
   memset(&m_playerGUIData, 0, sizeof(m_playerGUIData));
 }
@@ -185,6 +233,8 @@ void PAPlayer::SoftStop(bool wait/* = false */, bool close/* = true */)
 
 void PAPlayer::CloseAllStreams(bool fade/* = true */)
 {
+  CancelDecodeAhead();
+
   if (!fade) 
   {
     CExclusiveLock lock(m_streamsLock);
@@ -231,6 +281,10 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
   m_defaultCrossfadeMS = g_guiSettings.GetInt("musicplayer.crossfade") * 1000;
 
+  /* the file queued before is not going to be played */
+  CancelDecodeAhead();
+  m_streamEndsAt = 0;
+
   if (m_streams.size() > 1 || !m_defaultCrossfadeMS || m_isPaused)
   {
     CloseAllStreams(!m_isPaused);
@@ -286,23 +340,52 @@ void PAPlayer::UpdateCrossfadeTime(const CFileItem& file)
 
 bool PAPlayer::QueueNextFile(const CFileItem &file)
 {
-  return QueueNextFileEx(file);
+  return QueueNextFileEx(file, true, true);
 }
 
-bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
+bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, bool decodeAhead/* = false */)
 {
+  /* render synthesized files and the ones following them in the background,
+     so replaying and seeking them is cheap */
+  CAudioRenderCache::Get().Prefetch(file);
+
   StreamInfo *si = new StreamInfo();
+  si->m_queuedAt = XbmcThreads::SystemClockMillis();
 
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  if (decodeAhead)
   {
-    CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
+    /* open the codec (which can take a while for network files) and decode
+       ahead on a job so that neither the caller nor the playing stream has
+       to wait for it. It is queued seconds before it is needed, so it does
+       not take the worker kept free for high priority jobs */
+    CSingleLock lock(m_decodeAheadSection);
+    if (m_decodeAheadJob)
+      CJobManager::GetInstance().CancelJob(m_decodeAheadJob);
+    m_decodeAheadJob = CJobManager::GetInstance().AddJob(new CDecodeAheadJob(file, si, fadeIn), this, CJob::PRIORITY_NORMAL);
+    return true;
+  }
 
+  if (!OpenDecoder(si, file, 2, NULL))
+  {
     delete si;
     m_callback.OnQueueNextItem();
     return false;
   }
 
-  /* decode until there is data-available */
+  AddStream(si, file, fadeIn);
+  return true;
+}
+
+bool PAPlayer::OpenDecoder(StreamInfo *si, const CFileItem &file, unsigned int bufferSeconds, const CJob *job)
+{
+  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75, bufferSeconds))
+  {
+    CLog::Log(LOGWARNING, "PAPlayer::OpenDecoder - Failed to create the decoder");
+    return false;
+  }
+
+  /* decode until there is data-available, which is once the decoder's
+     buffer has been filled */
   si->m_decoder.Start();
   while(si->m_decoder.GetDataSize() == 0)
   {
@@ -311,18 +394,58 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
         status == STATUS_NO_FILE ||
         si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
     {
-      CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error reading samples");
+      CLog::Log(LOGINFO, "PAPlayer::OpenDecoder - Error reading samples");
 
       si->m_decoder.Destroy();
-      delete si;
-      m_callback.OnQueueNextItem();
       return false;
     }
 
+    if (job && job->ShouldCancel(0, 0))
+      return false;
+
     /* yield our time so that the main PAP thread doesnt stall */
-    CThread::Sleep(1);
+    ::Sleep(1);
   }
 
+  return true;
+}
+
+void PAPlayer::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_decodeAheadSection);
+  if (jobID != m_decodeAheadJob)
+    return;
+  m_decodeAheadJob = 0;
+
+  CDecodeAheadJob *decodeAhead = (CDecodeAheadJob*)job;
+  if (!success)
+  {
+    lock.Leave();
+    m_callback.OnQueueNextItem();
+    return;
+  }
+
+  StreamInfo *si = decodeAhead->Detach();
+  m_lastOpenMS = XbmcThreads::SystemClockMillis() - si->m_queuedAt;
+  CLog::Log(LOGDEBUG, "PAPlayer::OnJobComplete - Opened and decoded ahead %s in %u ms",
+            decodeAhead->GetFile().GetPath().c_str(), m_lastOpenMS);
+
+  /* keep the lock so that the player can't go away while the stream is added */
+  AddStream(si, decodeAhead->GetFile(), decodeAhead->GetFadeIn());
+}
+
+void PAPlayer::CancelDecodeAhead()
+{
+  CSingleLock lock(m_decodeAheadSection);
+  if (m_decodeAheadJob)
+  {
+    CJobManager::GetInstance().CancelJob(m_decodeAheadJob);
+    m_decodeAheadJob = 0;
+  }
+}
+
+void PAPlayer::AddStream(StreamInfo *si, const CFileItem &file, bool fadeIn)
+{
   UpdateCrossfadeTime(file);
 
   /* init the streaminfo struct */
@@ -345,9 +468,11 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   if (si->m_endOffset)
     streamTotalTime = si->m_endOffset - si->m_startOffset;
   
+  /* queue the next file early enough for it to be decoded ahead */
+  unsigned int timeToCache = std::max((unsigned int)TIME_TO_CACHE_NEXT_FILE, g_advancedSettings.m_audioDecodeAhead * 1000);
   si->m_prepareNextAtFrame = 0;
-  if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-    si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
+  if (streamTotalTime >= timeToCache + m_defaultCrossfadeMS)
+    si->m_prepareNextAtFrame = (int)((streamTotalTime - timeToCache - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
 
   si->m_prepareTriggered = false;
 
@@ -363,8 +488,6 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
 
   *m_FileItem = file;
-
-  return true;
 }
 
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
@@ -530,6 +653,11 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
         m_callback.OnQueueNextItem();
       }
 
+      /* remember when the stream will have been played out, unless it has
+         been stopped or faded out anyway */
+      if (si->m_started && !si->m_fadeOutTriggered && si->m_stream)
+        m_streamEndsAt = XbmcThreads::SystemClockMillis() + MathUtils::round_int(si->m_stream->GetDelay() * 1000.0);
+
       /* remove the stream */
       itt = m_streams.erase(itt);
       /* if its the current stream */
@@ -608,6 +736,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
     if (!si->m_isSlaved)
       si->m_stream->Resume();
     si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
+    OnStreamStarted(si);
     m_callback.OnPlayBackStarted();
   }
 
@@ -674,6 +803,36 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
   return true;
 }
 
+void PAPlayer::OnStreamStarted(StreamInfo *si)
+{
+  /* a transition is gapless if the previous stream is still playing */
+  bool overlapping = false;
+  for(StreamList::iterator itt = m_streams.begin(); itt != m_streams.end(); ++itt)
+  {
+    if (*itt != si && (*itt)->m_started)
+      overlapping = true;
+  }
+
+  /* nothing played before this stream */
+  if (!overlapping && !m_streamEndsAt)
+    return;
+
+  m_lastGapMS = 0;
+  int gap = (int)(XbmcThreads::SystemClockMillis() - m_streamEndsAt);
+  if (!overlapping && gap > 0)
+  {
+    m_lastGapMS = gap;
+    m_lateTransitions++;
+  }
+
+  m_transitions++;
+  m_maxGapMS     = std::max(m_maxGapMS, m_lastGapMS);
+  m_streamEndsAt = 0;
+
+  CLog::Log(LOGDEBUG, "PAPlayer::OnStreamStarted - Transition to the next stream with a gap of %u ms (%u of %u transitions with a gap)",
+            m_lastGapMS, m_lateTransitions, m_transitions);
+}
+
 bool PAPlayer::QueueData(StreamInfo *si)
 {
   unsigned int space   = si->m_stream->GetSpace();
@@ -697,6 +856,12 @@ bool PAPlayer::QueueData(StreamInfo *si)
   return true;
 }
 
+void PAPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
+{
+  strGeneralInfo.Format("decode ahead:%us, last open:%ums, transitions:%u, with gap:%u, last gap:%ums, max gap:%ums",
+                        g_advancedSettings.m_audioDecodeAhead, m_lastOpenMS, m_transitions, m_lateTransitions, m_lastGapMS, m_maxGapMS);
+}
+
 void PAPlayer::OnExit()
 {
 
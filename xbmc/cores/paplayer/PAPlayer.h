@@ -26,6 +26,7 @@
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
 #include "threads/SharedSection.h"
+#include "utils/Job.h"
 
 #include "cores/IAudioCallback.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
@@ -33,8 +34,10 @@
 class IAEStream;
 
 class CFileItem;
-class PAPlayer : public IPlayer, public CThread
+class CDecodeAheadJob;
+class PAPlayer : public IPlayer, public CThread, public IJobCallback
 {
+  friend class CDecodeAheadJob;
 public:
   PAPlayer(IPlayerCallback& callback);
   virtual ~PAPlayer();
@@ -58,7 +61,7 @@ public:
   virtual void SetDynamicRangeCompression(long drc);
   virtual void GetAudioInfo( CStdString& strAudioInfo) {}
   virtual void GetVideoInfo( CStdString& strVideoInfo) {}
-  virtual void GetGeneralInfo( CStdString& strVideoInfo) {}
+  virtual void GetGeneralInfo( CStdString& strVideoInfo);
   virtual void Update(bool bPauseDrawing = false) {}
   virtual void ToFFRW(int iSpeed = 0);
   virtual int GetCacheLevel() const;
@@ -74,6 +77,8 @@ public:
 
   static bool HandlesType(const CStdString &type);
 
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
   struct
   {
     char         m_codec[21];
@@ -119,6 +124,7 @@ private:
     float             m_volume;              /* the initial volume level to set the stream to on creation */
 
     bool              m_isSlaved;            /* true if the stream has been slaved to another */
+    unsigned int      m_queuedAt;            /* when the file has been queued (ms) */
   } StreamInfo;
 
   typedef std::list<StreamInfo*> StreamList;
@@ -140,7 +146,22 @@ private:
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
 
-  bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  CCriticalSection    m_decodeAheadSection;  /* lock for the decode ahead job */
+  unsigned int        m_decodeAheadJob;      /* job opening and decoding the queued file, 0 for none */
+
+  /* measurements of the transitions between streams */
+  unsigned int        m_streamEndsAt;        /* when the last stream will have been played (ms), 0 for none */
+  unsigned int        m_transitions;         /* number of transitions from one stream to the next */
+  unsigned int        m_lateTransitions;     /* number of transitions with a gap */
+  unsigned int        m_lastGapMS;           /* gap of the last transition */
+  unsigned int        m_maxGapMS;            /* largest gap of any transition */
+  unsigned int        m_lastOpenMS;          /* time it took to open and decode ahead the last queued file */
+
+  bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true, bool decodeAhead = false);
+  static bool OpenDecoder(StreamInfo *si, const CFileItem &file, unsigned int bufferSeconds, const CJob *job);
+  void AddStream(StreamInfo *si, const CFileItem &file, bool fadeIn);
+  void CancelDecodeAhead();
+  void OnStreamStarted(StreamInfo *si);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
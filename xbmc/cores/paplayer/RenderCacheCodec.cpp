@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderCacheCodec.h"
+#include "utils/log.h"
+
+#include <string.h>
+
+#define RENDER_CACHE_MAGIC   "XRAC"
+#define RENDER_CACHE_VERSION 1
+
+RenderCacheCodec::RenderCacheCodec()
+{
+  m_CodecName = "rendercache";
+  m_dataStart = 0;
+  m_dataLength = 0;
+  m_position = 0;
+  m_frameSize = 0;
+}
+
+RenderCacheCodec::~RenderCacheCodec()
+{
+  DeInit();
+}
+
+bool RenderCacheCodec::Init(const CStdString &strFile, unsigned int filecache)
+{
+  m_file.Close();
+  if (!m_file.Open(strFile))
+  {
+    CLog::Log(LOGERROR, "RenderCacheCodec::Init - Failed to open %s", strFile.c_str());
+    return false;
+  }
+
+  RenderCacheHeader header;
+  if (m_file.Read(&header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, RENDER_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != RENDER_CACHE_VERSION ||
+      header.sampleRate == 0 || header.bitsPerSample < 8 ||
+      header.channelCount == 0 || header.channelCount >= AE_CH_MAX)
+  {
+    CLog::Log(LOGERROR, "RenderCacheCodec::Init - Invalid header in %s", strFile.c_str());
+    m_file.Close();
+    return false;
+  }
+
+  enum AEChannel channels[AE_CH_MAX];
+  for (unsigned int i = 0; i < header.channelCount; i++)
+    channels[i] = (enum AEChannel)header.channels[i];
+  channels[header.channelCount] = AE_CH_NULL;
+  m_channelInfo = channels;
+
+  header.codecName[sizeof(header.codecName) - 1] = '\0';
+  m_CodecName = header.codecName;
+
+  m_SampleRate = header.sampleRate;
+  m_EncodedSampleRate = header.encodedSampleRate;
+  m_BitsPerSample = header.bitsPerSample;
+  m_DataFormat = (enum AEDataFormat)header.dataFormat;
+  m_Bitrate = header.bitrate;
+  m_Channels = header.channelCount;
+  m_frameSize = (m_BitsPerSample >> 3) * header.channelCount;
+
+  m_dataStart = sizeof(header);
+  m_dataLength = m_file.GetLength() - m_dataStart;
+  m_dataLength -= m_dataLength % m_frameSize;
+  m_position = 0;
+  m_TotalTime = m_dataLength / m_frameSize * 1000 / m_SampleRate;
+
+  return true;
+}
+
+void RenderCacheCodec::DeInit()
+{
+  m_file.Close();
+}
+
+int64_t RenderCacheCodec::Seek(int64_t iSeekTime)
+{
+  int64_t position = iSeekTime * m_SampleRate / 1000 * m_frameSize;
+  if (position > m_dataLength)
+    position = m_dataLength;
+  if (position < 0)
+    position = 0;
+
+  if (m_file.Seek(m_dataStart + position, SEEK_SET) < 0)
+    return -1;
+
+  m_position = position;
+  return m_position / m_frameSize * 1000 / m_SampleRate;
+}
+
+int RenderCacheCodec::ReadPCM(BYTE *pBuffer, int size, int *actualsize)
+{
+  *actualsize = 0;
+
+  int64_t remaining = m_dataLength - m_position;
+  if (remaining <= 0)
+    return READ_EOF;
+
+  int toRead = size - size % m_frameSize;
+  if (toRead > remaining)
+    toRead = (int)remaining;
+
+  int read = m_file.Read(pBuffer, toRead);
+  if (read <= 0)
+    return READ_ERROR;
+
+  m_position += read;
+  *actualsize = read;
+  return m_position >= m_dataLength ? READ_EOF : READ_SUCCESS;
+}
+
+bool RenderCacheCodec::CanInit()
+{
+  return true;
+}
+
+CAEChannelInfo RenderCacheCodec::GetChannelInfo()
+{
+  return m_channelInfo;
+}
+
+bool RenderCacheCodec::WriteHeader(XFILE::CFile &file, ICodec &codec)
+{
+  CAEChannelInfo channelInfo = codec.GetChannelInfo();
+  if (channelInfo.Count() == 0 || channelInfo.Count() >= AE_CH_MAX)
+    return false;
+
+  RenderCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, RENDER_CACHE_MAGIC, sizeof(header.magic));
+  header.version = RENDER_CACHE_VERSION;
+  header.sampleRate = codec.m_SampleRate;
+  header.encodedSampleRate = codec.m_EncodedSampleRate;
+  header.bitsPerSample = codec.m_BitsPerSample;
+  header.dataFormat = codec.m_DataFormat;
+  header.bitrate = codec.m_Bitrate;
+  header.channelCount = channelInfo.Count();
+  for (unsigned int i = 0; i < channelInfo.Count(); i++)
+    header.channels[i] = channelInfo[i];
+  strncpy(header.codecName, codec.m_CodecName.c_str(), sizeof(header.codecName) - 1);
+
+  return file.Write(&header, sizeof(header)) == sizeof(header);
+}
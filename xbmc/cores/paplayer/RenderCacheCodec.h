@@ -0,0 +1,63 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ICodec.h"
+
+/* header of a rendered audio cache file, followed by the rendered PCM data */
+struct RenderCacheHeader
+{
+  char     magic[4];
+  uint32_t version;
+  uint32_t sampleRate;
+  uint32_t encodedSampleRate;
+  uint32_t bitsPerSample;
+  uint32_t dataFormat;
+  uint32_t bitrate;
+  uint32_t channelCount;
+  int32_t  channels[AE_CH_MAX];
+  char     codecName[16];
+};
+
+/* plays the audio of a synthesizing codec that has been rendered to a file of
+   the CAudioRenderCache before, so seeking and replaying are plain file reads */
+class RenderCacheCodec : public ICodec
+{
+public:
+  RenderCacheCodec();
+  virtual ~RenderCacheCodec();
+
+  virtual bool Init(const CStdString &strFile, unsigned int filecache);
+  virtual void DeInit();
+  virtual int64_t Seek(int64_t iSeekTime);
+  virtual int ReadPCM(BYTE *pBuffer, int size, int *actualsize);
+  virtual bool CanInit();
+  virtual CAEChannelInfo GetChannelInfo();
+
+  /* writes the header describing the output format of the given codec */
+  static bool WriteHeader(XFILE::CFile &file, ICodec &codec);
+
+private:
+  CAEChannelInfo m_channelInfo;
+  int64_t m_dataStart;
+  int64_t m_dataLength;
+  int64_t m_position;
+  unsigned int m_frameSize;
+};
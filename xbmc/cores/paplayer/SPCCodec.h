@@ -36,6 +36,7 @@ public:
   virtual int64_t Seek(int64_t iSeekTime);
   virtual int ReadPCM(BYTE *pBuffer, int size, int *actualsize);
   virtual bool CanInit();
+  virtual bool IsSynthesized() const { return true; }
 private:
 #ifdef _LINUX
   typedef void  (__cdecl *LoadMethod) ( const void* p1);
@@ -35,6 +35,8 @@ public:
   virtual int64_t Seek(int64_t iSeekTime);
   virtual int ReadPCM(BYTE *pBuffer, int size, int *actualsize);
   virtual bool CanInit();
+  virtual bool IsSynthesized() const { return true; }
+  virtual bool ReadErrorIsEOF() const { return true; }
 
 private:
   DllStSound m_dll;
@@ -27,6 +27,7 @@
 #include "utils/AutoPtrHandle.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "sqlitedataset.h"
 #include "DatabaseManager.h"
@@ -708,6 +709,85 @@ bool CDatabase::BuildSQL(const CStdString &strQuery, const Filter &filter, CStdS
   return true;
 }
 
+bool CDatabase::BuildPagedSQL(const CStdString &strSQL, MediaType mediaType, const Filter &filter, SortDescription &sorting, CStdString &strSQLExtra, int &total)
+{
+  // nothing to do if there are no limits or if the
+  // filter already takes care of ordering and limiting
+  if ((sorting.limitStart <= 0 && sorting.limitEnd <= 0) ||
+      !filter.limit.empty() || !filter.order.empty())
+    return true;
+
+  CStdString strOrder;
+  if (sorting.sortBy == SortByDateAdded)
+  {
+    // sorting by date added doesn't involve the item's label so
+    // it can be done in SQL with the same result
+    FieldList orderFields;
+    orderFields.push_back(FieldDateAdded);
+    orderFields.push_back(FieldId);
+    strOrder = DatabaseUtils::BuildOrderClause(orderFields, mediaType, sorting.sortOrder == SortOrderDescending);
+  }
+
+  if (sorting.sortBy == SortByNone || (!strOrder.empty() && filter.group.empty()))
+  {
+    total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+    strSQLExtra += strOrder + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+
+    if (sorting.sortBy != SortByNone)
+    {
+      sorting.limitStart = 0;
+      sorting.limitEnd = -1;
+    }
+    return true;
+  }
+
+  // only retrieve the fields needed for sorting to determine the requested page
+  FieldList fields;
+  std::string idField = DatabaseUtils::GetField(FieldId, mediaType, DatabaseQueryPartSelect);
+  if (idField.empty() ||
+      !DatabaseUtils::GetSelectFields(SortUtils::GetFieldsForSorting(sorting.sortBy), mediaType, fields))
+    return true;
+
+  std::string columns = idField;
+  for (FieldList::const_iterator it = fields.begin(); it != fields.end(); it++)
+    columns += ", " + DatabaseUtils::GetField(*it, mediaType, DatabaseQueryPartSelect);
+
+  CStdString strPageSQL = PrepareSQL(strSQL, columns.c_str()) + strSQLExtra;
+  if (!m_pDS->query(strPageSQL.c_str()))
+    return false;
+
+  DatabaseResults results;
+  if (!DatabaseUtils::GetDatabaseResults(mediaType, fields, m_pDS, results, true))
+  {
+    m_pDS->close();
+    return true;
+  }
+
+  total = (int)results.size();
+  SortUtils::Sort(sorting, results);
+
+  const dbiplus::query_data &data = m_pDS->get_result_set().records;
+  std::vector<std::string> ids;
+  ids.reserve(results.size());
+  for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); it++)
+    ids.push_back(data.at((unsigned int)it->at(FieldRow).asInteger())->at(0).get_asString());
+  m_pDS->close();
+
+  Filter pageFilter = filter;
+  if (ids.empty())
+    pageFilter.AppendWhere("1 = 0");
+  else
+    pageFilter.AppendWhere(idField + " IN (" + StringUtils::Join(ids, ",") + ")");
+
+  strSQLExtra.clear();
+  if (!BuildSQL(strSQLExtra, pageFilter, strSQLExtra))
+    return false;
+
+  sorting.limitStart = 0;
+  sorting.limitEnd = -1;
+  return true;
+}
+
 bool CDatabase::BuildSQL(const CStdString &strBaseDir, const CStdString &strQuery, Filter &filter, CStdString &strSQL, CDbUrl &dbUrl)
 {
   SortDescription sorting;
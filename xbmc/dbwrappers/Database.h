@@ -20,6 +20,7 @@
  *
  */
 
+#include "utils/DatabaseUtils.h"
 #include "utils/StdString.h"
 
 namespace dbiplus {
@@ -160,6 +161,26 @@ protected:
 
   bool BuildSQL(const CStdString &strQuery, const Filter &filter, CStdString &strSQL);
 
+  /*!
+   \brief Applies the sorting and limits of a library query in SQL
+
+   If the sorting method can be expressed in SQL the ORDER BY and LIMIT
+   clauses are appended to the query. Otherwise only the item's ID and the
+   fields needed for sorting are retrieved and sorted to determine the items
+   of the requested page, and the query is restricted to their IDs. In both
+   cases the limits of the sort description are reset so that sorting the
+   retrieved items doesn't limit them again.
+
+   \param strSQL SELECT statement with a %s placeholder for the selected columns
+   \param mediaType Media type of the items of the query
+   \param filter Filter of the query (used to build strSQLExtra)
+   \param sorting Sort description of the query
+   \param strSQLExtra JOIN and WHERE clauses of the query, gets the additional clauses appended
+   \param total Receives the total number of items without limits (unchanged if there are no limits)
+   \return False if a query failed, true otherwise
+   */
+  bool BuildPagedSQL(const CStdString &strSQL, MediaType mediaType, const Filter &filter, SortDescription &sorting, CStdString &strSQLExtra, int &total);
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::auto_ptr<dbiplus::Database> m_pDB;
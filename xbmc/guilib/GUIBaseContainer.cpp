@@ -31,6 +31,7 @@
 #include "Key.h"
 #include "utils/MathUtils.h"
 #include "utils/XBMCTinyXML.h"
+#include "settings/AdvancedSettings.h"
 
 using namespace std;
 
@@ -119,6 +120,9 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   pos += drawOffset;
   end += cacheAfter * m_layout->Size(m_orientation);
 
+  if (g_advancedSettings.m_guiParallelItemLayout)
+    PrepareItems(offset - cacheBefore, pos, end);
+
   int current = offset - cacheBefore;
   while (pos < end && m_items.size())
   {
@@ -154,13 +158,9 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
 
   if (m_bInvalidated)
     item->SetInvalid();
+  AcquireLayouts(item, focused);
   if (focused)
   {
-    if (!item->GetFocusedLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_focusedLayout);
-      item->SetFocusedLayout(layout);
-    }
     if (item->GetFocusedLayout())
     {
       if (item != m_lastItem || !HasFocus())
@@ -183,11 +183,6 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   {
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
-    if (!item->GetLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_layout);
-      item->SetLayout(layout);
-    }
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     if (item->GetLayout())
@@ -197,6 +192,49 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   g_graphicsContext.RestoreOrigin();
 }
 
+void CGUIBaseContainer::AcquireLayouts(CGUIListItemPtr &item, bool focused)
+{
+  if (focused)
+  {
+    if (!item->GetFocusedLayout())
+      item->SetFocusedLayout(m_focusedLayoutPool.Acquire(*m_focusedLayout));
+  }
+  else if (!item->GetLayout())
+    item->SetLayout(m_layoutPool.Acquire(*m_layout));
+}
+
+// fetch the info of the items about to be processed that need updating all at once, so that the
+// work can be spread over several threads.  Walks the same items as Process().
+void CGUIBaseContainer::PrepareItems(int current, float pos, float end)
+{
+  CGUIListItemLayout::PrepareList layouts;
+  while (pos < end && m_items.size())
+  {
+    int itemNo = CorrectOffset(current, 0);
+    if (itemNo >= (int)m_items.size())
+      break;
+    bool focused = (current == GetOffset() + GetCursor());
+    if (itemNo >= 0)
+      PrepareItem(m_items[itemNo], focused, layouts);
+    pos += focused ? m_focusedLayout->Size(m_orientation) : m_layout->Size(m_orientation);
+    current++;
+  }
+  CGUIListItemLayout::PrepareInfo(layouts);
+}
+
+// add the layouts of an item that ProcessItem() will update to the list
+void CGUIBaseContainer::PrepareItem(CGUIListItemPtr &item, bool focused, CGUIListItemLayout::PrepareList &layouts)
+{
+  if (m_bInvalidated)
+    item->SetInvalid();
+  AcquireLayouts(item, focused);
+  // an unfocused item processes its focused layout as well, if it still has one
+  if (item->GetFocusedLayout() && item->GetFocusedLayout()->IsInvalid())
+    layouts.push_back(make_pair(item->GetFocusedLayout(), (const CGUIListItem *)item.get()));
+  if (!focused && item->GetLayout() && item->GetLayout()->IsInvalid())
+    layouts.push_back(make_pair(item->GetLayout(), (const CGUIListItem *)item.get()));
+}
+
 void CGUIBaseContainer::Render()
 {
   if (!m_layout || !m_focusedLayout) return;
@@ -812,6 +850,8 @@ void CGUIBaseContainer::FreeResources(bool immediately)
   { // free any static content
     Reset();
   }
+  m_layoutPool.Clear();
+  m_focusedLayoutPool.Clear();
   m_scroller.Stop();
 }
 
@@ -821,6 +861,8 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
   { // free memory of items
     for (iItems it = m_items.begin(); it != m_items.end(); it++)
       (*it)->FreeMemory();
+    m_layoutPool.Clear();
+    m_focusedLayoutPool.Clear();
   }
   // and recalculate the layout
   CalculateLayout();
@@ -1086,17 +1128,33 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   if (keepStart < keepEnd)
   { // remove before keepStart and after keepEnd
     for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleLayouts(m_items[i]);
     for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleLayouts(m_items[i]);
   }
   else
   { // wrapping
     for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleLayouts(m_items[i]);
   }
 }
 
+void CGUIBaseContainer::RecycleLayouts(CGUIListItemPtr &item)
+{
+  CGUIListItemLayout *layout, *focusedLayout;
+  item->ReleaseLayouts(layout, focusedLayout);
+  if (!layout && !focusedLayout)
+    return;
+
+  // keep enough layouts around to cover a page worth of items scrolling into view
+  int cacheBefore, cacheAfter;
+  GetCacheOffsets(cacheBefore, cacheAfter);
+  unsigned int poolSize = m_itemsPerPage + cacheBefore + cacheAfter;
+
+  m_layoutPool.Release(layout, poolSize);
+  m_focusedLayoutPool.Release(focusedLayout, 1);
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
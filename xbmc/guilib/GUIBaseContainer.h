@@ -113,6 +113,9 @@ protected:
   bool OnClick(int actionID);
 
   virtual void ProcessItem(float posX, float posY, CGUIListItemPtr& item, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions);
+  virtual void PrepareItems(int current, float pos, float end);
+  void PrepareItem(CGUIListItemPtr &item, bool focused, CGUIListItemLayout::PrepareList &layouts);
+  void AcquireLayouts(CGUIListItemPtr &item, bool focused);
 
   virtual void Render();
   virtual void RenderItem(float posX, float posY, CGUIListItem *item, bool focused);
@@ -141,6 +144,7 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  void RecycleLayouts(CGUIListItemPtr &item);
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -163,6 +167,8 @@ protected:
 
   CGUIListItemLayout *m_layout;
   CGUIListItemLayout *m_focusedLayout;
+  CGUIListItemLayoutPool m_layoutPool;
+  CGUIListItemLayoutPool m_focusedLayoutPool;
 
   void ScrollToOffset(int offset);
   void SetContainerMoving(int direction);
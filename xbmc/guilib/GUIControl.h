@@ -228,6 +228,11 @@ public:
 
   // push information updates
   virtual void UpdateInfo(const CGUIListItem *item = NULL) {};
+  /*! \brief Fetch the info of a listitem ahead of UpdateInfo(), possibly away from the GUI thread
+   Only info that reads nothing but the item may be fetched here. The next UpdateInfo() for the same item uses it.
+   \sa CGUIInfoLabel::IsListItemOnly
+   */
+  virtual void PrepareInfo(const CGUIListItem *item) {};
   virtual void SetPushUpdates(bool pushUpdates) { m_pushedUpdates = pushUpdates; };
 
   virtual bool IsGroup() const { return false; };
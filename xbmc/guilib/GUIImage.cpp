@@ -32,6 +32,7 @@ CGUIImage::CGUIImage(int parentID, int controlID, float posX, float posY, float
   m_crossFadeTime = 0;
   m_currentFadeTime = 0;
   m_lastRenderTime = 0;
+  m_preparedItem = NULL;
   ControlType = GUICONTROL_IMAGE;
   m_bDynamicResourceAlloc=false;
 }
@@ -44,6 +45,7 @@ CGUIImage::CGUIImage(const CGUIImage &left)
   // defaults
   m_currentFadeTime = 0;
   m_lastRenderTime = 0;
+  m_preparedItem = NULL;
   ControlType = GUICONTROL_IMAGE;
   m_bDynamicResourceAlloc=false;
 }
@@ -64,6 +66,9 @@ void CGUIImage::UpdateVisibility(const CGUIListItem *item)
 
 void CGUIImage::UpdateInfo(const CGUIListItem *item)
 {
+  bool prepared = item && item == m_preparedItem;
+  m_preparedItem = NULL;
+
   if (m_info.IsConstant())
     return; // nothing to do
 
@@ -71,12 +76,27 @@ void CGUIImage::UpdateInfo(const CGUIListItem *item)
   if (HasRendered() && IsAnimating(ANIM_TYPE_HIDDEN) && !IsVisibleFromSkin())
     return;
 
-  if (item)
+  if (prepared)
+  {
+    m_currentFallback = m_preparedFallback;
+    SetFileName(m_preparedTexture);
+  }
+  else if (item)
     SetFileName(m_info.GetItemLabel(item, true, &m_currentFallback));
   else
     SetFileName(m_info.GetLabel(m_parentID, true, &m_currentFallback));
 }
 
+void CGUIImage::PrepareInfo(const CGUIListItem *item)
+{
+  if (m_info.IsConstant() || !m_info.IsListItemOnly())
+    return;
+
+  m_preparedFallback = m_currentFallback;
+  m_preparedTexture = m_info.GetItemLabel(item, true, &m_preparedFallback);
+  m_preparedItem = item;
+}
+
 void CGUIImage::AllocateOnDemand()
 {
   // if we're hidden, we can free our resources and return
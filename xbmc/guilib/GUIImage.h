@@ -78,6 +78,7 @@ public:
   virtual void SetInvalid();
   virtual bool CanFocus() const;
   virtual void UpdateInfo(const CGUIListItem *item = NULL);
+  virtual void PrepareInfo(const CGUIListItem *item);
 
   virtual void SetInfo(const CGUIInfoLabel &info);
   virtual void SetFileName(const CStdString& strFileName, bool setConstant = false);
@@ -115,6 +116,10 @@ protected:
   CStdString m_currentTexture;
   CStdString m_currentFallback;
 
+  const CGUIListItem *m_preparedItem; ///< item m_preparedTexture was fetched for, if any
+  CStdString m_preparedTexture;
+  CStdString m_preparedFallback;
+
   unsigned int m_crossFadeTime;
   unsigned int m_currentFadeTime;
   unsigned int m_lastRenderTime;
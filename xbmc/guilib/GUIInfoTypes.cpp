@@ -201,6 +201,17 @@ bool CGUIInfoLabel::IsConstant() const
   return m_info.size() == 0 || (m_info.size() == 1 && m_info[0].m_info == 0);
 }
 
+bool CGUIInfoLabel::IsListItemOnly() const
+{
+  for (unsigned int i = 0; i < m_info.size(); i++)
+  {
+    int info = m_info[i].m_info;
+    if (info && (info < LISTITEM_START || info >= LISTITEM_PROPERTY_START))
+      return false;
+  }
+  return true;
+}
+
 CStdString CGUIInfoLabel::ReplaceLocalize(const CStdString &label)
 {
   CStdString work(label);
@@ -96,6 +96,13 @@ public:
   bool IsConstant() const;
   bool IsEmpty() const;
 
+  /*!
+   \brief Whether GetItemLabel() reads nothing but the listitem itself.
+   Skin variables and listitem properties are looked up in the info manager, so labels using them aren't.
+   \return true if the label may be fetched for an item away from the GUI thread.
+   */
+  bool IsListItemOnly() const;
+
   const CStdString GetFallback() const { return m_fallback; };
 
   static CStdString GetLabel(const CStdString &label, int contextWindow = 0, bool preferImage = false);
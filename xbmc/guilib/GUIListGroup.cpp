@@ -117,6 +117,12 @@ void CGUIListGroup::UpdateInfo(const CGUIListItem *item)
   }
 }
 
+void CGUIListGroup::PrepareInfo(const CGUIListItem *item)
+{
+  for (iControls it = m_children.begin(); it != m_children.end(); it++)
+    (*it)->PrepareInfo(item);
+}
+
 void CGUIListGroup::EnlargeWidth(float difference)
 {
   // Alters the width of the controls that have an ID of 1
@@ -45,6 +45,7 @@ public:
   virtual void ResetAnimation(ANIMATION_TYPE type);
   virtual void UpdateVisibility(const CGUIListItem *item = NULL);
   virtual void UpdateInfo(const CGUIListItem *item);
+  virtual void PrepareInfo(const CGUIListItem *item);
   virtual void SetInvalid();
 
   void EnlargeWidth(float difference);
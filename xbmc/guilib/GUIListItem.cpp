@@ -386,6 +386,14 @@ CGUIListItemLayout *CGUIListItem::GetFocusedLayout()
   return m_focusedLayout;
 }
 
+void CGUIListItem::ReleaseLayouts(CGUIListItemLayout *&layout, CGUIListItemLayout *&focusedLayout)
+{
+  layout = m_layout;
+  focusedLayout = m_focusedLayout;
+  m_layout = NULL;
+  m_focusedLayout = NULL;
+}
+
 void CGUIListItem::SetInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
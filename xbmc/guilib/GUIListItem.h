@@ -145,6 +145,13 @@ public:
   void SetFocusedLayout(CGUIListItemLayout *layout);
   CGUIListItemLayout *GetFocusedLayout();
 
+  /*! \brief Give up ownership of the layouts without freeing them
+   \param layout [out] the unfocused layout, or NULL if there was none
+   \param focusedLayout [out] the focused layout, or NULL if there was none
+   \sa CGUIListItemLayoutPool
+   */
+  void ReleaseLayouts(CGUIListItemLayout *&layout, CGUIListItemLayout *&focusedLayout);
+
   void FreeIcons();
   void FreeMemory(bool immediately = false);
   void SetInvalid();
@@ -25,9 +25,84 @@
 #include "GUIListLabel.h"
 #include "GUIImage.h"
 #include "utils/XBMCTinyXML.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/CPUInfo.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include <boost/shared_ptr.hpp>
 
 using namespace std;
 
+namespace
+{
+  /*!
+   \brief A set of layouts whose info is being fetched by several threads
+
+   Threads take layouts until none are left, so helper jobs that only start once all layouts have
+   been taken find nothing to do, and the batch outlives the caller for their sake.
+   */
+  class CPrepareBatch
+  {
+  public:
+    CPrepareBatch(const CGUIListItemLayout::PrepareList &layouts) : m_layouts(layouts), m_next(0), m_busy(0) {}
+
+    void Run()
+    {
+      while (true)
+      {
+        unsigned int i;
+        {
+          CSingleLock lock(m_section);
+          if (m_next >= m_layouts.size())
+            return;
+          i = m_next++;
+          m_busy++;
+        }
+        m_layouts[i].first->PrepareInfo(m_layouts[i].second);
+        {
+          CSingleLock lock(m_section);
+          if (--m_busy == 0)
+            m_idle.Set();
+        }
+      }
+    }
+
+    // wait for the layouts other threads are still working on. Only valid once Run() has returned.
+    void Wait()
+    {
+      CSingleLock lock(m_section);
+      while (m_busy)
+      {
+        CSingleExit exit(m_section);
+        m_idle.Wait();
+      }
+    }
+
+  private:
+    CGUIListItemLayout::PrepareList m_layouts;
+    unsigned int m_next;
+    unsigned int m_busy;
+    CCriticalSection m_section;
+    CEvent m_idle;
+  };
+
+  class CPrepareJob : public CJob
+  {
+  public:
+    CPrepareJob(const boost::shared_ptr<CPrepareBatch> &batch) : m_batch(batch) {}
+    virtual const char *GetType() const { return "preparelayouts"; }
+    virtual bool DoWork()
+    {
+      m_batch->Run();
+      return true;
+    }
+
+  private:
+    boost::shared_ptr<CPrepareBatch> m_batch;
+  };
+}
+
 CGUIListItemLayout::CGUIListItemLayout()
 : m_group(0, 0, 0, 0, 0, 0)
 {
@@ -36,6 +111,7 @@ CGUIListItemLayout::CGUIListItemLayout()
   m_condition = 0;
   m_focused = false;
   m_invalidated = true;
+  m_source = NULL;
   m_group.SetPushUpdates(true);
 }
 
@@ -47,6 +123,7 @@ CGUIListItemLayout::CGUIListItemLayout(const CGUIListItemLayout &from)
   m_focused = from.m_focused;
   m_condition = from.m_condition;
   m_invalidated = true;
+  m_source = &from;
 }
 
 CGUIListItemLayout::~CGUIListItemLayout()
@@ -134,6 +211,27 @@ bool CGUIListItemLayout::MoveRight()
   return m_group.MoveRight();
 }
 
+void CGUIListItemLayout::PrepareInfo(const CGUIListItem *item)
+{
+  if (item->IsFileItem())
+    m_group.PrepareInfo(item);
+}
+
+void CGUIListItemLayout::PrepareInfo(const PrepareList &layouts)
+{
+  // a job per few layouts at most, it's not worth waking workers for less
+  static const unsigned int layoutsPerJob = 4;
+  unsigned int jobs = std::min((unsigned int)layouts.size() / layoutsPerJob, (unsigned int)std::max(g_cpuInfo.getCPUCount() - 1, 0));
+  if (!jobs)
+    return; // leave it all to Process()
+
+  boost::shared_ptr<CPrepareBatch> batch(new CPrepareBatch(layouts));
+  for (unsigned int i = 0; i < jobs; i++)
+    CJobManager::GetInstance().AddJob(new CPrepareJob(batch), NULL, CJob::PRIORITY_HIGH);
+  batch->Run();
+  batch->Wait();
+}
+
 bool CGUIListItemLayout::CheckCondition()
 {
   return !m_condition || g_infoManager.GetBoolValue(m_condition);
@@ -219,6 +317,48 @@ void CGUIListItemLayout::FreeResources(bool immediately)
   m_group.FreeResources(immediately);
 }
 
+void CGUIListItemLayout::Recycle()
+{
+  m_group.ResetAnimations();
+  m_group.SetFocusedItem(0);
+  SetInvalid();
+}
+
+CGUIListItemLayout *CGUIListItemLayoutPool::Acquire(const CGUIListItemLayout &source)
+{
+  while (!m_layouts.empty())
+  {
+    CGUIListItemLayout *layout = m_layouts.back();
+    m_layouts.pop_back();
+    if (layout->IsCopyOf(&source))
+    {
+      layout->Recycle();
+      return layout;
+    }
+    // copied from a layout no longer in use (the container has changed layouts)
+    delete layout;
+  }
+  return new CGUIListItemLayout(source);
+}
+
+void CGUIListItemLayoutPool::Release(CGUIListItemLayout *layout, unsigned int maxSize)
+{
+  if (!layout)
+    return;
+  layout->FreeResources();
+  if (m_layouts.size() < maxSize)
+    m_layouts.push_back(layout);
+  else
+    delete layout;
+}
+
+void CGUIListItemLayoutPool::Clear()
+{
+  for (std::vector<CGUIListItemLayout*>::iterator i = m_layouts.begin(); i != m_layouts.end(); ++i)
+    delete *i;
+  m_layouts.clear();
+}
+
 #ifdef _DEBUG
 void CGUIListItemLayout::DumpTextureUse()
 {
@@ -43,8 +43,19 @@ public:
   bool IsAnimating(ANIMATION_TYPE animType);
   void ResetAnimation(ANIMATION_TYPE animType);
   void SetInvalid() { m_invalidated = true; };
+  bool IsInvalid() const { return m_invalidated; };
   void FreeResources(bool immediately = false);
 
+  /*! \brief Prepare a layout released by one item for use by another
+   \sa CGUIListItemLayoutPool
+   */
+  void Recycle();
+
+  /*! \brief Whether this layout was copied from the given layout
+   \sa CGUIListItemLayoutPool
+   */
+  bool IsCopyOf(const CGUIListItemLayout *layout) const { return m_source == layout; };
+
 //#ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const CStdString &nofocusCondition, const CStdString &focusCondition);
 //#endif
@@ -59,6 +70,23 @@ public:
   virtual void DumpTextureUse();
 #endif
   bool CheckCondition();
+
+  /*! \brief Fetch the info of an item ahead of processing an invalid layout for it
+   Only the info that reads nothing but the item is fetched, so this may be called away from the GUI
+   thread as long as nothing else uses the layout meanwhile. The next Process() with the item uses it.
+   \param item the item this layout is about to be processed with
+   \sa CGUIControl::PrepareInfo
+   */
+  void PrepareInfo(const CGUIListItem *item);
+
+  typedef std::vector< std::pair<CGUIListItemLayout*, const CGUIListItem*> > PrepareList;
+
+  /*! \brief Fetch the info of several layouts, spreading the work over the job manager
+   The calling thread takes part in the work and only waits for layouts other threads have already
+   started on, so it is never held up by busy job workers.
+   \param layouts layouts paired with the item they are about to be processed with
+   */
+  static void PrepareInfo(const PrepareList &layouts);
 protected:
   void LoadControl(TiXmlElement *child, CGUIControlGroup *group);
   void Update(CFileItem *item);
@@ -72,5 +100,40 @@ protected:
 
   unsigned int m_condition;
   CGUIInfoBool m_isPlaying;
+
+  const CGUIListItemLayout *m_source; ///< the layout we were copied from, if any
+};
+
+/*!
+ \brief Pool of item layouts released by items that have scrolled out of view
+
+ Containers give each visible item its own copy of their item layout.  Copying the full control tree
+ of a layout every time an item scrolls into view is expensive, so rather than deleting the layouts of
+ items that scroll out of view, containers keep them here for reuse.
+ */
+class CGUIListItemLayoutPool
+{
+public:
+  CGUIListItemLayoutPool() {};
+  CGUIListItemLayoutPool(const CGUIListItemLayoutPool &from) {}; // pooled layouts are never shared
+  CGUIListItemLayoutPool &operator=(const CGUIListItemLayoutPool &from) { Clear(); return *this; };
+  ~CGUIListItemLayoutPool() { Clear(); };
+
+  /*! \brief Fetch a copy of the given layout, reusing a pooled copy where possible
+   \param source the layout to copy
+   \return a copy of source, owned by the caller
+   */
+  CGUIListItemLayout *Acquire(const CGUIListItemLayout &source);
+
+  /*! \brief Return a layout to the pool, freeing its resources
+   \param layout the layout to return, ownership is transferred to the pool
+   \param maxSize the number of layouts to keep - any more are deleted
+   */
+  void Release(CGUIListItemLayout *layout, unsigned int maxSize);
+
+  void Clear();
+
+private:
+  std::vector<CGUIListItemLayout*> m_layouts;
 };
 
@@ -28,6 +28,7 @@ CGUIListLabel::CGUIListLabel(int parentID, int controlID, float posX, float posY
 {
   m_info = info;
   m_alwaysScroll = alwaysScroll;
+  m_preparedItem = NULL;
   // TODO: Remove this "correction"
   if (labelInfo.align & XBFONT_RIGHT)
     m_label.SetMaxRect(m_posX - m_width, m_posY, m_width, m_height);
@@ -89,15 +90,27 @@ void CGUIListLabel::Render()
 
 void CGUIListLabel::UpdateInfo(const CGUIListItem *item)
 {
+  bool prepared = item && item == m_preparedItem;
+  m_preparedItem = NULL;
+
   if (m_info.IsConstant() && !m_bInvalidated)
     return; // nothing to do
 
   if (item)
-    SetLabel(m_info.GetItemLabel(item));
+    SetLabel(prepared ? m_preparedLabel : m_info.GetItemLabel(item));
   else
     SetLabel(m_info.GetLabel(m_parentID, true));
 }
 
+void CGUIListLabel::PrepareInfo(const CGUIListItem *item)
+{
+  if (m_info.IsConstant() || !m_info.IsListItemOnly())
+    return;
+
+  m_preparedLabel = m_info.GetItemLabel(item);
+  m_preparedItem = item;
+}
+
 void CGUIListLabel::SetInvalid()
 {
   m_label.SetInvalid();
@@ -44,6 +44,7 @@ public:
   virtual void Render();
   virtual bool CanFocus() const { return false; };
   virtual void UpdateInfo(const CGUIListItem *item = NULL);
+  virtual void PrepareInfo(const CGUIListItem *item);
   virtual void SetFocus(bool focus);
   virtual void SetInvalid();
   virtual void SetWidth(float width);
@@ -65,4 +66,7 @@ protected:
   CGUILabel     m_label;
   CGUIInfoLabel m_info;
   bool          m_alwaysScroll;
+
+  const CGUIListItem *m_preparedItem; ///< item m_preparedLabel was fetched for, if any
+  CStdString          m_preparedLabel;
 };
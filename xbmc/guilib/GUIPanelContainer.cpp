@@ -22,6 +22,7 @@
 #include "GUIListItem.h"
 #include "GUIInfoManager.h"
 #include "Key.h"
+#include "settings/AdvancedSettings.h"
 
 using namespace std;
 
@@ -62,6 +63,9 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
   pos += (offset - cacheBefore) * m_layout->Size(m_orientation) - m_scroller.GetValue();
   end += cacheAfter * m_layout->Size(m_orientation);
 
+  if (g_advancedSettings.m_guiParallelItemLayout)
+    PrepareItems((offset - cacheBefore) * m_itemsPerRow, pos, end);
+
   int current = (offset - cacheBefore) * m_itemsPerRow;
   int col = 0;
   while (pos < end && m_items.size())
@@ -94,6 +98,30 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+void CGUIPanelContainer::PrepareItems(int current, float pos, float end)
+{
+  CGUIListItemLayout::PrepareList layouts;
+  int col = 0;
+  while (pos < end && m_items.size())
+  {
+    if (current >= (int)m_items.size())
+      break;
+    if (current >= 0)
+    {
+      bool focused = (current == GetOffset() * m_itemsPerRow + GetCursor()) && m_bHasFocus;
+      PrepareItem(m_items[current], focused, layouts);
+    }
+    if (col < m_itemsPerRow - 1)
+      col++;
+    else
+    {
+      pos += m_layout->Size(m_orientation);
+      col = 0;
+    }
+    current++;
+  }
+  CGUIListItemLayout::PrepareInfo(layouts);
+}
 
 void CGUIPanelContainer::Render()
 {
@@ -53,6 +53,7 @@ protected:
   virtual bool MoveLeft(bool wrapAround);
   virtual bool MoveRight(bool wrapAround);
   virtual void Scroll(int amount);
+  virtual void PrepareItems(int current, float pos, float end);
   float AnalogScrollSpeed() const;
   virtual void ValidateOffset();
   virtual void CalculateLayout();
@@ -131,6 +131,9 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
   // load window xml if we don't have it stored yet
+  if (!m_windowXMLRootElement)
+    m_windowXMLRootElement = g_windowManager.TakePreparsedXML(strPath);
+
   if (!m_windowXMLRootElement)
   {
     CXBMCTinyXML xmlDoc;
@@ -55,6 +55,7 @@ void CGUIWindowManager::Initialize()
   m_initialized = true;
 
   LoadNotOnDemandWindows();
+  PreloadWindowXML();
 }
 
 bool CGUIWindowManager::SendMessage(int message, int senderID, int destID, int param1, int param2)
@@ -688,6 +689,7 @@ void CGUIWindowManager::DeInitialize()
     pWindow->FreeResources(true);
   }
   UnloadNotOnDemandWindows();
+  m_xmlCache.Clear();
 
   m_vecMsgTargets.erase( m_vecMsgTargets.begin(), m_vecMsgTargets.end() );
 
@@ -886,6 +888,28 @@ void CGUIWindowManager::LoadNotOnDemandWindows()
   }
 }
 
+void CGUIWindowManager::PreloadWindowXML()
+{
+  if (!g_SkinInfo)
+    return;
+
+  // parse the skin files of windows that are loaded on demand, so that opening them
+  // for the first time doesn't have to hit the disk
+  vector<CStdString> files;
+  CSingleLock lock(g_graphicsContext);
+  for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); it++)
+  {
+    CGUIWindow *pWindow = it->second;
+    if (pWindow->GetLoadType() == CGUIWindow::LOAD_ON_GUI_INIT)
+      continue;
+    CStdString xmlFile = pWindow->GetProperty("xmlfile").asString();
+    if (xmlFile.IsEmpty() || xmlFile.Find("\\") > -1 || xmlFile.Find("/") > -1)
+      continue;
+    files.push_back(g_SkinInfo->GetSkinPath(xmlFile));
+  }
+  m_xmlCache.Preload(files);
+}
+
 void CGUIWindowManager::UnloadNotOnDemandWindows()
 {
   CSingleLock lock(g_graphicsContext);
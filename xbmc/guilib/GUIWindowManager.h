@@ -32,6 +32,7 @@
 #include "IWindowManagerCallback.h"
 #include "IMsgTargetCallback.h"
 #include "DirtyRegionTracker.h"
+#include "GUIWindowXMLCache.h"
 #include "utils/GlobalsHandling.h"
 
 class CGUIDialog;
@@ -135,6 +136,13 @@ public:
   bool IsOverlayAllowed() const;
   void ShowOverlay(CGUIWindow::OVERLAY_STATE state);
   void GetActiveModelessWindows(std::vector<int> &ids);
+
+  /*! \brief Take the preparsed XML for a window file, if the background preload got to it
+   \param file path to the window XML file
+   \return the root element, owned by the caller, or NULL if it hasn't been parsed.
+   \sa CGUIWindowXMLCache
+   */
+  TiXmlElement *TakePreparsedXML(const CStdString &file) { return m_xmlCache.Take(file); };
 #ifdef _DEBUG
   void DumpTextureUse();
 #endif
@@ -142,6 +150,7 @@ private:
   void RenderPass();
 
   void LoadNotOnDemandWindows();
+  void PreloadWindowXML();
   void UnloadNotOnDemandWindows();
   void HideOverlay(CGUIWindow::OVERLAY_STATE state);
   void AddToWindowHistory(int newWindowID);
@@ -174,6 +183,7 @@ private:
   bool m_initialized;
 
   CDirtyRegionTracker m_tracker;
+  CGUIWindowXMLCache  m_xmlCache;
 };
 
 /*!
@@ -0,0 +1,145 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowXMLCache.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+using namespace std;
+
+class CGUIWindowXMLPreloadJob : public CJob
+{
+public:
+  CGUIWindowXMLPreloadJob(CGUIWindowXMLCache *cache, unsigned int generation, const vector<CStdString> &files)
+    : m_cache(cache), m_generation(generation), m_files(files)
+  {
+  }
+
+  virtual const char *GetType() const { return "windowxmlpreload"; }
+
+  virtual bool DoWork()
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    unsigned int parsed = 0;
+    for (unsigned int i = 0; i < m_files.size(); i++)
+    {
+      if (ShouldCancel(i, m_files.size()))
+        return false;
+
+      const CStdString &file = m_files[i];
+      if (!m_cache->IsWanted(m_generation, file))
+        continue;
+
+      CXBMCTinyXML xmlDoc;
+      if (!xmlDoc.LoadFile(file) && !xmlDoc.LoadFile(CStdString(file).ToLower()))
+        continue; // leave it for CGUIWindow::LoadXML to report
+
+      m_cache->Add(m_generation, file, (TiXmlElement*)xmlDoc.RootElement()->Clone());
+      parsed++;
+    }
+    CLog::Log(LOGDEBUG, "%s - parsed %u of %u window files in %ums", __FUNCTION__,
+              parsed, (unsigned int)m_files.size(), XbmcThreads::SystemClockMillis() - start);
+    return true;
+  }
+
+private:
+  CGUIWindowXMLCache *m_cache;
+  unsigned int        m_generation;
+  vector<CStdString>  m_files;
+};
+
+CGUIWindowXMLCache::CGUIWindowXMLCache()
+{
+  m_generation = 0;
+  m_jobID = 0;
+}
+
+CGUIWindowXMLCache::~CGUIWindowXMLCache()
+{
+  // the window manager clears us (cancelling the job) on DeInitialize()
+  for (map<CStdString, TiXmlElement*>::iterator i = m_elements.begin(); i != m_elements.end(); ++i)
+    delete i->second;
+}
+
+void CGUIWindowXMLCache::Preload(const vector<CStdString> &files)
+{
+  Clear();
+  if (files.empty())
+    return;
+
+  CSingleLock lock(m_section);
+  m_jobID = CJobManager::GetInstance().AddJob(new CGUIWindowXMLPreloadJob(this, m_generation, files), this);
+}
+
+void CGUIWindowXMLCache::Clear()
+{
+  CSingleLock lock(m_section);
+  if (m_jobID)
+    CJobManager::GetInstance().CancelJob(m_jobID);
+  m_jobID = 0;
+  // a cancelled job may still be running, so bump the generation to have it ignored
+  m_generation++;
+
+  for (map<CStdString, TiXmlElement*>::iterator i = m_elements.begin(); i != m_elements.end(); ++i)
+    delete i->second;
+  m_elements.clear();
+  m_taken.clear();
+}
+
+TiXmlElement *CGUIWindowXMLCache::Take(const CStdString &file)
+{
+  CSingleLock lock(m_section);
+  m_taken.insert(file);
+
+  map<CStdString, TiXmlElement*>::iterator i = m_elements.find(file);
+  if (i == m_elements.end())
+    return NULL;
+
+  TiXmlElement *root = i->second;
+  m_elements.erase(i);
+  return root;
+}
+
+void CGUIWindowXMLCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  if (jobID == m_jobID)
+    m_jobID = 0;
+}
+
+bool CGUIWindowXMLCache::IsWanted(unsigned int generation, const CStdString &file)
+{
+  CSingleLock lock(m_section);
+  return generation == m_generation && m_taken.find(file) == m_taken.end();
+}
+
+void CGUIWindowXMLCache::Add(unsigned int generation, const CStdString &file, TiXmlElement *root)
+{
+  CSingleLock lock(m_section);
+  if (generation != m_generation || m_taken.find(file) != m_taken.end() || m_elements.find(file) != m_elements.end())
+  {
+    delete root;
+    return;
+  }
+  m_elements.insert(make_pair(file, root));
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+#include "utils/Job.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+class TiXmlElement;
+
+/*!
+ \ingroup winman
+ \brief Cache of window XML documents parsed in the background after skin load.
+
+ Reading and parsing the XML of heavy windows is a significant part of the time taken to open them
+ for the first time.  Once a skin is loaded, the window manager hands the paths of the windows that
+ haven't been loaded yet to Preload(), which parses them on a low priority job.  CGUIWindow::LoadXML
+ then takes the parsed document from the cache instead of reading it from disk.
+
+ Includes are not resolved in the background, as conditional includes depend on the state of
+ the info manager at the time the window is loaded.
+ */
+class CGUIWindowXMLCache : public IJobCallback
+{
+public:
+  CGUIWindowXMLCache();
+  virtual ~CGUIWindowXMLCache();
+
+  /*! \brief Parse the given skin files in the background
+   \param files paths to the window XML files
+   */
+  void Preload(const std::vector<CStdString> &files);
+
+  /*! \brief Cancel any pending preload and drop all cached documents
+   */
+  void Clear();
+
+  /*! \brief Take the parsed root element for the given file out of the cache
+   If the file hasn't been parsed yet, it is removed from the pending preload.
+   \param file path to the window XML file
+   \return the root element, owned by the caller, or NULL if it isn't cached.
+   */
+  TiXmlElement *Take(const CStdString &file);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  friend class CGUIWindowXMLPreloadJob;
+
+  bool IsWanted(unsigned int generation, const CStdString &file);
+  void Add(unsigned int generation, const CStdString &file, TiXmlElement *root);
+
+  CCriticalSection m_section;
+  std::map<CStdString, TiXmlElement*> m_elements;
+  std::set<CStdString> m_taken;
+  unsigned int m_generation;
+  unsigned int m_jobID;
+};
@@ -140,6 +140,33 @@ void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int
     LoadToGPU();
 }
 
+unsigned char* CBaseTexture::LockPixels(unsigned int width, unsigned int height, unsigned int format, bool hasAlpha)
+{
+  if (format & XB_FMT_DXT_MASK && !g_Windowing.SupportsDXT())
+    return NULL; // needs decompressing
+
+  m_hasAlpha = hasAlpha;
+  Allocate(width, height, format);
+
+  // the texture may have been clamped to the maximum texture size
+  if (m_imageWidth != width || m_imageHeight != height)
+    return NULL;
+
+  return m_pixels;
+}
+
+void CBaseTexture::UnlockPixels()
+{
+  unsigned int srcPitch = GetPitch(m_imageWidth);
+  unsigned int dstPitch = GetPitch(m_textureWidth);
+  if (srcPitch != dstPitch)
+  { // spread the rows out, starting from the last so we don't overwrite any we haven't moved yet
+    for (unsigned int y = GetRows(m_imageHeight); y > 0; y--)
+      memmove(m_pixels + (y - 1) * dstPitch, m_pixels + (y - 1) * srcPitch, srcPitch);
+  }
+  ClampToEdge();
+}
+
 void CBaseTexture::ClampToEdge()
 {
   unsigned int imagePitch = GetPitch(m_imageWidth);
@@ -438,7 +465,7 @@ void CBaseTexture::LoadFromImage(ImageInfo &image, bool autoRotate)
   ClampToEdge();
 }
 
-bool CBaseTexture::LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, unsigned char* pixels)
+bool CBaseTexture::LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, const unsigned char* pixels)
 {
   m_imageWidth = m_originalWidth = width;
   m_imageHeight = m_originalHeight = height;
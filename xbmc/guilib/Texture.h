@@ -71,7 +71,7 @@ public:
   static CBaseTexture *LoadFromFileInMemory(unsigned char* buffer, size_t bufferSize, const std::string& mimeType,
                                             unsigned int idealWidth = 0, unsigned int idealHeight = 0);
 
-  bool LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, unsigned char* pixels);
+  bool LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, const unsigned char* pixels);
   bool LoadPaletted(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, const COLOR *palette);
 
   bool HasAlpha() const;
@@ -100,6 +100,19 @@ public:
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
   void ClampToEdge();
 
+  /*! \brief Allocate the texture and return its pixel storage so it can be filled in place
+   The pixels are to be written tightly packed, as they would be passed to LoadFromMemory with a pitch of 0,
+   and UnlockPixels() called once done.
+   \return the buffer to write to, or NULL if the pixels need converting or don't fit, in which case LoadFromMemory should be used.
+   \sa UnlockPixels
+   */
+  unsigned char* LockPixels(unsigned int width, unsigned int height, unsigned int format, bool hasAlpha);
+
+  /*! \brief Finish filling the texture after LockPixels(), laying the rows out at the texture pitch
+   \sa LockPixels
+   */
+  void UnlockPixels();
+
   static unsigned int PadPow2(unsigned int x);
   bool SwapBlueRed(unsigned char *pixels, unsigned int height, unsigned int pitch, unsigned int elements = 4, unsigned int offset=0);
 
@@ -193,51 +193,70 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // use the compressed texture straight from the bundle if it's mapped, else load it
+  const squish::u8 *data = m_XBTFReader.GetData(frame);
+  squish::u8 *buffer = NULL;
+  if (!data)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
+    buffer = new squish::u8[(size_t)frame.GetPackedSize()];
+    if (buffer == NULL)
+    {
+      CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
+      return false;
+    }
 
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
-  {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
+    if (!m_XBTFReader.Load(frame, buffer))
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+      delete[] buffer;
+      return false;
+    }
+    data = buffer;
   }
 
+  // create an xbmc texture
+  CTexture *texture = new CTexture();
+
   // check if it's packed with lzo
   if (frame.IsPacked())
-  { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
+  { // unpack directly into the texture if possible, else via a temporary buffer
+    squish::u8 *pixels = texture->LockPixels(frame.GetWidth(), frame.GetHeight(), frame.GetFormat(), frame.HasAlpha());
+    squish::u8 *unpacked = NULL;
+    if (!pixels || (uint64_t)texture->GetPitch() * texture->GetRows() < frame.GetUnpackedSize())
     {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
+      unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
+      if (unpacked == NULL)
+      {
+        CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
+        delete[] buffer;
+        delete texture;
+        return false;
+      }
+      pixels = unpacked;
     }
     lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
+    if (lzo1x_decompress_safe(data, (lzo_uint)frame.GetPackedSize(), pixels, &s, NULL) != LZO_E_OK ||
         s != frame.GetUnpackedSize())
     {
       CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
       delete[] buffer;
       delete[] unpacked;
+      delete texture;
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
-  }
 
-  // create an xbmc texture
-  *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+    if (unpacked)
+      texture->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), unpacked);
+    else
+      texture->UnlockPixels();
+    delete[] unpacked;
+  }
+  else
+    texture->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), data);
 
   delete[] buffer;
 
+  *ppTexture = texture;
   return true;
 }
 
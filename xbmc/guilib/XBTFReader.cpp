@@ -19,6 +19,9 @@
  */
 
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 #include "XBTFReader.h"
 #include "utils/EndianSwap.h"
 #include "utils/CharsetConverter.h"
@@ -46,6 +49,8 @@
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_data = NULL;
+  m_dataSize = 0;
 }
 
 bool CXBTFReader::IsOpen() const
@@ -123,8 +128,6 @@ bool CXBTFReader::Open(const CStdString& fileName)
     }
 
     m_xbtf.GetFiles().push_back(file);
-
-    m_filesMap[file.GetPath()] = file;
   }
 
   // Sanity check
@@ -135,11 +138,51 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+  // index the files now the list is complete, so the pointers remain valid
+  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
+  for (size_t i = 0; i < files.size(); i++)
+    m_filesMap[files[i].GetPath()] = &files[i];
+
+  // map the bundle so that frames can be read without a copy. If that fails
+  // we fall back to reading them from the file.
+  Map();
+
+  return true;
+}
+
+bool CXBTFReader::Map()
+{
+#ifndef _WIN32
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+    return false;
+
+  void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (data == MAP_FAILED)
+    return false;
+
+  m_data = (unsigned char *)data;
+  m_dataSize = fileStat.st_size;
   return true;
+#else
+  return false;
+#endif
+}
+
+void CXBTFReader::Unmap()
+{
+#ifndef _WIN32
+  if (m_data)
+    munmap(m_data, (size_t)m_dataSize);
+#endif
+  m_data = NULL;
+  m_dataSize = 0;
 }
 
 void CXBTFReader::Close()
 {
+  Unmap();
+
   if (m_file)
   {
     fclose(m_file);
@@ -173,13 +216,23 @@ bool CXBTFReader::Exists(const CStdString& name)
 
 CXBTFFile* CXBTFReader::Find(const CStdString& name)
 {
-  std::map<CStdString, CXBTFFile>::iterator iter = m_filesMap.find(name);
+  std::map<std::string, CXBTFFile*>::iterator iter = m_filesMap.find(name);
   if (iter == m_filesMap.end())
   {
     return NULL;
   }
 
-  return &(iter->second);
+  return iter->second;
+}
+
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (!m_data || frame.GetOffset() + frame.GetPackedSize() > m_dataSize)
+  {
+    return NULL;
+  }
+
+  return m_data + frame.GetOffset();
 }
 
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
@@ -188,6 +241,14 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   {
     return false;
   }
+
+  const unsigned char* data = GetData(frame);
+  if (data)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(__FreeBSD__) || defined(__ANDROID__)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -22,6 +22,7 @@
 #define XBTFREADER_H_
 
 #include <vector>
+#include <string>
 #include <map>
 #include "utils/StdString.h"
 #include "XBTF.h"
@@ -37,13 +38,24 @@ public:
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Get the stored (possibly packed) data of a frame without copying it
+   \param frame the frame to retrieve.
+   \return a pointer into the mapped bundle, or NULL if the bundle isn't mapped, in which case Load() must be used.
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
+  bool Map();
+  void Unmap();
+
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
-  std::map<CStdString, CXBTFFile> m_filesMap;
+  unsigned char* m_data;     ///< bundle mapped into memory, NULL if it couldn't be mapped
+  uint64_t   m_dataSize;
+  std::map<std::string, CXBTFFile*> m_filesMap;
 };
 
 #endif
@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIInfoTypes.h"
+#include "guilib/GUIListItemLayout.h"
+#include "FileItem.h"
+#include "video/VideoInfoTag.h"
+#include "utils/Stopwatch.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+TEST(TestGUIInfoLabel, IsListItemOnly)
+{
+  EXPECT_TRUE(CGUIInfoLabel("some text").IsListItemOnly());
+  EXPECT_TRUE(CGUIInfoLabel("$INFO[ListItem.Label]").IsListItemOnly());
+  EXPECT_TRUE(CGUIInfoLabel("$INFO[ListItem.Label] ($INFO[ListItem.Year])").IsListItemOnly());
+  EXPECT_FALSE(CGUIInfoLabel("$INFO[ListItem.Property(Foo)]").IsListItemOnly());
+  EXPECT_FALSE(CGUIInfoLabel("$INFO[ListItem.Art(fanart)]").IsListItemOnly());
+  EXPECT_FALSE(CGUIInfoLabel("$INFO[ListItem.Label] $INFO[System.Time]").IsListItemOnly());
+}
+
+/* Time fetching the info of a page of invalidated item layouts on the calling thread against
+   spreading it over the job manager, as done with <gui><parallelitemlayout>.  Run with
+     xbmc-test --gtest_also_run_disabled_tests --gtest_filter=TestGUIListItemLayout.*
+ */
+TEST(TestGUIListItemLayout, DISABLED_PrepareInfoBenchmark)
+{
+  static const char *layoutXML =
+    "<itemlayout width=\"400\" height=\"60\">"
+    "  <control type=\"image\"><width>40</width><height>60</height><texture>$INFO[ListItem.Icon]</texture></control>"
+    "  <control type=\"label\"><left>50</left><width>300</width><height>20</height><label>$INFO[ListItem.Label] ($INFO[ListItem.Year])</label></control>"
+    "  <control type=\"label\"><left>50</left><top>20</top><width>300</width><height>20</height><label>$INFO[ListItem.Genre] - $INFO[ListItem.Director]</label></control>"
+    "  <control type=\"label\"><left>50</left><top>40</top><width>300</width><height>20</height><label>$INFO[ListItem.Date] $INFO[ListItem.Size]</label></control>"
+    "  <control type=\"label\"><left>350</left><width>50</width><height>20</height><label>$INFO[ListItem.RatingAndVotes]</label></control>"
+    "  <control type=\"image\"><left>350</left><top>20</top><width>50</width><height>40</height><texture>$INFO[ListItem.Thumb]</texture></control>"
+    "</itemlayout>";
+
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(layoutXML));
+  CGUIListItemLayout source;
+  source.LoadLayout(doc.RootElement(), 0, false);
+
+  // roughly a page of a thumbnail panel
+  const unsigned int count = 48;
+  const unsigned int rounds = 500;
+
+  std::vector<CFileItemPtr> items;
+  std::vector<CGUIListItemLayout*> layouts;
+  CGUIListItemLayout::PrepareList batch;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    CStdString label;
+    label.Format("Movie %u", i);
+    CFileItemPtr item(new CFileItem(label));
+    CVideoInfoTag *tag = item->GetVideoInfoTag();
+    tag->m_strTitle = label;
+    tag->m_iYear = 1950 + i;
+    tag->m_genre.push_back("Drama");
+    tag->m_genre.push_back("Comedy");
+    tag->m_director.push_back("Some Director");
+    tag->m_fRating = 7.5f;
+    tag->m_strVotes = "12,345";
+    item->m_dateTime = CDateTime(2012, 1, 1 + i % 28, 20, 0, 0);
+    item->m_dwSize = 1024 * 1024 * (700 + i);
+    item->SetIconImage("DefaultVideo.png");
+    item->SetArt("thumb", "special://temp/thumb.jpg");
+    items.push_back(item);
+
+    CGUIListItemLayout *layout = new CGUIListItemLayout(source);
+    layouts.push_back(layout);
+    batch.push_back(std::make_pair(layout, (const CGUIListItem *)item.get()));
+  }
+
+  CStopWatch timer;
+  timer.StartZero();
+  for (unsigned int r = 0; r < rounds; r++)
+  {
+    for (unsigned int i = 0; i < count; i++)
+      layouts[i]->PrepareInfo(items[i].get());
+  }
+  float serial = timer.GetElapsedMilliseconds();
+
+  timer.StartZero();
+  for (unsigned int r = 0; r < rounds; r++)
+    CGUIListItemLayout::PrepareInfo(batch);
+  float parallel = timer.GetElapsedMilliseconds();
+
+  std::cout << count << " layouts, " << rounds << " rounds: "
+            << "serial " << serial / rounds << " ms, "
+            << "parallel " << parallel / rounds << " ms per round" << std::endl;
+
+  for (unsigned int i = 0; i < count; i++)
+    delete layouts[i];
+}
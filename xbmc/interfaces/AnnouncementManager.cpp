@@ -19,8 +19,14 @@
  */
 
 #include "AnnouncementManager.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
 #include <stdio.h>
+#include <deque>
+#include <boost/shared_ptr.hpp>
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
@@ -36,7 +42,339 @@
 using namespace std;
 using namespace ANNOUNCEMENT;
 
-#define m_announcers XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_announcers
+// time a system announcement waits for an announcer to handle it
+#define SYSTEM_ANNOUNCEMENT_TIMEOUT 2000
+
+namespace ANNOUNCEMENT
+{
+  typedef boost::shared_ptr<const CVariant> AnnouncementData;
+
+  /*!
+   \brief Delivers the announcements for one announcer on its own thread
+
+   An announcement identical to the last queued one is merged into it. An
+   announcement identical to one delivered less than the coalescing window
+   ago is held back until the window has passed, so that a burst of identical
+   announcements results in at most two deliveries.
+
+   Urgent announcements are never merged, and everything queued before them
+   is delivered without delay, so they keep their order but reach the
+   announcer as soon as possible.
+   */
+  class CAnnouncementDispatcher : public CThread
+  {
+  public:
+    CAnnouncementDispatcher(IAnnouncer *announcer);
+
+    IAnnouncer *GetAnnouncer() const { return m_announcer; }
+
+    /*!
+     \brief Queues an announcement for delivery on the dispatcher's thread
+     \return The sequence number to wait for the delivery with
+     */
+    uint64_t Queue(AnnouncementFlag flag, const char *sender, const char *message, const AnnouncementData &data, bool urgent = false);
+
+    /*!
+     \brief Waits until the announcement with the given sequence number has
+     been delivered, the announcer has been removed or the timeout elapsed
+     */
+    void WaitForDelivery(uint64_t sequence, unsigned int timeout);
+
+    /*!
+     \brief Delivers an announcement on the calling thread
+     */
+    void Deliver(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
+    /*!
+     \brief Drops the queued announcements and stops the thread without
+     waiting for it. Waits for an announcement that is being delivered, the
+     announcer is not called anymore once this returns.
+     */
+    void Remove();
+
+    /*!
+     \brief Adds the counters of this dispatcher to the given statistics
+     */
+    void AddStatistics(AnnouncementStatistics &statistics);
+
+  protected:
+    virtual void Process();
+
+  private:
+    struct Announcement
+    {
+      bool Equals(const Announcement &other) const;
+
+      AnnouncementFlag flag;
+      std::string sender;
+      std::string message;
+      AnnouncementData data;
+      unsigned int time;  ///< time the announcement has been queued or delivered
+      unsigned int delay; ///< time after queueing before it may be delivered
+      uint64_t sequence;
+      bool urgent;
+    };
+
+    IAnnouncer *m_announcer;
+    CCriticalSection m_deliverySection; ///< held while the announcer is called
+    CCriticalSection m_queueSection;
+    CEvent m_queueEvent;
+    CEvent m_deliveredEvent;
+    std::deque<Announcement> m_queue;
+    std::deque<Announcement> m_recent;
+    unsigned int m_lastDelivery;
+    unsigned int m_urgent;      ///< number of queued urgent announcements
+    uint64_t m_sequence;        ///< sequence number of the last queued announcement
+    uint64_t m_delivered;       ///< sequence number of the last delivered announcement
+    bool m_removed;
+    AnnouncementStatistics m_counters;
+  };
+}
+
+bool CAnnouncementDispatcher::Announcement::Equals(const Announcement &other) const
+{
+  // CVariant does not consider two nulls equal, most announcements come without data
+  return flag == other.flag && message == other.message && sender == other.sender &&
+         (data == other.data || (data->isNull() && other.data->isNull()) || *data == *other.data);
+}
+
+CAnnouncementDispatcher::CAnnouncementDispatcher(IAnnouncer *announcer)
+  : CThread("CAnnouncementDispatcher"), m_deliveredEvent(true)
+{
+  m_announcer = announcer;
+  m_lastDelivery = 0;
+  m_urgent = 0;
+  m_sequence = 0;
+  m_delivered = 0;
+  m_removed = false;
+}
+
+uint64_t CAnnouncementDispatcher::Queue(AnnouncementFlag flag, const char *sender, const char *message, const AnnouncementData &data, bool urgent /* = false */)
+{
+  Announcement announcement;
+  announcement.flag = flag;
+  announcement.sender = sender;
+  announcement.message = message;
+  announcement.data = data;
+  announcement.time = XbmcThreads::SystemClockMillis();
+  announcement.delay = 0;
+  announcement.urgent = urgent;
+
+  CSingleLock lock(m_queueSection);
+  if (m_removed)
+    return 0;
+
+  m_counters.announced++;
+
+  // the thread is started with the first announcement as announcers are
+  // also added during static initialization
+  if (!IsRunning())
+    Create();
+
+  unsigned int window = g_advancedSettings.m_announceCoalesceWindow;
+  if (window > 0 && !urgent)
+  {
+    // only the last one can be merged, anything else would change the order
+    // in which the announcer sees different announcements
+    if (!m_queue.empty() && !m_queue.back().urgent && m_queue.back().Equals(announcement))
+    {
+      m_counters.merged++;
+      return m_queue.back().sequence;
+    }
+
+    while (!m_recent.empty() && announcement.time - m_recent.front().time >= window)
+      m_recent.pop_front();
+
+    for (std::deque<Announcement>::reverse_iterator it = m_recent.rbegin(); it != m_recent.rend(); ++it)
+    {
+      if (it->Equals(announcement))
+      {
+        announcement.delay = window - (announcement.time - it->time);
+        break;
+      }
+    }
+  }
+
+  if (m_queue.size() >= g_advancedSettings.m_announceQueueSize)
+  {
+    // urgent announcements are waited for, so they are never dropped
+    for (std::deque<Announcement>::iterator it = m_queue.begin(); it != m_queue.end(); ++it)
+    {
+      if (!it->urgent)
+      {
+        m_queue.erase(it);
+        m_counters.dropped++;
+        break;
+      }
+    }
+  }
+
+  announcement.sequence = ++m_sequence;
+  if (urgent)
+    m_urgent++;
+
+  m_queue.push_back(announcement);
+  m_queueEvent.Set();
+  return announcement.sequence;
+}
+
+void CAnnouncementDispatcher::WaitForDelivery(uint64_t sequence, unsigned int timeout)
+{
+  // the announcement can't be delivered before the announcement the thread
+  // is currently handling returns
+  if (IsCurrentThread())
+    return;
+
+  XbmcThreads::EndTime endTime(timeout);
+  CSingleLock lock(m_queueSection);
+  while (!m_removed && m_delivered < sequence)
+  {
+    if (endTime.IsTimePast())
+    {
+      CLog::Log(LOGWARNING, "CAnnouncementDispatcher - Announcer did not handle an announcement within %u ms", timeout);
+      return;
+    }
+
+    m_deliveredEvent.Reset();
+    lock.Leave();
+    m_deliveredEvent.WaitMSec(endTime.MillisLeft());
+    lock.Enter();
+  }
+}
+
+void CAnnouncementDispatcher::Deliver(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  CSingleLock delivery(m_deliverySection);
+  {
+    CSingleLock lock(m_queueSection);
+    if (m_removed)
+      return;
+  }
+
+  m_announcer->Announce(flag, sender, message, data);
+}
+
+void CAnnouncementDispatcher::Remove()
+{
+  {
+    CSingleLock lock(m_queueSection);
+    m_removed = true;
+    m_counters.dropped += m_queue.size();
+    m_queue.clear();
+    m_urgent = 0;
+    m_deliveredEvent.Set();
+  }
+
+  StopThread(false);
+
+  // the caller destroys the announcer next, so an announcement that is being
+  // delivered has to be waited for, however long it takes. An announcer that
+  // removes itself while handling one already holds the section.
+  CSingleLock delivery(m_deliverySection);
+}
+
+void CAnnouncementDispatcher::AddStatistics(AnnouncementStatistics &statistics)
+{
+  CSingleLock lock(m_queueSection);
+  statistics.announced += m_counters.announced;
+  statistics.delivered += m_counters.delivered;
+  statistics.merged    += m_counters.merged;
+  statistics.dropped   += m_counters.dropped;
+}
+
+void CAnnouncementDispatcher::Process()
+{
+  while (!m_bStop)
+  {
+    Announcement announcement;
+    int wait = -1;
+    {
+      CSingleLock lock(m_queueSection);
+      if (!m_queue.empty() && !m_removed)
+      {
+        unsigned int now = XbmcThreads::SystemClockMillis();
+        const Announcement &front = m_queue.front();
+
+        // announcements are delivered in order, so a held back announcement
+        // holds back everything queued after it as well, unless an urgent
+        // one is waiting behind it
+        wait = 0;
+        if (m_urgent == 0)
+        {
+          unsigned int elapsed = now - front.time;
+          wait = front.delay > elapsed ? front.delay - elapsed : 0;
+
+          unsigned int rate = g_advancedSettings.m_announceRateLimit;
+          if (rate > 0 && m_counters.delivered > 0)
+          {
+            unsigned int interval = 1000 / rate;
+            unsigned int sinceLast = now - m_lastDelivery;
+            if (sinceLast < interval && (int)(interval - sinceLast) > wait)
+              wait = interval - sinceLast;
+          }
+        }
+
+        if (wait == 0)
+        {
+          announcement = front;
+          m_queue.pop_front();
+          if (announcement.urgent)
+            m_urgent--;
+        }
+      }
+    }
+
+    if (wait != 0)
+    {
+      AbortableWait(m_queueEvent, wait);
+      continue;
+    }
+
+    {
+      // Remove() may have come in since the announcement has been taken off
+      // the queue, it waits for the section before the announcer goes away
+      CSingleLock delivery(m_deliverySection);
+      {
+        CSingleLock lock(m_queueSection);
+        if (m_removed)
+        {
+          m_counters.dropped++;
+          break;
+        }
+      }
+      m_announcer->Announce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), *announcement.data);
+    }
+
+    CSingleLock lock(m_queueSection);
+    m_delivered = announcement.sequence;
+    m_deliveredEvent.Set();
+    m_lastDelivery = XbmcThreads::SystemClockMillis();
+    m_counters.delivered++;
+    if (g_advancedSettings.m_announceCoalesceWindow > 0)
+    {
+      announcement.time = m_lastDelivery;
+      m_recent.push_back(announcement);
+    }
+  }
+}
+
+CAnnouncementManager::Globals::~Globals()
+{
+  for (unsigned int i = 0; i < m_dispatchers.size(); i++)
+  {
+    m_dispatchers[i]->StopThread(true);
+    delete m_dispatchers[i];
+  }
+
+  for (unsigned int i = 0; i < m_retired.size(); i++)
+  {
+    m_retired[i]->StopThread(true);
+    delete m_retired[i];
+  }
+}
+
+#define m_dispatchers XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_dispatchers
+#define m_retired XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_retired
 #define m_critSection XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_critSection
 
 void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
@@ -44,8 +382,10 @@ void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
   if (!listener)
     return;
 
+  CAnnouncementDispatcher *dispatcher = new CAnnouncementDispatcher(listener);
+
   CSingleLock lock (m_critSection);
-  m_announcers.push_back(listener);
+  m_dispatchers.push_back(dispatcher);
 }
 
 void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
@@ -53,15 +393,44 @@ void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
   if (!listener)
     return;
 
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
+  CAnnouncementDispatcher *dispatcher = NULL;
   {
-    if (m_announcers[i] == listener)
+    CSingleLock lock (m_critSection);
+    for (unsigned int i = 0; i < m_dispatchers.size(); i++)
     {
-      m_announcers.erase(m_announcers.begin() + i);
-      return;
+      if (m_dispatchers[i]->GetAnnouncer() == listener)
+      {
+        // callers may hold locks the dispatcher's thread is waiting for, so
+        // the thread is only joined on destruction
+        dispatcher = m_dispatchers[i];
+        m_retired.push_back(dispatcher);
+        m_dispatchers.erase(m_dispatchers.begin() + i);
+        break;
+      }
     }
   }
+
+  if (!dispatcher)
+    return;
+
+  dispatcher->Remove();
+
+  AnnouncementStatistics statistics;
+  dispatcher->AddStatistics(statistics);
+  CLog::Log(LOGDEBUG, "CAnnouncementManager - Removed announcer: %u announcements, %u delivered, %u merged, %u dropped",
+            statistics.announced, statistics.delivered, statistics.merged, statistics.dropped);
+}
+
+AnnouncementStatistics CAnnouncementManager::GetStatistics()
+{
+  CSingleLock lock (m_critSection);
+  AnnouncementStatistics statistics;
+  for (unsigned int i = 0; i < m_dispatchers.size(); i++)
+    m_dispatchers[i]->AddStatistics(statistics);
+  for (unsigned int i = 0; i < m_retired.size(); i++)
+    m_retired[i]->AddStatistics(statistics);
+
+  return statistics;
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message)
@@ -74,8 +443,42 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
   CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
-    m_announcers[i]->Announce(flag, sender, message, data);
+
+  if (!g_advancedSettings.m_announceAsynchronous)
+  {
+    // announcers may remove themselves while being called
+    std::vector<CAnnouncementDispatcher *> dispatchers = m_dispatchers;
+    for (unsigned int i = 0; i < dispatchers.size(); i++)
+      dispatchers[i]->Deliver(flag, sender, message, data);
+    return;
+  }
+
+  if (m_dispatchers.empty())
+    return;
+
+  // the data is shared by all queues
+  AnnouncementData shared(new CVariant(data));
+
+  // system announcements (quit, sleep, wake...) have to reach the announcers
+  // before the caller goes on. They are queued behind everything announced
+  // before so the order is kept and each announcer is only ever called from
+  // its own thread.
+  if (flag == System)
+  {
+    std::vector<std::pair<CAnnouncementDispatcher *, uint64_t> > pending;
+    for (unsigned int i = 0; i < m_dispatchers.size(); i++)
+      pending.push_back(std::make_pair(m_dispatchers[i], m_dispatchers[i]->Queue(flag, sender, message, shared, true)));
+
+    // dispatchers are only deleted on destruction, so they can be waited
+    // for without the lock the announcers might need
+    lock.Leave();
+    for (unsigned int i = 0; i < pending.size(); i++)
+      pending[i].first->WaitForDelivery(pending[i].second, SYSTEM_ANNOUNCEMENT_TIMEOUT);
+    return;
+  }
+
+  for (unsigned int i = 0; i < m_dispatchers.size(); i++)
+    m_dispatchers[i]->Queue(flag, sender, message, shared);
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item)
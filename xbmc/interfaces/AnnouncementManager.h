@@ -27,6 +27,18 @@
 
 namespace ANNOUNCEMENT
 {
+  class CAnnouncementDispatcher;
+
+  struct AnnouncementStatistics
+  {
+    AnnouncementStatistics() : announced(0), delivered(0), merged(0), dropped(0) { }
+
+    unsigned int announced; ///< announcements handed to the announcers' queues
+    unsigned int delivered; ///< announcements delivered from the queues
+    unsigned int merged;    ///< announcements merged into an identical queued one
+    unsigned int dropped;   ///< announcements dropped because a queue was full or its announcer was removed
+  };
+
   class CAnnouncementManager
   {
   public:
@@ -34,17 +46,33 @@ namespace ANNOUNCEMENT
      class Globals
      {
      public:
+       ~Globals();
+
        CCriticalSection m_critSection;
-       std::vector<IAnnouncer *> m_announcers;
+       std::vector<CAnnouncementDispatcher *> m_dispatchers;
+       std::vector<CAnnouncementDispatcher *> m_retired; ///< removed dispatchers, joined on destruction
      };
 
     static void AddAnnouncer(IAnnouncer *listener);
+
+    /*!
+     \brief Stops delivering announcements to the given announcer
+
+     Queued announcements are dropped. An announcement that is being
+     delivered is waited for, so the announcer may be destroyed once this
+     returns. The caller must not hold a lock the announcer takes while
+     handling an announcement.
+     */
     static void RemoveAnnouncer(IAnnouncer *listener);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CVariant &data);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, CVariant &data);
-  private:
+
+    /*!
+     \brief Returns the counters of all announcers (including removed ones)
+     */
+    static AnnouncementStatistics GetStatistics();
   };
 }
 
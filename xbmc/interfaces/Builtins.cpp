@@ -54,6 +54,7 @@
 #include "Util.h"
 #include "URL.h"
 #include "music/MusicDatabase.h"
+#include "music/infoscanner/ReplayGainScanner.h"
 
 #include "filesystem/PluginDirectory.h"
 #ifdef HAS_FILESYSTEM_RAR
@@ -169,6 +170,7 @@ const BUILT_IN commands[] = {
   { "SetFocus",                   true,   "Change current focus to a different control id" },
   { "UpdateLibrary",              true,   "Update the selected library (music or video)" },
   { "CleanLibrary",               true,   "Clean the video/music library" },
+  { "AnalyzeReplayGain",          false,  "Measure the loudness of all music library songs without ReplayGain values" },
   { "ExportLibrary",              true,   "Export the video/music library" },
   { "PageDown",                   true,   "Send a page down event to the pagecontrol with given id" },
   { "PageUp",                     true,   "Send a page up event to the pagecontrol with given id" },
@@ -1320,6 +1322,13 @@ int CBuiltins::Execute(const CStdString& execString)
         CLog::Log(LOGERROR, "XBMC.CleanLibrary is not possible while scanning for media info");
     }
   }
+  else if (execute.Equals("analyzereplaygain"))
+  {
+    if (MUSIC_INFO::CReplayGainScanner::Get().IsScanning())
+      MUSIC_INFO::CReplayGainScanner::Get().Stop();
+    else
+      MUSIC_INFO::CReplayGainScanner::Get().Start();
+  }
   else if (execute.Equals("exportlibrary"))
   {
     int iHeading = 647;
@@ -88,7 +88,7 @@ JSONRPC_STATUS CAudioLibrary::GetArtists(const CStdString &method, ITransportLay
   int size = items.Size();
   if (items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("artistid", false, "artists", items, param, result, size, false);
+  HandleFileItemList("artistid", false, "artists", items, param, result, size, false, true);
   return OK;
 }
 
@@ -164,7 +164,7 @@ JSONRPC_STATUS CAudioLibrary::GetAlbums(const CStdString &method, ITransportLaye
   int size = items.Size();
   if (items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("albumid", false, "albums", items, parameterObject, result, size, false);
+  HandleFileItemList("albumid", false, "albums", items, parameterObject, result, size, false, true);
 
   return OK;
 }
@@ -246,7 +246,7 @@ JSONRPC_STATUS CAudioLibrary::GetSongs(const CStdString &method, ITransportLayer
   int size = items.Size();
   if (items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("songid", true, "songs", items, parameterObject, result, size, false);
+  HandleFileItemList("songid", true, "songs", items, parameterObject, result, size, false, true);
 
   return OK;
 }
@@ -298,7 +298,7 @@ JSONRPC_STATUS CAudioLibrary::GetRecentlyAddedAlbums(const CStdString &method, I
   if (ret != OK)
     return ret;
 
-  HandleFileItemList("albumid", false, "albums", items, parameterObject, result);
+  HandleFileItemList("albumid", false, "albums", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -320,7 +320,7 @@ JSONRPC_STATUS CAudioLibrary::GetRecentlyAddedSongs(const CStdString &method, IT
   if (ret != OK)
     return ret;
 
-  HandleFileItemList("songid", true, "songs", items, parameterObject, result);
+  HandleFileItemList("songid", true, "songs", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -349,7 +349,7 @@ JSONRPC_STATUS CAudioLibrary::GetRecentlyPlayedAlbums(const CStdString &method,
   if (ret != OK)
     return ret;
 
-  HandleFileItemList("albumid", false, "albums", items, parameterObject, result);
+  HandleFileItemList("albumid", false, "albums", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -367,7 +367,7 @@ JSONRPC_STATUS CAudioLibrary::GetRecentlyPlayedSongs(const CStdString &method, I
   if (ret != OK)
     return ret;
 
-  HandleFileItemList("songid", true, "songs", items, parameterObject, result);
+  HandleFileItemList("songid", true, "songs", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -385,7 +385,7 @@ JSONRPC_STATUS CAudioLibrary::GetGenres(const CStdString &method, ITransportLaye
   for (unsigned int i = 0; i < (unsigned int)items.Size(); i++)
     items[i]->GetMusicInfoTag()->SetTitle(items[i]->GetLabel());
 
-  HandleFileItemList("genreid", false, "genres", items, parameterObject, result);
+  HandleFileItemList("genreid", false, "genres", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -22,6 +22,7 @@
 #include <string.h>
 
 #include "FileItemHandler.h"
+#include "JSONRPCResponseStream.h"
 #include "PlaylistOperations.h"
 #include "AudioLibrary.h"
 #include "VideoLibrary.h"
@@ -194,12 +195,66 @@ void CFileItemHandler::FillDetails(const ISerializable *info, const CFileItemPtr
   }
 }
 
-void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit /* = true */)
+class CFileItemHandler::CDeferredItemList : public IDeferredList
 {
-  HandleFileItemList(ID, allowFile, resultname, items, parameterObject, result, items.Size(), sortLimit);
+public:
+  CDeferredItemList(const char *ID, bool allowFile, const CFileItemList &items, int start, int end, const CVariant &parameterObject, const std::set<std::string> &fields)
+    : m_hasID(ID != NULL),
+      m_ID(ID != NULL ? ID : ""),
+      m_allowFile(allowFile),
+      m_parameters(parameterObject),
+      m_fields(fields),
+      m_thumbLoader(NULL)
+  {
+    for (int i = start; i < end; i++)
+      m_items.push_back(items.Get(i));
+  }
+
+  virtual ~CDeferredItemList()
+  {
+    delete m_thumbLoader;
+  }
+
+  virtual unsigned int Size() const
+  {
+    return m_items.size();
+  }
+
+  virtual void Get(unsigned int index, CVariant &item)
+  {
+    // the thumb loader is only needed once the items are serialized
+    if (index == 0 && m_thumbLoader == NULL)
+    {
+      if (m_items[0]->HasVideoInfoTag())
+        m_thumbLoader = new CVideoThumbLoader();
+      else if (m_items[0]->HasMusicInfoTag())
+        m_thumbLoader = new CMusicThumbLoader();
+
+      if (m_thumbLoader != NULL)
+        m_thumbLoader->Initialize();
+    }
+
+    CVariant result;
+    HandleFileItem(m_hasID ? m_ID.c_str() : NULL, m_allowFile, "item", m_items[index], m_parameters, m_fields, result, false, m_thumbLoader);
+    item.swap(result["item"]);
+  }
+
+private:
+  bool m_hasID;
+  std::string m_ID;
+  bool m_allowFile;
+  std::vector<CFileItemPtr> m_items;
+  CVariant m_parameters;
+  std::set<std::string> m_fields;
+  CThumbLoader *m_thumbLoader;
+};
+
+void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit /* = true */, bool stream /* = false */)
+{
+  HandleFileItemList(ID, allowFile, resultname, items, parameterObject, result, items.Size(), sortLimit, stream);
 }
 
-void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
+void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */, bool stream /* = false */)
 {
   int start, end;
   HandleLimits(parameterObject, result, size, start, end);
@@ -212,6 +267,22 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     end = items.Size();
   }
 
+  std::set<std::string> fields;
+  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
+  {
+    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
+      fields.insert(field->asString());
+  }
+
+  if (stream && end - start > 0)
+  {
+    CDeferredItemList *list = new CDeferredItemList(ID, allowFile, items, start, end, parameterObject, fields);
+    if (CJSONRPCResponseStream::Defer(result, resultname, list))
+      return;
+
+    delete list;
+  }
+
   CThumbLoader *thumbLoader = NULL;
   if (end - start > 0)
   {
@@ -224,13 +295,6 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       thumbLoader->Initialize();
   }
 
-  std::set<std::string> fields;
-  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
-  {
-    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
-      fields.insert(field->asString());
-  }
-
   for (int i = start; i < end; i++)
   {
     CVariant object;
@@ -26,8 +26,10 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/Variant.h"
 
 using namespace ANNOUNCEMENT;
@@ -35,6 +37,8 @@ using namespace JSONRPC;
 using namespace std;
 
 bool CJSONRPC::m_initialized = false;
+map<string, MethodStatistics> CJSONRPC::m_statistics;
+CCriticalSection CJSONRPC::m_statisticsSection;
 
 void CJSONRPC::Initialize()
 {
@@ -97,6 +101,10 @@ void CJSONRPC::Initialize()
 
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
+
+  // resolve all type references and prepare the
+  // definitions for validating the method parameters
+  CJSONServiceDescription::Compile();
   
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
@@ -105,9 +113,35 @@ void CJSONRPC::Initialize()
 void CJSONRPC::Cleanup()
 {
   CJSONServiceDescription::Cleanup();
+
+  CSingleLock lock(m_statisticsSection);
+  for (map<string, MethodStatistics>::const_iterator it = m_statistics.begin(); it != m_statistics.end(); it++)
+    CLog::Log(LOGDEBUG, "JSONRPC: %s called %u times (check: %"PRIu64" us, call: %"PRIu64" us)",
+              it->first.c_str(), it->second.calls, it->second.checkTime, it->second.callTime);
+  m_statistics.clear();
+
   m_initialized = false;
 }
 
+void CJSONRPC::GetMethodStatistics(map<string, MethodStatistics> &statistics)
+{
+  CSingleLock lock(m_statisticsSection);
+  statistics = m_statistics;
+}
+
+void CJSONRPC::updateStatistics(const string &method, int64_t checkStart, int64_t callStart, int64_t callEnd)
+{
+  int64_t frequency = CurrentHostFrequency();
+  if (frequency <= 0)
+    return;
+
+  CSingleLock lock(m_statisticsSection);
+  MethodStatistics &statistics = m_statistics[method];
+  statistics.calls++;
+  statistics.checkTime += (callStart - checkStart) * 1000000 / frequency;
+  statistics.callTime += (callEnd - callStart) * 1000000 / frequency;
+}
+
 JSONRPC_STATUS CJSONRPC::Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result)
 {
   return CJSONServiceDescription::Print(result, transport, client,
@@ -223,11 +257,11 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *tr
 
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CVariant outputroot, result;
   bool hasResponse = false;
 
   //CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
-  inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
+  CVariant inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
   if (!inputroot.isNull())
   {
     if (inputroot.isArray())
@@ -235,7 +269,7 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
       if (inputroot.size() <= 0)
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
+        BuildResponse(inputroot, InvalidRequest, result, outputroot);
         hasResponse = true;
       }
       else
@@ -245,7 +279,8 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            outputroot.append(CVariant());
+            outputroot[outputroot.size() - 1].swap(response);
             hasResponse = true;
           }
         }
@@ -257,7 +292,7 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
   else
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
-    BuildResponse(inputroot, ParseError, CVariant(), outputroot);
+    BuildResponse(inputroot, ParseError, result, outputroot);
     hasResponse = true;
   }
 
@@ -265,7 +300,73 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
   return str;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+CJSONRPCResponseStream* CJSONRPC::MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client)
+{
+  CJSONRPCResponseStream *stream = new CJSONRPCResponseStream(g_advancedSettings.m_jsonOutputCompact);
+  DeferredLists deferred;
+  bool hasResponse = false;
+
+  CVariant inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
+  if (!inputroot.isNull())
+  {
+    if (inputroot.isArray())
+    {
+      if (inputroot.size() <= 0)
+      {
+        CVariant result, response;
+        CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
+        BuildResponse(inputroot, InvalidRequest, result, response);
+        stream->AddResponse(response, deferred);
+        hasResponse = true;
+      }
+      else
+      {
+        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
+        {
+          CVariant response;
+          if (HandleMethodCall(*itr, response, transport, client, &deferred))
+          {
+            if (!hasResponse)
+              stream->StartBatch();
+
+            stream->AddResponse(response, deferred);
+            hasResponse = true;
+          }
+        }
+
+        if (hasResponse)
+          stream->EndBatch();
+      }
+    }
+    else
+    {
+      CVariant response;
+      if (HandleMethodCall(inputroot, response, transport, client, &deferred))
+      {
+        stream->AddResponse(response, deferred);
+        hasResponse = true;
+      }
+    }
+  }
+  else
+  {
+    CVariant result, response;
+    CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
+    BuildResponse(inputroot, ParseError, result, response);
+    stream->AddResponse(response, deferred);
+    hasResponse = true;
+  }
+
+  if (!hasResponse)
+  {
+    delete stream;
+    return NULL;
+  }
+
+  return stream;
+}
+
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, DeferredLists *deferred /* = NULL */)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -282,8 +383,19 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     //CLog::Log(LOGDEBUG, "JSONRPC: Calling %s", methodName.c_str());
+    int64_t checkStart = CurrentHostCounter();
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName, request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      if (deferred != NULL && !isNotification)
+        CJSONRPCResponseStream::BeginCall(result, *deferred);
+
+      int64_t callStart = CurrentHostCounter();
       errorCode = method(methodName, transport, client, params, result);
+      updateStatistics(methodName, checkStart, callStart, CurrentHostCounter());
+
+      if (deferred != NULL && !isNotification)
+        CJSONRPCResponseStream::EndCall();
+    }
     else
       result = params;
   }
@@ -303,7 +415,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isObject() && request.isMember("id") ? request["id"] : CVariant();
@@ -311,7 +423,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      response["result"].swap(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -324,7 +436,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"].swap(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
@@ -24,13 +24,34 @@
 #include <stdio.h>
 #include <string>
 
+#include "JSONRPCResponseStream.h"
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 #include "interfaces/IAnnouncer.h"
+#include "threads/CriticalSection.h"
 #include "utils/StdString.h"
 
 namespace JSONRPC
 {
+  /*!
+   \ingroup jsonrpc
+   \brief Accumulated timings of a JSON-RPC method
+
+   All times are in microseconds. The check time covers the
+   validation of the parameters against the method's schema
+   and the call time covers the execution of the method.
+   */
+  typedef struct MethodStatistics
+  {
+    MethodStatistics()
+      : calls(0), checkTime(0), callTime(0)
+    { }
+
+    unsigned int calls;
+    uint64_t checkTime;
+    uint64_t callTime;
+  } MethodStatistics;
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -64,6 +85,20 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request and returns the response as a stream
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \return Stream of the JSON-RPC response(s) to be sent back to the client
+     or NULL if there is no response. The caller has to delete the stream.
+
+     Same as MethodCall() but the item lists returned by the library methods
+     are only serialized while the returned stream is read instead of being
+     built up as one CVariant tree and one string first.
+     */
+    static CJSONRPCResponseStream* MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client);
+
     static JSONRPC_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -71,14 +106,26 @@ namespace JSONRPC
     static JSONRPC_STATUS GetConfiguration(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS SetConfiguration(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS NotifyAll(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
+
+    /*!
+     \brief Gets the accumulated timings of all methods
+     that have been called since the handler was initialized
+     \param statistics Map of method names and their timings
+     */
+    static void GetMethodStatistics(std::map<std::string, MethodStatistics> &statistics);
   
   private:
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, DeferredLists *deferred = NULL);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    // result is moved into response
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response);
+
+    static void updateStatistics(const std::string &method, int64_t checkStart, int64_t callStart, int64_t callEnd);
 
     static bool m_initialized;
+    static std::map<std::string, MethodStatistics> m_statistics;
+    static CCriticalSection m_statisticsSection;
   };
 }
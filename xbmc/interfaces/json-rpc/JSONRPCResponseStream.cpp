@@ -0,0 +1,224 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JSONRPCResponseStream.h"
+#include "threads/ThreadLocal.h"
+
+using namespace JSONRPC;
+
+typedef struct
+{
+  const CVariant *result;
+  DeferredLists *lists;
+} DeferContext;
+
+static XbmcThreads::ThreadLocal<DeferContext> deferContext;
+
+CJSONRPCResponseStream::CJSONRPCResponseStream(bool compact)
+  : m_writer(compact),
+    m_listIndex(0)
+{ }
+
+CJSONRPCResponseStream::~CJSONRPCResponseStream()
+{
+  for (std::deque<Step>::iterator it = m_steps.begin(); it != m_steps.end(); ++it)
+    delete it->list;
+}
+
+void CJSONRPCResponseStream::StartBatch()
+{
+  AddStep(StepArrayStart);
+}
+
+void CJSONRPCResponseStream::EndBatch()
+{
+  AddStep(StepArrayEnd);
+}
+
+void CJSONRPCResponseStream::AddResponse(CVariant &response, DeferredLists &lists)
+{
+  if (lists.empty() || !response.isObject() ||
+      !response.isMember("result") || !response["result"].isObject())
+  {
+    FreeLists(lists);
+    AddStep(StepValue).value.swap(response);
+    return;
+  }
+
+  AddStep(StepObjectStart);
+  for (CVariant::iterator_map itr = response.begin_map(); itr != response.end_map(); itr++)
+  {
+    AddStep(StepKey).key = itr->first;
+    if (itr->first != "result")
+    {
+      AddStep(StepValue).value.swap(itr->second);
+      continue;
+    }
+
+    // merge the deferred lists into the result in the order
+    // CVariant would have sorted them into
+    CVariant &result = itr->second;
+    CVariant::iterator_map value = result.begin_map();
+    DeferredLists::iterator list = lists.begin();
+
+    AddStep(StepObjectStart);
+    while (value != result.end_map() || list != lists.end())
+    {
+      if (list == lists.end() || (value != result.end_map() && value->first < list->first))
+      {
+        AddStep(StepKey).key = value->first;
+        AddStep(StepValue).value.swap(value->second);
+        value++;
+      }
+      else
+      {
+        if (value != result.end_map() && value->first == list->first)
+          value++;
+
+        AddStep(StepKey).key = list->first;
+        AddStep(StepList).list = list->second;
+        list++;
+      }
+    }
+    AddStep(StepObjectEnd);
+  }
+  AddStep(StepObjectEnd);
+
+  lists.clear();
+}
+
+size_t CJSONRPCResponseStream::Read(char *buffer, size_t size)
+{
+  size_t read = 0;
+  while (read < size)
+  {
+    if (m_writer.GetSize() == 0 && !WriteNext())
+      break;
+
+    read += m_writer.Take(buffer + read, size - read);
+  }
+
+  return read;
+}
+
+void CJSONRPCResponseStream::ReadAll(std::string &output)
+{
+  while (WriteNext())
+    m_writer.Take(output);
+
+  m_writer.Take(output);
+}
+
+void CJSONRPCResponseStream::BeginCall(const CVariant &result, DeferredLists &lists)
+{
+  DeferContext *context = new DeferContext;
+  context->result = &result;
+  context->lists = &lists;
+
+  delete deferContext.get();
+  deferContext.set(context);
+}
+
+void CJSONRPCResponseStream::EndCall()
+{
+  delete deferContext.get();
+  deferContext.set(NULL);
+}
+
+bool CJSONRPCResponseStream::Defer(const CVariant &result, const std::string &key, IDeferredList *list)
+{
+  DeferContext *context = deferContext.get();
+
+  // only lists directly in the result of a streamed call can be deferred
+  if (context == NULL || context->result != &result ||
+      result.isMember(key) || context->lists->find(key) != context->lists->end())
+    return false;
+
+  (*context->lists)[key] = list;
+  return true;
+}
+
+void CJSONRPCResponseStream::FreeLists(DeferredLists &lists)
+{
+  for (DeferredLists::iterator it = lists.begin(); it != lists.end(); ++it)
+    delete it->second;
+
+  lists.clear();
+}
+
+CJSONRPCResponseStream::Step& CJSONRPCResponseStream::AddStep(StepType type)
+{
+  m_steps.push_back(Step());
+
+  Step &step = m_steps.back();
+  step.type = type;
+  step.list = NULL;
+
+  return step;
+}
+
+bool CJSONRPCResponseStream::WriteNext()
+{
+  if (m_steps.empty())
+    return false;
+
+  Step &step = m_steps.front();
+  switch (step.type)
+  {
+  case StepObjectStart:
+    m_writer.StartObject();
+    break;
+  case StepObjectEnd:
+    m_writer.EndObject();
+    break;
+  case StepArrayStart:
+    m_writer.StartArray();
+    break;
+  case StepArrayEnd:
+    m_writer.EndArray();
+    break;
+  case StepKey:
+    m_writer.Key(step.key);
+    break;
+  case StepValue:
+    m_writer.Value(step.value);
+    break;
+  case StepList:
+    // write one item of the list at a time
+    if (m_listIndex == 0)
+      m_writer.StartArray();
+
+    if (m_listIndex < step.list->Size())
+    {
+      CVariant item;
+      step.list->Get(m_listIndex++, item);
+      m_writer.Value(item);
+      return true;
+    }
+
+    m_writer.EndArray();
+    m_listIndex = 0;
+    delete step.list;
+    break;
+  }
+
+  m_steps.pop_front();
+  return true;
+}
@@ -0,0 +1,123 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include "utils/JSONStreamWriter.h"
+#include "utils/Variant.h"
+
+namespace JSONRPC
+{
+  /*!
+   \ingroup jsonrpc
+   \brief List in the result of a method call whose items are
+   only serialized while the response is being written
+   */
+  class IDeferredList
+  {
+  public:
+    virtual ~IDeferredList() {}
+
+    virtual unsigned int Size() const = 0;
+    virtual void Get(unsigned int index, CVariant &item) = 0;
+  };
+
+  typedef std::map<std::string, IDeferredList*> DeferredLists;
+
+  /*!
+   \ingroup jsonrpc
+   \brief Serialized JSON-RPC response which is written while it is read
+
+   The small parts of the responses are kept as CVariant values but the
+   items of deferred lists are only turned into JSON one by one when the
+   output is read. The output is identical to writing the complete
+   response with CJSONVariantWriter.
+   */
+  class CJSONRPCResponseStream
+  {
+  public:
+    CJSONRPCResponseStream(bool compact);
+    ~CJSONRPCResponseStream();
+
+    void StartBatch();
+    void EndBatch();
+
+    /*!
+     \brief Adds a response to the stream
+     \param response JSON-RPC response, its values are moved into the stream
+     \param lists Lists belonging into the result of the response, the stream
+     takes ownership of them
+     */
+    void AddResponse(CVariant &response, DeferredLists &lists);
+
+    /*!
+     \brief Reads the next part of the serialized response(s)
+     \return Number of bytes copied into buffer, 0 once everything has been read
+     */
+    size_t Read(char *buffer, size_t size);
+    void ReadAll(std::string &output);
+
+    /*!
+     \brief Starts collecting deferred lists for the result of the method
+     call running on the calling thread
+     */
+    static void BeginCall(const CVariant &result, DeferredLists &lists);
+    static void EndCall();
+
+    /*!
+     \brief Leaves the serialization of result[key] to the response stream
+     \return True if the list has been taken over by the stream, false if
+     the current call is not streamed and the caller has to fill result itself
+     */
+    static bool Defer(const CVariant &result, const std::string &key, IDeferredList *list);
+
+    static void FreeLists(DeferredLists &lists);
+
+  private:
+    enum StepType
+    {
+      StepObjectStart,
+      StepObjectEnd,
+      StepArrayStart,
+      StepArrayEnd,
+      StepKey,
+      StepValue,
+      StepList
+    };
+
+    typedef struct
+    {
+      StepType type;
+      std::string key;
+      CVariant value;
+      IDeferredList *list;
+    } Step;
+
+    Step& AddStep(StepType type);
+    bool WriteNext();
+
+    CJSONStreamWriter m_writer;
+    std::deque<Step> m_steps;
+    unsigned int m_listIndex;
+  };
+}
@@ -20,6 +20,8 @@
 
 #include "ServiceDescription.h"
 #include "JSONServiceDescription.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StdString.h"
 #include "utils/JSONVariantParser.h"
@@ -44,6 +46,8 @@ map<string, CVariant> CJSONServiceDescription::m_notifications = map<string, CVa
 CJSONServiceDescription::CJsonRpcMethodMap CJSONServiceDescription::m_actionMap;
 map<string, JSONSchemaTypeDefinitionPtr> CJSONServiceDescription::m_types = map<string, JSONSchemaTypeDefinitionPtr>();
 CJSONServiceDescription::IncompleteSchemaDefinitionMap CJSONServiceDescription::m_incompleteDefinitions = CJSONServiceDescription::IncompleteSchemaDefinitionMap();
+map<string, CJSONServiceDescription::CachedCall> CJSONServiceDescription::m_cachedCalls;
+CCriticalSection CJSONServiceDescription::m_cachedCallsSection;
 
 JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 // JSON-RPC
@@ -202,7 +206,8 @@ JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
     exclusiveMinimum(false), exclusiveMaximum(false), divisibleBy(0),
     minLength(-1), maxLength(-1),
     minItems(0), maxItems(0), uniqueItems(false),
-    hasAdditionalProperties(false)
+    hasAdditionalProperties(false),
+    compiled(false), acceptsAny(false)
 { }
 
 bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /* = false */)
@@ -580,14 +585,35 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
 
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
-  CStdString errorMessage;
+  JSONRPC_STATUS status = check(value, outputValue, errorData);
+
+  // only fill in the name and type of the failing type (or of
+  // the extended type that failed) when there was an error
+  if (status != OK)
+  {
+    if (!name.empty() && !errorData.isMember("name"))
+      errorData["name"] = name;
+    if (!errorData.isMember("type"))
+      SchemaValueTypeToJson(type, errorData["type"]);
+  }
+
+  return status;
+}
 
+JSONRPC_STATUS JSONSchemaTypeDefinition::check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
+{
   if (referencedType != NULL && !referencedTypeSet)
     Set(referencedType);
 
+  // fast path for values without any restrictions
+  if (acceptsAny && !value.isNull())
+  {
+    outputValue = value;
+    return OK;
+  }
+
+  CStdString errorMessage;
+
   // Let's check the type of the provided parameter
   if (!IsType(value, type))
   {
@@ -675,9 +701,8 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       // Loop through all array elements
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
       {
-        CVariant temp;
-        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, errorData["property"]);
-        outputValue.push_back(temp);
+        outputValue.push_back(CVariant());
+        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
         if (status != OK)
         {
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
@@ -852,12 +877,17 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
   if (enums.size() > 0)
   {
     bool valid = false;
-    for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); enumItr++)
+    if (!stringEnums.empty())
+      valid = value.isString() && stringEnums.find(value.asString()) != stringEnums.end();
+    else
     {
-      if (*enumItr == value)
+      for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); enumItr++)
       {
-        valid = true;
-        break;
+        if (*enumItr == value)
+        {
+          valid = true;
+          break;
+        }
       }
     }
 
@@ -1120,6 +1150,50 @@ void JSONSchemaTypeDefinition::Set(const JSONSchemaTypeDefinitionPtr typeDefinit
   referencedTypeSet = true;
 }
 
+void JSONSchemaTypeDefinition::Compile()
+{
+  if (compiled)
+    return;
+
+  if (referencedType != NULL && !referencedTypeSet)
+    Set(referencedType);
+
+  // the referenced type has already been compiled
+  if (compiled)
+    return;
+
+  // mark it before compiling the contained types
+  // because types can contain themselves
+  compiled = true;
+
+  acceptsAny = type == AnyValue && unionTypes.empty() && extends.empty() && enums.empty();
+
+  stringEnums.clear();
+  for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); enumItr++)
+  {
+    if (!enumItr->isString())
+    {
+      stringEnums.clear();
+      break;
+    }
+
+    stringEnums.insert(enumItr->asString());
+  }
+
+  for (unsigned int index = 0; index < unionTypes.size(); index++)
+    unionTypes.at(index)->Compile();
+  for (unsigned int index = 0; index < extends.size(); index++)
+    extends.at(index)->Compile();
+  for (unsigned int index = 0; index < items.size(); index++)
+    items.at(index)->Compile();
+  for (unsigned int index = 0; index < additionalItems.size(); index++)
+    additionalItems.at(index)->Compile();
+  for (CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator it = properties.begin(); it != properties.end(); it++)
+    it->second->Compile();
+  if (additionalProperties != NULL)
+    additionalProperties->Compile();
+}
+
 JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::CJsonSchemaPropertiesMap()
 {
   m_propertiesmap = std::map<std::string, JSONSchemaTypeDefinitionPtr>();
@@ -1233,6 +1307,10 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
     {
       methodCall = method;
 
+      // identical parameters have already been checked before
+      if (CJSONServiceDescription::getCachedCall(name, requestParameters, outputParameters))
+        return OK;
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1260,6 +1338,7 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
         return InvalidParams;
       }
 
+      CJSONServiceDescription::setCachedCall(name, requestParameters, outputParameters);
       return OK;
     }
     else
@@ -1306,7 +1385,7 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   if (ParameterExists(requestParameters, type->name, position))
   {
     // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type->name, position);
+    const CVariant &parameterValue = IsValueMember(requestParameters, type->name) ? requestParameters[type->name] : requestParameters[position];
 
     // Evaluate the type of the parameter
     JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], errorData["stack"]);
@@ -1338,6 +1417,9 @@ void CJSONServiceDescription::Cleanup()
   m_notifications.clear();
   m_actionMap.clear();
   m_types.clear();
+
+  CSingleLock lock(m_cachedCallsSection);
+  m_cachedCalls.clear();
   m_incompleteDefinitions.clear();
 }
 
@@ -1826,6 +1908,20 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+void CJSONServiceDescription::Compile()
+{
+  for (std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator it = m_types.begin(); it != m_types.end(); it++)
+    it->second->Compile();
+
+  for (CJsonRpcMethodMap::JsonRpcMethodIterator it = m_actionMap.begin(); it != m_actionMap.end(); it++)
+  {
+    for (unsigned int index = 0; index < it->second.parameters.size(); index++)
+      it->second.parameters.at(index)->Compile();
+    if (it->second.returns != NULL)
+      it->second.returns->Compile();
+  }
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
@@ -1927,6 +2023,64 @@ void CJSONServiceDescription::removeReferenceTypeDefinition(const std::string &t
     m_types.erase(type);
 }
 
+// calls are only cached when their parameters are small, copying large ones
+// (like the items passed to Playlist.Add) costs more than validating them
+#define CACHED_CALL_MAX_VALUES 64
+
+static bool hasFewValues(const CVariant &value, unsigned int &budget)
+{
+  if (budget == 0)
+    return false;
+  budget--;
+
+  if (value.isArray())
+  {
+    for (CVariant::const_iterator_array it = value.begin_array(); it != value.end_array(); it++)
+    {
+      if (!hasFewValues(*it, budget))
+        return false;
+    }
+  }
+  else if (value.isObject())
+  {
+    for (CVariant::const_iterator_map it = value.begin_map(); it != value.end_map(); it++)
+    {
+      if (!hasFewValues(it->second, budget))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool CJSONServiceDescription::getCachedCall(const std::string &method, const CVariant &requestParameters, CVariant &outputParameters)
+{
+  if (!g_advancedSettings.m_jsonCacheValidation)
+    return false;
+
+  CSingleLock lock(m_cachedCallsSection);
+  std::map<std::string, CachedCall>::const_iterator it = m_cachedCalls.find(method);
+  if (it == m_cachedCalls.end() || !(it->second.requestParameters == requestParameters))
+    return false;
+
+  outputParameters = it->second.outputParameters;
+  return true;
+}
+
+void CJSONServiceDescription::setCachedCall(const std::string &method, const CVariant &requestParameters, const CVariant &outputParameters)
+{
+  if (!g_advancedSettings.m_jsonCacheValidation)
+    return;
+
+  unsigned int requestBudget = CACHED_CALL_MAX_VALUES, outputBudget = CACHED_CALL_MAX_VALUES;
+  if (!hasFewValues(requestParameters, requestBudget) || !hasFewValues(outputParameters, outputBudget))
+    return;
+
+  CSingleLock lock(m_cachedCallsSection);
+  CachedCall &cached = m_cachedCalls[method];
+  cached.requestParameters = requestParameters;
+  cached.outputParameters = outputParameters;
+}
+
 void CJSONServiceDescription::getReferencedTypes(const JSONSchemaTypeDefinitionPtr type, std::vector<std::string> &referencedTypes)
 {
   // If the current type is a referenceable object, we can add it to the list
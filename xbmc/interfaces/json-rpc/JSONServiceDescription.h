@@ -19,12 +19,14 @@
  *
  */
 
+#include <set>
 #include <string>
 #include <vector>
 #include <limits>
 #include <boost/shared_ptr.hpp>
 
 #include "JSONUtils.h"
+#include "threads/CriticalSection.h"
 
 namespace JSONRPC
 {
@@ -50,6 +52,12 @@ namespace JSONRPC
     JSONRPC_STATUS Check(const CVariant &value, CVariant &outputValue, CVariant &errorData);
     void Print(bool isParameter, bool isGlobal, bool printDefault, bool printDescriptions, CVariant &output) const;
     void Set(const JSONSchemaTypeDefinitionPtr typeDefinition);
+
+    /*!
+     \brief Resolves the referenced type of this and all contained
+     types and prepares the lookups used by Check()
+     */
+    void Compile();
     
     std::string missingReference;
 
@@ -221,6 +229,26 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinitionPtr additionalProperties;
+
+    /*!
+     \brief Whether the type has been compiled
+     */
+    bool compiled;
+
+    /*!
+     \brief Whether any value but null is accepted
+     without further checks (only set when compiled)
+     */
+    bool acceptsAny;
+
+    /*!
+     \brief Lookup set of the allowed values if all of
+     them are strings (only set when compiled)
+     */
+    std::set<std::string> stringEnums;
+
+  private:
+    JSONRPC_STATUS check(const CVariant &value, CVariant &outputValue, CVariant &errorData);
   };
 
   /*! 
@@ -389,6 +417,13 @@ namespace JSONRPC
      given parameters from the request against the json schema description for the given method.
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
+
+    /*!
+     \brief Compiles all the defined types and methods
+     Resolves all type references so that checking a call doesn't have
+     to do it anymore and prepares faster lookups for the checks.
+     */
+    static void Compile();
     
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
@@ -404,6 +439,9 @@ namespace JSONRPC
 
     static void getReferencedTypes(const JSONSchemaTypeDefinitionPtr type, std::vector<std::string> &referencedTypes);
 
+    static bool getCachedCall(const std::string &method, const CVariant &requestParameters, CVariant &outputParameters);
+    static void setCachedCall(const std::string &method, const CVariant &requestParameters, const CVariant &outputParameters);
+
     class CJsonRpcMethodMap
     {
     public:
@@ -441,5 +479,14 @@ namespace JSONRPC
 
     typedef std::map<std::string, std::vector<IncompleteSchemaDefinition> > IncompleteSchemaDefinitionMap;
     static IncompleteSchemaDefinitionMap m_incompleteDefinitions;
+
+    typedef struct CachedCall
+    {
+      CVariant requestParameters;
+      CVariant outputParameters;
+    } CachedCall;
+
+    static std::map<std::string, CachedCall> m_cachedCalls;
+    static CCriticalSection m_cachedCallsSection;
   };
 }
@@ -108,7 +108,7 @@ JSONRPC_STATUS CVideoLibrary::GetMovieSets(const CStdString &method, ITransportL
   if (!videodatabase.GetSetsNav("videodb://1/7/", items, VIDEODB_CONTENT_MOVIES))
     return InternalError;
 
-  HandleFileItemList("setid", false, "sets", items, parameterObject, result);
+  HandleFileItemList("setid", false, "sets", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -192,7 +192,7 @@ JSONRPC_STATUS CVideoLibrary::GetTVShows(const CStdString &method, ITransportLay
   int size = items.Size();
   if (items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("tvshowid", true, "tvshows", items, parameterObject, result, size, false);
+  HandleFileItemList("tvshowid", true, "tvshows", items, parameterObject, result, size, false, true);
 
   return OK;
 }
@@ -227,7 +227,7 @@ JSONRPC_STATUS CVideoLibrary::GetSeasons(const CStdString &method, ITransportLay
   if (!videodatabase.GetSeasonsNav(strPath, items, -1, -1, -1, -1, tvshowID, false))
     return InternalError;
 
-  HandleFileItemList(NULL, false, "seasons", items, parameterObject, result);
+  HandleFileItemList(NULL, false, "seasons", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -449,7 +449,7 @@ JSONRPC_STATUS CVideoLibrary::GetGenres(const CStdString &method, ITransportLaye
   for (unsigned int i = 0; i < (unsigned int)items.Size(); i++)
     items[i]->GetVideoInfoTag()->m_strTitle = items[i]->GetLabel();
 
-  HandleFileItemList("genreid", false, "genres", items, parameterObject, result);
+  HandleFileItemList("genreid", false, "genres", items, parameterObject, result, true, true);
   return OK;
 }
 
@@ -776,7 +776,7 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &paramete
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("movieid", true, "movies", items, parameterObject, result, size, limit);
+  HandleFileItemList("movieid", true, "movies", items, parameterObject, result, size, limit, true);
 
   return OK;
 }
@@ -806,7 +806,7 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalEpisodeDetails(const CVariant &parame
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("episodeid", true, "episodes", items, parameterObject, result, size, limit);
+  HandleFileItemList("episodeid", true, "episodes", items, parameterObject, result, size, limit, true);
 
   return OK;
 }
@@ -832,7 +832,7 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalMusicVideoDetails(const CVariant &par
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("musicvideoid", true, "musicvideos", items, parameterObject, result, size, limit);
+  HandleFileItemList("musicvideoid", true, "musicvideos", items, parameterObject, result, size, limit, true);
 
   return OK;
 }
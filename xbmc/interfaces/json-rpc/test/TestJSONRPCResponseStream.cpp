@@ -0,0 +1,174 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPCResponseStream.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+using namespace JSONRPC;
+
+static void CreateItem(unsigned int index, CVariant &item)
+{
+  item["songid"] = index;
+  item["label"] = StringUtils::Format("Song %u", index);
+  item["artist"].append("Artist");
+  item["duration"] = 180 + index % 120;
+  item["rating"] = 2.5;
+  item["file"] = StringUtils::Format("/music/album/%05u.flac", index);
+}
+
+class TestDeferredList : public IDeferredList
+{
+public:
+  TestDeferredList(unsigned int size) : m_size(size) { }
+
+  virtual unsigned int Size() const { return m_size; }
+  virtual void Get(unsigned int index, CVariant &item) { CreateItem(index, item); }
+
+private:
+  unsigned int m_size;
+};
+
+static void CreateResponse(unsigned int size, CVariant &response)
+{
+  response["jsonrpc"] = "2.0";
+  response["id"] = 1;
+  response["result"]["limits"]["start"] = 0;
+  response["result"]["limits"]["end"] = size;
+  response["result"]["limits"]["total"] = size;
+}
+
+TEST(TestJSONRPCResponseStream, Response)
+{
+  // enough items for the output to span several reads
+  const unsigned int size = 1000;
+
+  // the whole response tree written in one go
+  CVariant expected;
+  CreateResponse(size, expected);
+  for (unsigned int i = 0; i < size; i++)
+  {
+    CVariant item;
+    CreateItem(i, item);
+    expected["result"]["songs"].append(item);
+  }
+  std::string variantOutput = CJSONVariantWriter::Write(expected, true);
+
+  // streamed: only the small parts are kept as CVariant
+  CVariant response;
+  CreateResponse(size, response);
+  DeferredLists lists;
+  lists["songs"] = new TestDeferredList(size);
+
+  CJSONRPCResponseStream stream(true);
+  stream.AddResponse(response, lists);
+  EXPECT_TRUE(lists.empty());
+
+  std::string streamOutput;
+  char buffer[16384];
+  size_t read;
+  while ((read = stream.Read(buffer, sizeof(buffer))) > 0)
+    streamOutput.append(buffer, read);
+
+  EXPECT_LT(sizeof(buffer), streamOutput.size());
+  EXPECT_EQ(variantOutput.size(), streamOutput.size());
+  EXPECT_TRUE(variantOutput == streamOutput);
+}
+
+TEST(TestJSONRPCResponseStream, Batch)
+{
+  CVariant first, second, expected;
+  CreateResponse(3, first);
+  second["jsonrpc"] = "2.0";
+  second["id"] = 2;
+  second["result"] = "OK";
+
+  expected.append(first);
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    CVariant item;
+    CreateItem(i, item);
+    expected[0]["result"]["songs"].append(item);
+  }
+  expected.append(second);
+
+  DeferredLists lists;
+  CJSONRPCResponseStream stream(false);
+  stream.StartBatch();
+  lists["songs"] = new TestDeferredList(3);
+  stream.AddResponse(first, lists);
+  lists["songs"] = new TestDeferredList(3);
+  stream.AddResponse(second, lists);
+  stream.EndBatch();
+
+  std::string output;
+  stream.ReadAll(output);
+
+  EXPECT_STREQ(CJSONVariantWriter::Write(expected, false).c_str(), output.c_str());
+}
+
+// compares the time it takes to build the whole response tree and write it
+// in one go with streaming the list items, run with
+// --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(TestJSONRPCResponseStream, DISABLED_Benchmark)
+{
+  const unsigned int size = 20000;
+
+  CStopWatch watch;
+  watch.StartZero();
+
+  CVariant expected;
+  CreateResponse(size, expected);
+  for (unsigned int i = 0; i < size; i++)
+  {
+    CVariant item;
+    CreateItem(i, item);
+    expected["result"]["songs"].append(item);
+  }
+  std::string variantOutput = CJSONVariantWriter::Write(expected, true);
+
+  float variantTime = watch.GetElapsedMilliseconds();
+  watch.StartZero();
+
+  CVariant response;
+  CreateResponse(size, response);
+  DeferredLists lists;
+  lists["songs"] = new TestDeferredList(size);
+
+  CJSONRPCResponseStream stream(true);
+  stream.AddResponse(response, lists);
+
+  std::string streamOutput;
+  char buffer[16384];
+  size_t read;
+  while ((read = stream.Read(buffer, sizeof(buffer))) > 0)
+    streamOutput.append(buffer, read);
+
+  float streamTime = watch.GetElapsedMilliseconds();
+
+  EXPECT_TRUE(variantOutput == streamOutput);
+  std::cout << "CVariant tree: " << variantTime << " ms, stream: " << streamTime << " ms for " << size << " items" << std::endl;
+}
@@ -0,0 +1,288 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/AnnouncementManager.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace ANNOUNCEMENT;
+
+#define SENDER "TestAnnouncementManager"
+
+namespace
+{
+  class CTestAnnouncer : public IAnnouncer
+  {
+  public:
+    CTestAnnouncer() : m_block(false), m_received(true) { }
+
+    virtual void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+    {
+      // anything else running in the test binary may announce as well
+      if (strcmp(sender, SENDER) != 0)
+        return;
+
+      bool block;
+      {
+        CSingleLock lock(m_section);
+        m_messages.push_back(message);
+        block = m_block;
+        m_block = false;
+      }
+      m_received.Set();
+
+      if (block)
+      {
+        m_entered.Set();
+        m_release.Wait();
+      }
+    }
+
+    // the next announcement blocks until Release()
+    void Block()   { CSingleLock lock(m_section); m_block = true; }
+    bool WaitForBlocked() { return m_entered.WaitMSec(5000); }
+    void Release() { m_release.Set(); }
+
+    std::vector<std::string> GetMessages()
+    {
+      CSingleLock lock(m_section);
+      return m_messages;
+    }
+
+    bool WaitForMessages(unsigned int count, unsigned int timeout = 5000)
+    {
+      XbmcThreads::EndTime endTime(timeout);
+      while (GetMessages().size() < count)
+      {
+        if (endTime.IsTimePast())
+          return false;
+        m_received.Reset();
+        if (GetMessages().size() < count)
+          m_received.WaitMSec(endTime.MillisLeft());
+      }
+      return true;
+    }
+
+  private:
+    CCriticalSection m_section;
+    std::vector<std::string> m_messages;
+    bool m_block;
+    CEvent m_received;
+    CEvent m_entered;
+    CEvent m_release;
+  };
+
+  class CRemover : public IRunnable
+  {
+  public:
+    CRemover(IAnnouncer *announcer) : m_announcer(announcer), m_done(false) { }
+
+    virtual void Run()
+    {
+      CAnnouncementManager::RemoveAnnouncer(m_announcer);
+      CSingleLock lock(m_section);
+      m_done = true;
+    }
+
+    bool IsDone()
+    {
+      CSingleLock lock(m_section);
+      return m_done;
+    }
+
+  private:
+    IAnnouncer *m_announcer;
+    CCriticalSection m_section;
+    bool m_done;
+  };
+}
+
+class TestAnnouncementManager : public testing::Test
+{
+protected:
+  TestAnnouncementManager()
+  {
+    m_asynchronous   = g_advancedSettings.m_announceAsynchronous;
+    m_coalesceWindow = g_advancedSettings.m_announceCoalesceWindow;
+    m_rateLimit      = g_advancedSettings.m_announceRateLimit;
+    m_queueSize      = g_advancedSettings.m_announceQueueSize;
+
+    g_advancedSettings.m_announceAsynchronous   = true;
+    g_advancedSettings.m_announceCoalesceWindow = 0;
+    g_advancedSettings.m_announceRateLimit      = 0;
+    g_advancedSettings.m_announceQueueSize      = 100;
+  }
+
+  ~TestAnnouncementManager()
+  {
+    CAnnouncementManager::RemoveAnnouncer(&announcer);
+
+    g_advancedSettings.m_announceAsynchronous   = m_asynchronous;
+    g_advancedSettings.m_announceCoalesceWindow = m_coalesceWindow;
+    g_advancedSettings.m_announceRateLimit      = m_rateLimit;
+    g_advancedSettings.m_announceQueueSize      = m_queueSize;
+  }
+
+  static void Announce(const char *message, AnnouncementFlag flag = Other)
+  {
+    CAnnouncementManager::Announce(flag, SENDER, message);
+  }
+
+  CTestAnnouncer announcer;
+
+private:
+  bool m_asynchronous;
+  unsigned int m_coalesceWindow;
+  unsigned int m_rateLimit;
+  unsigned int m_queueSize;
+};
+
+TEST_F(TestAnnouncementManager, DeliversInOrder)
+{
+  CAnnouncementManager::AddAnnouncer(&announcer);
+
+  std::vector<std::string> expected;
+  for (int i = 0; i < 50; i++)
+  {
+    expected.push_back(i % 2 ? "OnOdd" : "OnEven");
+    Announce(expected.back().c_str(), i % 3 ? Other : GUI);
+  }
+
+  ASSERT_TRUE(announcer.WaitForMessages(expected.size()));
+  EXPECT_EQ(expected, announcer.GetMessages());
+}
+
+TEST_F(TestAnnouncementManager, SystemIsDeliveredBeforeReturning)
+{
+  CAnnouncementManager::AddAnnouncer(&announcer);
+
+  Announce("OnFirst");
+  Announce("OnSecond");
+  Announce("OnQuit", System);
+
+  std::vector<std::string> messages = announcer.GetMessages();
+  ASSERT_EQ(3U, messages.size());
+  EXPECT_EQ("OnFirst", messages[0]);
+  EXPECT_EQ("OnSecond", messages[1]);
+  EXPECT_EQ("OnQuit", messages[2]);
+}
+
+TEST_F(TestAnnouncementManager, CoalescesIdenticalAnnouncements)
+{
+  g_advancedSettings.m_announceCoalesceWindow = 500;
+  CAnnouncementManager::AddAnnouncer(&announcer);
+  AnnouncementStatistics before = CAnnouncementManager::GetStatistics();
+
+  // keep the announcer busy so the burst piles up in the queue
+  announcer.Block();
+  Announce("OnBusy");
+  ASSERT_TRUE(announcer.WaitForBlocked());
+
+  for (int i = 0; i < 10; i++)
+    Announce("OnUpdate");
+  Announce("OnOther");
+  for (int i = 0; i < 10; i++)
+    Announce("OnUpdate");
+  announcer.Release();
+
+  // merging only ever happens with the last queued one, the order is kept
+  ASSERT_TRUE(announcer.WaitForMessages(4));
+  std::vector<std::string> messages = announcer.GetMessages();
+  ASSERT_EQ(4U, messages.size());
+  EXPECT_EQ("OnBusy", messages[0]);
+  EXPECT_EQ("OnUpdate", messages[1]);
+  EXPECT_EQ("OnOther", messages[2]);
+  EXPECT_EQ("OnUpdate", messages[3]);
+
+  // a burst right after a delivery is held back and results in one more
+  for (int i = 0; i < 10; i++)
+    Announce("OnUpdate");
+  ASSERT_TRUE(announcer.WaitForMessages(5));
+  XbmcThreads::ThreadSleep(300);
+  EXPECT_EQ(5U, announcer.GetMessages().size());
+
+  AnnouncementStatistics after = CAnnouncementManager::GetStatistics();
+  EXPECT_EQ(9U + 9U + 9U, after.merged - before.merged);
+}
+
+TEST_F(TestAnnouncementManager, UrgentIsNeverMerged)
+{
+  g_advancedSettings.m_announceCoalesceWindow = 1000;
+  CAnnouncementManager::AddAnnouncer(&announcer);
+
+  Announce("OnWake", System);
+  Announce("OnWake", System);
+  EXPECT_EQ(2U, announcer.GetMessages().size());
+}
+
+TEST_F(TestAnnouncementManager, RemoveWaitsForDelivery)
+{
+  CAnnouncementManager::AddAnnouncer(&announcer);
+  AnnouncementStatistics before = CAnnouncementManager::GetStatistics();
+
+  announcer.Block();
+  Announce("OnSlow");
+  ASSERT_TRUE(announcer.WaitForBlocked());
+  for (int i = 0; i < 5; i++)
+    Announce(i % 2 ? "OnOdd" : "OnEven");
+
+  CRemover remover(&announcer);
+  CThread thread(&remover, "TestAnnouncementManager");
+  thread.Create();
+
+  // the announcer is still being called, so it must not be destroyed yet
+  XbmcThreads::ThreadSleep(1000);
+  EXPECT_FALSE(remover.IsDone());
+
+  announcer.Release();
+  ASSERT_TRUE(thread.WaitForThreadExit(5000));
+  EXPECT_TRUE(remover.IsDone());
+
+  // the queued ones were dropped and nothing reaches the announcer anymore
+  Announce("OnLate");
+  XbmcThreads::ThreadSleep(100);
+  std::vector<std::string> messages = announcer.GetMessages();
+  ASSERT_EQ(1U, messages.size());
+  EXPECT_EQ("OnSlow", messages[0]);
+
+  AnnouncementStatistics after = CAnnouncementManager::GetStatistics();
+  EXPECT_EQ(5U, after.dropped - before.dropped);
+}
+
+TEST_F(TestAnnouncementManager, RemoveIsImmediateWhenIdle)
+{
+  CAnnouncementManager::AddAnnouncer(&announcer);
+  Announce("OnFirst");
+  ASSERT_TRUE(announcer.WaitForMessages(1));
+
+  CAnnouncementManager::RemoveAnnouncer(&announcer);
+  Announce("OnLate");
+  XbmcThreads::ThreadSleep(100);
+  EXPECT_EQ(1U, announcer.GetMessages().size());
+}
@@ -23,7 +23,11 @@
 #include "settings/AdvancedSettings.h"
 #include "FileItem.h"
 #include "Application.h"
+#include "cores/dvdplayer/DVDDemuxDecodeBenchmark.h"
+#include "cores/AudioEngine/AEFactory.h"
+#include "peripherals/Peripherals.h"
 #include "PlayListPlayer.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "xbmc.h"
 #ifdef _LINUX
@@ -80,6 +84,28 @@ int main(int argc, char* argv[])
 #ifndef _WIN32
   CAppParamParser appParamParser;
   appParamParser.Parse((const char **)argv, argc);
+
+  // headless demux and decode benchmark, no gui or renderer is created
+  if (!appParamParser.GetDecodeBenchmarkFile().empty())
+  {
+    if (!g_application.Create())
+    {
+      fprintf(stderr, "ERROR: Unable to create application. Exiting\n");
+      return -1;
+    }
+    int status = CDVDDemuxDecodeBenchmark::RunToFile(appParamParser.GetDecodeBenchmarkFile(),
+                                                     appParamParser.IsDecodeBenchmarkRealtime(),
+                                                     appParamParser.GetDecodeBenchmarkOutput());
+    // only undo what Create() started. g_application.Stop() would save the
+    // settings, announce OnQuit and tear down the skin and window system,
+    // none of which a benchmark touches.
+    CJobManager::GetInstance().CancelJobs();
+    PERIPHERALS::CPeripherals::Get().Clear();
+    CAEFactory::Shutdown();
+    CAEFactory::UnLoadEngine();
+    CLog::Close();
+    return status;
+  }
 #endif
   return XBMC_Run(renderGUI);
 }
@@ -184,6 +184,9 @@ bool CMusicDatabase::CreateTables()
     m_pDS->exec("CREATE INDEX idxKaraNumber on karaokedata(iKaraNumber)");
     m_pDS->exec("CREATE INDEX idxKarSong on karaokedata(idSong)");
 
+    CLog::Log(LOGINFO, "create replaygain table");
+    m_pDS->exec("CREATE TABLE replaygain ( idSong integer primary key, iTrackGain integer, fTrackPeak float, iAlbumGain integer, fAlbumPeak float, iFailures integer )\n");
+
     // Trigger
     CLog::Log(LOGINFO, "create albuminfo trigger");
     m_pDS->exec("CREATE TRIGGER tgrAlbumInfo AFTER delete ON albuminfo FOR EACH ROW BEGIN delete from albuminfosong where albuminfosong.idAlbumInfo=old.idAlbumInfo; END");
@@ -433,6 +436,8 @@ int CMusicDatabase::UpdateSong(const CSong& song, int idSong /* = -1 */)
   ExecuteQuery(sql);
   sql.Format("delete from karaokedata where idSong=%d", idSong);
   ExecuteQuery(sql);
+  sql.Format("delete from replaygain where idSong=%d", idSong);
+  ExecuteQuery(sql);
 
   CSong newSong = song;
   // Make sure newSong.idSong has a valid value (> 0)
@@ -2010,6 +2015,8 @@ bool CMusicDatabase::CleanupSongsByIds(const CStdString &strSongIds)
       m_pDS->exec(strSQL.c_str());
       strSQL = "delete from karaokedata where idSong in " + strSongsToDelete;
       m_pDS->exec(strSQL.c_str());
+      strSQL = "delete from replaygain where idSong in " + strSongsToDelete;
+      m_pDS->exec(strSQL.c_str());
       m_pDS->close();
     }
     return true;
@@ -2937,14 +2944,9 @@ bool CMusicDatabase::GetArtistsByWhere(const CStdString& strBaseDir, const Filte
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
-    {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
-    }
+    // Apply the sorting and limiting directly in SQL if possible
+    if (!countOnly && !BuildPagedSQL(strSQL, MediaTypeArtist, extFilter, sorting, strSQLExtra, total))
+      return false;
 
     strSQL = PrepareSQL(strSQL.c_str(), !extFilter.fields.empty() && extFilter.fields.compare("*") != 0 ? extFilter.fields.c_str() : "artistview.*") + strSQLExtra;
 
@@ -2975,7 +2977,7 @@ bool CMusicDatabase::GetArtistsByWhere(const CStdString& strBaseDir, const Filte
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeArtist, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeArtist, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3130,14 +3132,9 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const Filter &f
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
-    {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
-    }
+    // Apply the sorting and limiting directly in SQL if possible
+    if (!BuildPagedSQL(strSQL, MediaTypeAlbum, extFilter, sorting, strSQLExtra, total))
+      return false;
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "albumview.*") + strSQLExtra;
 
@@ -3173,7 +3170,7 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const Filter &f
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeAlbum, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeAlbum, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3243,14 +3240,9 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const Filter &fi
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
-    {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
-    }
+    // Apply the sorting and limiting directly in SQL if possible
+    if (!BuildPagedSQL(strSQL, MediaTypeSong, extFilter, sorting, strSQLExtra, total))
+      return false;
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
@@ -3273,7 +3265,7 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const Filter &fi
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3712,6 +3704,10 @@ bool CMusicDatabase::UpdateOldVersion(int version)
         m_pDS->exec(PrepareSQL("UPDATE song SET strFileName='%s' WHERE idSong=%d", filename.c_str(), i->first));
     }
   }
+  if (version < 33)
+  {
+    m_pDS->exec("CREATE TABLE replaygain ( idSong integer primary key, iTrackGain integer, fTrackPeak float, iAlbumGain integer, fAlbumPeak float, iFailures integer )\n");
+  }
   // always recreate the views after any table change
   CreateViews();
 
@@ -3720,7 +3716,7 @@ bool CMusicDatabase::UpdateOldVersion(int version)
 
 int CMusicDatabase::GetMinVersion() const
 {
-  return 32;
+  return 33;
 }
 
 unsigned int CMusicDatabase::GetSongIDs(const Filter &filter, vector<pair<int,int> > &songIDs)
@@ -4206,6 +4202,8 @@ bool CMusicDatabase::RemoveSongsFromPath(const CStdString &path1, CSongMap &song
       m_pDS->exec(sql.c_str());
       sql = "delete from karaokedata where idSong in " + songIds;
       m_pDS->exec(sql.c_str());
+      sql = "delete from replaygain where idSong in " + songIds;
+      m_pDS->exec(sql.c_str());
 
     }
     // and remove the path as well (it'll be re-added later on with the new hash if it's non-empty)
@@ -4315,6 +4313,167 @@ int CMusicDatabase::GetSongIDFromPath(const CStdString &filePath)
   return -1;
 }
 
+bool CMusicDatabase::GetAlbumsWithoutReplayGain(std::vector<int> &albums, int maxFailures)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("select distinct song.idAlbum from song "
+                                "left join replaygain on song.idSong = replaygain.idSong "
+                                "where (replaygain.idSong is null or replaygain.iFailures between 1 and %i) "
+                                "and song.iStartOffset = 0 and song.iEndOffset = 0", maxFailures - 1);
+    if (!m_pDS->query(sql.c_str())) return false;
+
+    while (!m_pDS->eof())
+    {
+      albums.push_back(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetSongPathsByAlbum(int idAlbum, std::vector< std::pair<int, CStdString> > &songs)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("select song.idSong, path.strPath, song.strFileName from song "
+                                "join path on song.idPath = path.idPath "
+                                "where song.idAlbum = %i and song.iStartOffset = 0 and song.iEndOffset = 0", idAlbum);
+    if (!m_pDS->query(sql.c_str())) return false;
+
+    while (!m_pDS->eof())
+    {
+      CStdString strFileName;
+      URIUtils::AddFileToFolder(m_pDS->fv(1).get_asString(), m_pDS->fv(2).get_asString(), strFileName);
+      songs.push_back(make_pair(m_pDS->fv(0).get_asInt(), strFileName));
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idAlbum);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetReplayGain(int idSong, const MUSIC_INFO::CMusicInfoTag &tag)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    int flags = tag.HasReplayGainInfo();
+    CStdString trackGain = "NULL", trackPeak = "NULL", albumGain = "NULL", albumPeak = "NULL";
+    if (flags & REPLAY_GAIN_HAS_TRACK_INFO)
+      trackGain.Format("%i", tag.GetReplayGainTrackGain());
+    if (flags & REPLAY_GAIN_HAS_TRACK_PEAK)
+      trackPeak.Format("%f", tag.GetReplayGainTrackPeak());
+    if (flags & REPLAY_GAIN_HAS_ALBUM_INFO)
+      albumGain.Format("%i", tag.GetReplayGainAlbumGain());
+    if (flags & REPLAY_GAIN_HAS_ALBUM_PEAK)
+      albumPeak.Format("%f", tag.GetReplayGainAlbumPeak());
+
+    CStdString sql = PrepareSQL("delete from replaygain where idSong=%i", idSong);
+    m_pDS->exec(sql.c_str());
+    sql = PrepareSQL("insert into replaygain (idSong, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak, iFailures) values (%i, ", idSong);
+    sql += trackGain + ", " + trackPeak + ", " + albumGain + ", " + albumPeak + ", 0)";
+    m_pDS->exec(sql.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetReplayGainFailed(int idSong)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    int failures = 0;
+    CStdString sql = PrepareSQL("select iFailures from replaygain where idSong=%i", idSong);
+    if (!m_pDS->query(sql.c_str())) return false;
+    if (!m_pDS->eof())
+      failures = m_pDS->fv(0).get_asInt();
+    m_pDS->close();
+
+    sql = PrepareSQL("delete from replaygain where idSong=%i", idSong);
+    m_pDS->exec(sql.c_str());
+    sql = PrepareSQL("insert into replaygain (idSong, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak, iFailures) values (%i, NULL, NULL, NULL, NULL, %i)",
+                     idSong, failures + 1);
+    m_pDS->exec(sql.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetReplayGain(const CStdString &filePath, MUSIC_INFO::CMusicInfoTag &tag)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    int idSong = GetSongIDFromPath(filePath);
+    if (idSong < 0)
+      return false;
+
+    CStdString sql = PrepareSQL("select iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak from replaygain where idSong=%i", idSong);
+    if (!m_pDS->query(sql.c_str())) return false;
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+
+    bool found = false;
+    if (!m_pDS->fv(0).get_isNull())
+    {
+      tag.SetReplayGainTrackGain(m_pDS->fv(0).get_asInt());
+      found = true;
+    }
+    if (!m_pDS->fv(1).get_isNull())
+      tag.SetReplayGainTrackPeak(m_pDS->fv(1).get_asFloat());
+    if (!m_pDS->fv(2).get_isNull())
+    {
+      tag.SetReplayGainAlbumGain(m_pDS->fv(2).get_asInt());
+      found = true;
+    }
+    if (!m_pDS->fv(3).get_isNull())
+      tag.SetReplayGainAlbumPeak(m_pDS->fv(3).get_asFloat());
+    m_pDS->close();
+    return found;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, filePath.c_str());
+  }
+  return false;
+}
+
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
@@ -193,6 +193,44 @@ public:
   int GetVariousArtistsAlbumsCount();
 
   bool SetSongRating(const CStdString &filePath, char rating);
+
+  /*! \brief Get the albums with songs that have not been analyzed for ReplayGain yet.
+   Songs that are part of a cue sheet are skipped.
+   \param albums [out] the ids of the albums
+   \param maxFailures songs that failed to decode this many times are not retried
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetAlbumsWithoutReplayGain(std::vector<int> &albums, int maxFailures);
+
+  /*! \brief Get the paths of all songs of an album that can be analyzed for ReplayGain.
+   \param idAlbum the id of the album
+   \param songs [out] pairs of song id and full path of the song
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetSongPathsByAlbum(int idAlbum, std::vector< std::pair<int, CStdString> > &songs);
+
+  /*! \brief Store the ReplayGain values measured for a song.
+   Values that are missing from the tag are stored as NULL.
+   \param idSong the id of the song
+   \param tag the tag holding the gains and peaks
+   \return true if the values were stored, false otherwise
+   */
+  bool SetReplayGain(int idSong, const MUSIC_INFO::CMusicInfoTag &tag);
+
+  /*! \brief Count a failed ReplayGain analysis of a song.
+   The song is retried by the next analysis until it failed too often.
+   \param idSong the id of the song
+   \return true if the failure was stored, false otherwise
+   \sa GetAlbumsWithoutReplayGain
+   */
+  bool SetReplayGainFailed(int idSong);
+
+  /*! \brief Get the ReplayGain values stored for a song.
+   \param filePath the path of the song
+   \param tag [out] the tag to fill the gains and peaks in
+   \return true if the song has been analyzed successfully, false otherwise
+   */
+  bool GetReplayGain(const CStdString &filePath, MUSIC_INFO::CMusicInfoTag &tag);
   bool SetScraperForPath(const CStdString& strPath, const ADDON::ScraperPtr& info);
   bool GetScraperForPath(const CStdString& strPath, ADDON::ScraperPtr& info, const ADDON::TYPE &type);
 
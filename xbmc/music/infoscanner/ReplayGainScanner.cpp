@@ -0,0 +1,368 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ReplayGainScanner.h"
+#include "FileItem.h"
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "music/MusicDatabase.h"
+#include "music/tags/MusicInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/GUISettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
+#include "utils/LoudnessMeter.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+using namespace MUSIC_INFO;
+
+// frames decoded at once
+#define DECODE_FRAMES 4096
+
+// songs that failed to decode this many times are not retried
+#define REPLAYGAIN_MAX_FAILURES 3
+
+static float GetChannelWeight(enum AEChannel channel)
+{
+  switch (channel)
+  {
+  case AE_CH_LFE:
+    return 0.0f;
+  case AE_CH_BL:
+  case AE_CH_BR:
+  case AE_CH_SL:
+  case AE_CH_SR:
+    return 1.41f;
+  default:
+    return 1.0f;
+  }
+}
+
+static int GainToHundredths(double gain)
+{
+  return (int)floor(gain * 100.0 + 0.5);
+}
+
+CReplayGainWorker::CReplayGainWorker(CReplayGainScanner &scanner)
+  : CThread("ReplayGainWorker"), m_scanner(scanner), m_active(false),
+    m_analyzed(0), m_failed(0), m_duration(0)
+{
+}
+
+void CReplayGainWorker::Process()
+{
+  SetPriority(GetMinPriority());
+
+  int idAlbum;
+  while (m_scanner.GetNextAlbum(this, idAlbum))
+  {
+    bool read = AnalyzeAlbum(idAlbum) || m_bStop;
+    m_scanner.OnAlbumDone(idAlbum, this, read);
+  }
+}
+
+bool CReplayGainWorker::AnalyzeAlbum(int idAlbum)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  m_analyzed = 0;
+  m_failed = 0;
+  m_duration = 0;
+
+  CMusicDatabase database;
+  if (!database.Open())
+  {
+    CLog::Log(LOGERROR, "%s - unable to open the music database for album %i", __FUNCTION__, idAlbum);
+    return false;
+  }
+
+  vector< pair<int, CStdString> > songs;
+  if (!database.GetSongPathsByAlbum(idAlbum, songs))
+  {
+    CLog::Log(LOGERROR, "%s - unable to get the songs of album %i", __FUNCTION__, idAlbum);
+    return false;
+  }
+
+  // the album loudness is measured over the blocks of all its songs
+  vector<CLoudnessMeter> meters(songs.size());
+  vector<bool> analyzed(songs.size(), false);
+  CLoudnessMeter album;
+  for (unsigned int i = 0; i < songs.size(); i++)
+  {
+    if (m_bStop)
+      return false;
+
+    analyzed[i] = Analyze(songs[i].second, meters[i]);
+    if (analyzed[i])
+    {
+      album.Merge(meters[i]);
+      m_analyzed++;
+    }
+    else
+    {
+      if (m_bStop)
+        return false;
+      CLog::Log(LOGWARNING, "%s - unable to analyze %s", __FUNCTION__, songs[i].second.c_str());
+      m_failed++;
+    }
+  }
+
+  double albumLoudness = 0.0;
+  bool hasAlbumLoudness = album.GetIntegratedLoudness(albumLoudness);
+
+  // songs that could not be analyzed are counted, so they are only retried a few times
+  database.BeginTransaction();
+  for (unsigned int i = 0; i < songs.size(); i++)
+  {
+    if (!analyzed[i])
+    {
+      database.SetReplayGainFailed(songs[i].first);
+      continue;
+    }
+
+    CMusicInfoTag tag;
+    double loudness;
+    if (meters[i].GetIntegratedLoudness(loudness))
+      tag.SetReplayGainTrackGain(GainToHundredths(CLoudnessMeter::GetReplayGain(loudness)));
+    tag.SetReplayGainTrackPeak(meters[i].GetTruePeak());
+    if (hasAlbumLoudness)
+      tag.SetReplayGainAlbumGain(GainToHundredths(CLoudnessMeter::GetReplayGain(albumLoudness)));
+    tag.SetReplayGainAlbumPeak(album.GetTruePeak());
+    database.SetReplayGain(songs[i].first, tag);
+  }
+  database.CommitTransaction();
+
+  m_duration = XbmcThreads::SystemClockMillis() - start;
+  CLog::Log(LOGDEBUG, "%s - analyzed %u songs of album %i in %u ms, loudness %.1f LUFS",
+            __FUNCTION__, m_analyzed, idAlbum, m_duration, hasAlbumLoudness ? albumLoudness : -70.0);
+  return true;
+}
+
+bool CReplayGainWorker::Analyze(const CStdString &strFile, CLoudnessMeter &meter) const
+{
+  CFileItem item(strFile, false);
+  unsigned int filecache = g_guiSettings.GetInt("cacheaudio.lan");
+  if (item.IsHD())
+    filecache = g_guiSettings.GetInt("cache.harddisk");
+
+  ICodec *codec = CodecFactory::CreateCodecDemux(strFile, item.GetMimeType(), filecache * 1024);
+  if (!codec || !codec->Init(strFile, filecache * 1024))
+  {
+    delete codec;
+    return false;
+  }
+
+  CAEChannelInfo layout = codec->GetChannelInfo();
+  unsigned int channels = layout.Count();
+  unsigned int sampleSize = codec->m_BitsPerSample >> 3;
+  CAEConvert::AEConvertToFn convert = CAEConvert::ToFloat(codec->m_DataFormat);
+
+  // mono is played on both speakers, so it counts twice (dual mono)
+  vector<float> weights(channels);
+  for (unsigned int c = 0; c < channels; c++)
+    weights[c] = channels == 1 ? 2.0f : GetChannelWeight(layout[c]);
+
+  if (sampleSize == 0 || (!convert && codec->m_DataFormat != AE_FMT_FLOAT) ||
+      !meter.Init(codec->m_SampleRate, weights))
+  {
+    delete codec;
+    return false;
+  }
+
+  vector<uint8_t> buffer(DECODE_FRAMES * channels * sampleSize);
+  vector<float> samples(DECODE_FRAMES * channels);
+  bool result = true;
+  while (true)
+  {
+    if (m_bStop)
+    {
+      result = false;
+      break;
+    }
+
+    int size = 0;
+    int ret = codec->ReadPCM(&buffer[0], buffer.size(), &size);
+    if (ret == READ_ERROR)
+    {
+      result = false;
+      break;
+    }
+
+    unsigned int count = size / sampleSize;
+    count -= count % channels;
+    if (count > 0)
+    {
+      if (convert)
+        convert(&buffer[0], count, &samples[0]);
+      else
+        memcpy(&samples[0], &buffer[0], count * sizeof(float));
+      meter.AddFrames(&samples[0], count / channels);
+    }
+
+    if (ret == READ_EOF)
+      break;
+  }
+  delete codec;
+
+  return result && meter.GetFrames() > 0;
+}
+
+CReplayGainScanner &CReplayGainScanner::Get()
+{
+  static CReplayGainScanner scanner(g_advancedSettings.m_musicLibraryReplayGainThreads > 0 ?
+                                    g_advancedSettings.m_musicLibraryReplayGainThreads :
+                                    std::max(1, g_cpuInfo.getCPUCount() / 2));
+  return scanner;
+}
+
+CReplayGainScanner::CReplayGainScanner(unsigned int workers)
+  : m_workers(workers)
+{
+  for (unsigned int i = 0; i < m_workers; i++)
+    m_threads.push_back(new CReplayGainWorker(*this));
+  m_analyzed = 0;
+  m_failed = 0;
+  m_busyTime = 0;
+  m_startTime = 0;
+}
+
+CReplayGainScanner::~CReplayGainScanner()
+{
+  Stop();
+  for (vector<CReplayGainWorker*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+    delete *it;
+}
+
+void CReplayGainScanner::Start()
+{
+  CMusicDatabase database;
+  if (!database.Open())
+    return;
+
+  vector<int> albums;
+  database.GetAlbumsWithoutReplayGain(albums, REPLAYGAIN_MAX_FAILURES);
+  database.Close();
+
+  CSingleLock control(m_controlSection);
+  CSingleLock lock(m_critSection);
+  if (m_albums.empty())
+  {
+    m_analyzed = 0;
+    m_failed = 0;
+    m_busyTime = 0;
+    m_startTime = XbmcThreads::SystemClockMillis();
+  }
+
+  unsigned int queued = 0;
+  for (vector<int>::const_iterator album = albums.begin(); album != albums.end(); ++album)
+  {
+    map<int, unsigned int>::const_iterator failures = m_albumFailures.find(*album);
+    if (failures != m_albumFailures.end() && failures->second >= REPLAYGAIN_MAX_FAILURES)
+      continue;
+    if (!m_albums.insert(*album).second)
+      continue;
+    m_queue.push_back(*album);
+    queued++;
+  }
+
+  // inactive workers have run out of albums and exit without taking the
+  // lock again, so waiting for them here is short
+  unsigned int started = 0;
+  for (vector<CReplayGainWorker*>::iterator it = m_threads.begin(); it != m_threads.end() && started < m_queue.size(); ++it)
+  {
+    if ((*it)->m_active)
+      continue;
+    (*it)->StopThread(true);
+    (*it)->m_active = true;
+    (*it)->Create();
+    started++;
+  }
+  CLog::Log(LOGNOTICE, "ReplayGain: analyzing %u albums using %u workers", queued, m_workers);
+}
+
+void CReplayGainScanner::Stop()
+{
+  CSingleLock control(m_controlSection);
+  {
+    CSingleLock lock(m_critSection);
+    m_queue.clear();
+    if (!m_albums.empty())
+    {
+      LogStatistics();
+      m_albums.clear();
+    }
+    for (vector<CReplayGainWorker*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+      (*it)->StopThread(false);
+  }
+
+  // the workers check for the stop after every decoded block
+  for (vector<CReplayGainWorker*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+    (*it)->StopThread(true);
+}
+
+bool CReplayGainScanner::IsScanning()
+{
+  CSingleLock lock(m_critSection);
+  return !m_albums.empty();
+}
+
+bool CReplayGainScanner::GetNextAlbum(CReplayGainWorker *worker, int &idAlbum)
+{
+  CSingleLock lock(m_critSection);
+  if (m_queue.empty() || worker->m_bStop)
+  {
+    worker->m_active = false;
+    return false;
+  }
+  idAlbum = m_queue.front();
+  m_queue.pop_front();
+  return true;
+}
+
+void CReplayGainScanner::OnAlbumDone(int idAlbum, const CReplayGainWorker *worker, bool read)
+{
+  CSingleLock lock(m_critSection);
+  if (!read)
+    m_albumFailures[idAlbum]++;
+  if (m_albums.erase(idAlbum))
+  {
+    m_analyzed += worker->GetAnalyzed();
+    m_failed += worker->GetFailed();
+    m_busyTime += worker->GetDuration();
+    if (m_albums.empty())
+      LogStatistics();
+  }
+}
+
+void CReplayGainScanner::LogStatistics()
+{
+  // every worker analyzes one album at a time, so the time spent on albums
+  // equals the time the analysis kept a core busy
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_startTime;
+  double perCore = m_busyTime > 0 ? m_analyzed * 60000.0 / m_busyTime : 0.0;
+  double total = elapsed > 0 ? m_analyzed * 60000.0 / elapsed : 0.0;
+  CLog::Log(LOGNOTICE, "ReplayGain: analyzed %u songs (%u failed) in %s, %.1f songs/min per core, %.1f songs/min using %u workers",
+            m_analyzed, m_failed, StringUtils::SecondsToTimeString(elapsed / 1000).c_str(), perCore, total, m_workers);
+}
@@ -0,0 +1,132 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+class CLoudnessMeter;
+
+namespace MUSIC_INFO
+{
+class CReplayGainScanner;
+
+/*!
+ \brief Measures the loudness of all songs of an album and stores their
+ ReplayGain values in the music database. Takes albums from the scanner until
+ none are left.
+ */
+class CReplayGainWorker : public CThread
+{
+public:
+  CReplayGainWorker(CReplayGainScanner &scanner);
+
+  /*!
+   \brief Analyzes all songs of an album and stores the results
+   \return False if the album could not be read or the analysis was stopped
+   */
+  bool AnalyzeAlbum(int idAlbum);
+
+  /*!
+   \brief Decodes a file and feeds the decoded audio to the given meter
+   \return False if the file could not be decoded
+   */
+  bool Analyze(const CStdString &strFile, CLoudnessMeter &meter) const;
+
+  unsigned int GetAnalyzed() const { return m_analyzed; }
+  unsigned int GetFailed() const { return m_failed; }
+  unsigned int GetDuration() const { return m_duration; }
+
+protected:
+  virtual void Process();
+
+private:
+  friend class CReplayGainScanner;
+
+  CReplayGainScanner &m_scanner;
+  bool m_active;           ///< started and not out of albums yet, guarded by the scanner lock
+  unsigned int m_analyzed; ///< number of songs of the last album analyzed successfully
+  unsigned int m_failed;   ///< number of songs of the last album that could not be decoded
+  unsigned int m_duration; ///< time spent on the last album in ms
+};
+
+/*!
+ \brief Analyzes all songs of the music library without ReplayGain values in
+ the background, one album at a time per worker.
+
+ The workers are dedicated threads, as the analysis keeps a core busy for
+ minutes and would hold the job manager slots other low priority jobs need.
+ */
+class CReplayGainScanner
+{
+public:
+  static CReplayGainScanner &Get();
+
+  /*!
+   \brief Queues all albums with songs that have not been analyzed yet, or
+   that failed to decode less than REPLAYGAIN_MAX_FAILURES times. Albums
+   that could not be read that often since XBMC started are skipped.
+   */
+  void Start();
+  /*!
+   \brief Drops the queued albums and waits for the workers to finish the
+   song they are decoding
+   */
+  void Stop();
+  bool IsScanning();
+
+private:
+  friend class CReplayGainWorker;
+
+  CReplayGainScanner(unsigned int workers);
+  ~CReplayGainScanner();
+
+  /*!
+   \brief Takes the next album to analyze, marks the worker as inactive when
+   there is none left or it is stopping
+   */
+  bool GetNextAlbum(CReplayGainWorker *worker, int &idAlbum);
+  /*!
+   \brief Adds the results of the worker's last album to the statistics
+   \param read false if the songs of the album could not be read from the
+   database, the album is then skipped after a few tries
+   */
+  void OnAlbumDone(int idAlbum, const CReplayGainWorker *worker, bool read);
+  void LogStatistics();
+
+  CCriticalSection m_controlSection; ///< serializes Start() and Stop(), the workers never take it
+  CCriticalSection m_critSection;
+  unsigned int m_workers;
+  std::vector<CReplayGainWorker*> m_threads;
+  std::deque<int> m_queue; ///< albums waiting for a worker
+  std::set<int> m_albums;  ///< albums queued or being analyzed
+  std::map<int, unsigned int> m_albumFailures; ///< times an album could not be read, kept in memory as the database might be the cause
+  unsigned int m_analyzed;
+  unsigned int m_failed;
+  uint64_t     m_busyTime; ///< sum of the time spent on all albums in ms
+  unsigned int m_startTime;
+};
+}
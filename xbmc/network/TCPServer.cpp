@@ -22,8 +22,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <errno.h>
+#include <algorithm>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+#if defined(TARGET_LINUX)
+#include <sys/epoll.h>
+#define HAS_EPOLL
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
@@ -55,6 +64,20 @@ using namespace ANNOUNCEMENT;
 //using namespace std; On VS2010, bind conflicts with std::bind
 
 #define RECEIVEBUFFER 1024
+// size of the chunks a pending response is serialized in
+#define RESPONSECHUNK 16384
+// no more requests are read from a client with this many unsent responses
+#define MAXPENDINGRESPONSES 8
+#define MAXEVENTS 64
+
+static bool SocketWouldBlock()
+{
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -90,6 +113,7 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("CTCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_epoll = -1;
 }
 
 void CTCPServer::Process()
@@ -98,102 +122,229 @@ void CTCPServer::Process()
 
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
+    std::vector<SOCKET> readable, writable;
+    if (!WaitForEvents(readable, writable, 1000))
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for socket events failed");
+      Sleep(1000);
+      Initialize();
+      continue;
+    }
 
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+    for (std::vector<SOCKET>::const_iterator it = writable.begin(); it != writable.end(); ++it)
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      int index = FindConnection(*it);
+      if (index < 0)
+        continue;
+
+      if (m_connections[index]->Flush(true))
+        UpdateEvents(m_connections[index]);
+      else
+        CloseConnection(index);
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    for (std::vector<SOCKET>::const_iterator it = readable.begin(); it != readable.end(); ++it)
     {
+      if (std::find(m_servers.begin(), m_servers.end(), *it) != m_servers.end())
+        AcceptConnection(*it);
+      else
+      {
+        int index = FindConnection(*it);
+        if (index >= 0)
+          HandleConnection(index);
+      }
+    }
+  }
+
+  Deinitialize();
+}
+
+bool CTCPServer::WaitForEvents(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable, unsigned int timeout)
+{
+#ifdef HAS_EPOLL
+  struct epoll_event events[MAXEVENTS];
+  int res = epoll_wait(m_epoll, events, MAXEVENTS, timeout);
+  if (res < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < res; i++)
+  {
+    // errors and hangups are reported as readable so that recv() detects them
+    if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+      readable.push_back(events[i].data.fd);
+    if (events[i].events & EPOLLOUT)
+      writable.push_back(events[i].data.fd);
+  }
+#else
+  SOCKET          max_fd = 0;
+  fd_set          rfds, wfds;
+  struct timeval  to     = { timeout / 1000, (timeout % 1000) * 1000 };
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+  {
+    FD_SET(*it, &rfds);
+    if ((intptr_t)*it > (intptr_t)max_fd)
+      max_fd = *it;
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    int events = m_connections[i]->GetEvents();
+    if (events & SocketEventRead)
       FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+    if (events & SocketEventWrite)
+      FD_SET(m_connections[i]->m_socket, &wfds);
+    if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
+      max_fd = m_connections[i]->m_socket;
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+  if (res > 0)
+  {
+    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+    {
+      if (FD_ISSET(*it, &rfds))
+        readable.push_back(*it);
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    for (unsigned int i = 0; i < m_connections.size(); i++)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
-      Sleep(1000);
-      Initialize();
+      if (FD_ISSET(m_connections[i]->m_socket, &rfds))
+        readable.push_back(m_connections[i]->m_socket);
+      if (FD_ISSET(m_connections[i]->m_socket, &wfds))
+        writable.push_back(m_connections[i]->m_socket);
     }
-    else if (res > 0)
+  }
+#endif
+
+  return true;
+}
+
+void CTCPServer::UpdateEvents(CTCPClient *client)
+{
+  CSingleLock lock (client->m_critSection);
+  int events = client->GetEvents();
+  if (client->m_registered && events == client->m_events)
+    return;
+
+#ifdef HAS_EPOLL
+  struct epoll_event event = {};
+  event.data.fd = client->m_socket;
+  if (events & SocketEventRead)
+    event.events |= EPOLLIN;
+  if (events & SocketEventWrite)
+    event.events |= EPOLLOUT;
+
+  if (epoll_ctl(m_epoll, client->m_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, client->m_socket, &event) < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to update the events of a connection (%d)", errno);
+    return;
+  }
+#endif
+
+  client->m_events = events;
+  client->m_registered = true;
+}
+
+int CTCPServer::FindConnection(SOCKET socket) const
+{
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    if (m_connections[i]->m_socket == socket)
+      return i;
+  }
+
+  return -1;
+}
+
+void CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
+    delete newconnection;
+    return;
+  }
+
+  // all output is queued per client and written without blocking so that a
+  // slow client can't stall the server or the announcing thread
+#ifdef _WIN32
+  unsigned long nonblocking = 1;
+  ioctlsocket(newconnection->m_socket, FIONBIO, &nonblocking);
+#else
+  fcntl(newconnection->m_socket, F_SETFL, fcntl(newconnection->m_socket, F_GETFL) | O_NONBLOCK);
+#endif
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  CSingleLock lock (m_connectionsSection);
+  m_connections.push_back(newconnection);
+  UpdateEvents(newconnection);
+}
+
+void CTCPServer::HandleConnection(unsigned int index)
+{
+  char buffer[RECEIVEBUFFER] = {};
+  int  nread = 0;
+  nread = recv(m_connections[index]->m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  bool close = false;
+  if (nread > 0)
+  {
+    std::string response;
+    if (m_connections[index]->IsNew())
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (response.size() > 0)
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
-
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+      if (response.size() > 0)
+        m_connections[index]->Send(response.c_str(), response.size());
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+      if (websocket != NULL)
       {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+        // Replace the CTCPClient with a CWebSocketClient
+        CSingleLock lock (m_connectionsSection);
+        CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[index]));
+        delete m_connections[index];
+        m_connections[index] = websocketClient;
       }
     }
+
+    if (response.size() <= 0)
+      m_connections[index]->PushBuffer(this, buffer, nread);
+
+    close = m_connections[index]->Closing() || !m_connections[index]->Flush(true);
   }
+  else if (nread < 0 && SocketWouldBlock())
+    return;
+  else
+    close = true;
 
-  Deinitialize();
+  if (close)
+    CloseConnection(index);
+  else
+    UpdateEvents(m_connections[index]);
+}
+
+void CTCPServer::CloseConnection(unsigned int index)
+{
+  CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+
+  CSingleLock lock (m_connectionsSection);
+  CTCPClient *connection = m_connections[index];
+#ifdef HAS_EPOLL
+  if (connection->m_registered)
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, connection->m_socket, NULL);
+#endif
+  connection->Disconnect();
+  delete connection;
+  m_connections.erase(m_connections.begin() + index);
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -213,8 +364,11 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  // the notification is serialized once (and only if anyone is interested)
+  // and the same buffer is queued for every client
+  OutputBuffer notification;
 
+  CSingleLock lock (m_connectionsSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     {
@@ -223,7 +377,11 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    if (!notification)
+      notification.reset(new std::string(IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact)));
+
+    if (m_connections[i]->Notify(notification))
+      UpdateEvents(m_connections[i]);
   }
 }
 
@@ -236,6 +394,30 @@ bool CTCPServer::Initialize()
   started |= InitializeBlue();
   started |= InitializeTCP();
 
+#ifdef HAS_EPOLL
+  if (started)
+  {
+    m_epoll = epoll_create(MAXEVENTS);
+    if (m_epoll < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll instance (%d)", errno);
+      started = false;
+    }
+
+    for (std::vector<SOCKET>::const_iterator it = m_servers.begin(); started && it != m_servers.end(); ++it)
+    {
+      struct epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.fd = *it;
+      if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, *it, &event) < 0)
+      {
+        CLog::Log(LOGERROR, "JSONRPC Server: Failed to add serversocket to epoll instance (%d)", errno);
+        started = false;
+      }
+    }
+  }
+#endif
+
   if(started)
   {
     CAnnouncementManager::AddAnnouncer(this);
@@ -467,6 +649,7 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
+  CSingleLock lock (m_connectionsSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     m_connections[i]->Disconnect();
@@ -474,12 +657,19 @@ void CTCPServer::Deinitialize()
   }
 
   m_connections.clear();
+  lock.Leave();
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
   m_servers.clear();
 
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+    close(m_epoll);
+  m_epoll = -1;
+#endif
+
 #ifdef HAVE_LIBBLUETOOTH
   if(m_sdpd)
     sdp_close( (sdp_session_t*)m_sdpd );
@@ -492,8 +682,16 @@ void CTCPServer::Deinitialize()
 CTCPServer::CTCPClient::CTCPClient()
 {
   m_new = true;
+  m_error = false;
   m_announcementflags = ANNOUNCE_ALL;
   m_socket = INVALID_SOCKET;
+  m_events = 0;
+  m_registered = false;
+  m_outputOffset = 0;
+  m_outputSize = 0;
+  m_delayedSize = 0;
+  m_responseActive = false;
+  m_dropped = 0;
   m_beginBrackets = 0;
   m_endBrackets = 0;
   m_beginChar = 0;
@@ -507,6 +705,12 @@ CTCPServer::CTCPClient::CTCPClient(const CTCPClient& client)
   Copy(client);
 }
 
+CTCPServer::CTCPClient::~CTCPClient()
+{
+  for (std::deque<CJSONRPCResponseStream*>::iterator it = m_responses.begin(); it != m_responses.end(); ++it)
+    delete *it;
+}
+
 CTCPServer::CTCPClient& CTCPServer::CTCPClient::operator=(const CTCPClient& client)
 {
   Copy(client);
@@ -531,12 +735,21 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  Queue(OutputBuffer(new std::string(data, size)), false);
+}
+
+bool CTCPServer::CTCPClient::Notify(const OutputBuffer &notification)
+{
+  CSingleLock lock (m_critSection);
+  if (IsCongested())
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
-  } while (sent < size);
+    if (m_dropped++ == 0)
+      CLog::Log(LOGWARNING, "JSONRPC Server: Client is not reading its data, dropping notifications");
+    return false;
+  }
+
+  Queue(notification, true);
+  return true;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -567,8 +780,9 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CJSONRPCResponseStream *response = CJSONRPC::MethodCallStream(m_buffer, host, this);
+        if (response != NULL)
+          SendResponse(response);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -576,6 +790,70 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
   }
 }
 
+void CTCPServer::CTCPClient::SendResponse(CJSONRPCResponseStream *response)
+{
+  // the response is serialized in chunks whenever the socket can take more
+  // data (see Flush()) instead of being kept in memory as a whole
+  CSingleLock lock (m_critSection);
+  m_responses.push_back(response);
+}
+
+bool CTCPServer::CTCPClient::Flush(bool readResponses)
+{
+  while (true)
+  {
+    CJSONRPCResponseStream *response = NULL;
+    {
+      CSingleLock lock (m_critSection);
+      if (!Write())
+        return false;
+
+      // stop once the socket doesn't take any more data or there's nothing left
+      if (!m_output.empty() || !readResponses || m_responses.empty())
+        return true;
+
+      response = m_responses.front();
+    }
+
+    // only the server thread reads responses so this doesn't need to block
+    // the announcing thread
+    char buffer[RESPONSECHUNK];
+    size_t size = response->Read(buffer, sizeof(buffer));
+
+    CSingleLock lock (m_critSection);
+    if (size > 0)
+    {
+      m_responseActive = true;
+      m_output.push_back(OutputBuffer(new std::string(buffer, size)));
+      m_outputSize += size;
+    }
+    else
+    {
+      delete response;
+      m_responses.pop_front();
+      m_responseActive = false;
+
+      // notifications which came in while the response was being sent
+      m_output.insert(m_output.end(), m_delayedOutput.begin(), m_delayedOutput.end());
+      m_outputSize += m_delayedSize;
+      m_delayedOutput.clear();
+      m_delayedSize = 0;
+    }
+  }
+}
+
+int CTCPServer::CTCPClient::GetEvents()
+{
+  CSingleLock lock (m_critSection);
+  int events = 0;
+  if (!IsCongested() && m_responses.size() < MAXPENDINGRESPONSES)
+    events |= SocketEventRead;
+  if (m_error || !m_output.empty() || !m_responses.empty())
+    events |= SocketEventWrite;
+
+  return events;
+}
+
 void CTCPServer::CTCPClient::Disconnect()
 {
   if (m_socket > 0)
@@ -590,9 +868,20 @@ void CTCPServer::CTCPClient::Disconnect()
 void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
 {
   m_new               = client.m_new;
+  m_error             = client.m_error;
   m_socket            = client.m_socket;
   m_cliaddr           = client.m_cliaddr;
   m_addrlen           = client.m_addrlen;
+  m_events            = client.m_events;
+  m_registered        = client.m_registered;
+  m_output            = client.m_output;
+  m_outputOffset      = client.m_outputOffset;
+  m_outputSize        = client.m_outputSize;
+  m_delayedOutput     = client.m_delayedOutput;
+  m_delayedSize       = client.m_delayedSize;
+  // pending responses are owned by the original client
+  m_responseActive    = false;
+  m_dropped           = client.m_dropped;
   m_announcementflags = client.m_announcementflags;
   m_beginBrackets     = client.m_beginBrackets;
   m_endBrackets       = client.m_endBrackets;
@@ -601,6 +890,64 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_buffer            = client.m_buffer;
 }
 
+bool CTCPServer::CTCPClient::IsCongested() const
+{
+  return m_outputSize + m_delayedSize >= (size_t)g_advancedSettings.m_jsonTcpQueueSize * 1024;
+}
+
+void CTCPServer::CTCPClient::Queue(const OutputBuffer &data, bool notification)
+{
+  CSingleLock lock (m_critSection);
+
+  // a notification must not end up in the middle of a response
+  if (notification && m_responseActive)
+  {
+    m_delayedOutput.push_back(data);
+    m_delayedSize += data->size();
+    return;
+  }
+
+  m_output.push_back(data);
+  m_outputSize += data->size();
+  Write();
+}
+
+bool CTCPServer::CTCPClient::Write()
+{
+  while (!m_error && !m_output.empty())
+  {
+    const std::string &data = *m_output.front();
+    int ret = send(m_socket, data.c_str() + m_outputOffset, data.size() - m_outputOffset, 0);
+    if (ret < 0)
+    {
+      if (SocketWouldBlock())
+        return true;
+
+      m_error = true;
+      break;
+    }
+
+    m_outputOffset += ret;
+    m_outputSize -= ret;
+    if (m_outputOffset >= data.size())
+    {
+      m_output.pop_front();
+      m_outputOffset = 0;
+    }
+  }
+
+  if (m_error)
+    return false;
+
+  if (m_dropped > 0 && m_output.empty())
+  {
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client caught up again, %u notifications have been dropped", m_dropped);
+    m_dropped = 0;
+  }
+
+  return true;
+}
+
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
 {
   m_websocket = websocket;
@@ -668,6 +1015,27 @@ void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buff
     Disconnect();
 }
 
+bool CTCPServer::CWebSocketClient::Notify(const OutputBuffer &notification)
+{
+  // every message has to be framed for the websocket so the notification
+  // can't be shared with other clients
+  CSingleLock lock (m_critSection);
+  if (IsCongested())
+    return false;
+
+  Send(notification->c_str(), notification->size());
+  return true;
+}
+
+void CTCPServer::CWebSocketClient::SendResponse(CJSONRPCResponseStream *response)
+{
+  // every response has to go out as one websocket message
+  std::string output;
+  response->ReadAll(output);
+  delete response;
+  Send(output.c_str(), output.size());
+}
+
 void CTCPServer::CWebSocketClient::Disconnect()
 {
   if (m_socket > 0)
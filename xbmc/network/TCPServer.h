@@ -19,8 +19,10 @@
  *
  */
 
+#include <deque>
 #include <vector>
 #include <sys/socket.h>
+#include <boost/shared_ptr.hpp>
 
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
@@ -31,9 +33,13 @@
 
 namespace JSONRPC
 {
+  class CJSONRPCResponseStream;
+
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
   {
   public:
+    typedef boost::shared_ptr<const std::string> OutputBuffer;
+
     static bool StartServer(int port, bool nonlocal);
     static void StopServer(bool bWait);
 
@@ -51,6 +57,25 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    enum SocketEvents
+    {
+      SocketEventRead  = 0x1,
+      SocketEventWrite = 0x2
+    };
+
+    class CTCPClient;
+
+    /*!
+     \brief Waits until any of the sockets becomes readable or writable
+     \return False if waiting failed, true otherwise (also on timeout)
+     */
+    bool WaitForEvents(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable, unsigned int timeout);
+    void UpdateEvents(CTCPClient *client);
+    int  FindConnection(SOCKET socket) const;
+    void AcceptConnection(SOCKET server);
+    void HandleConnection(unsigned int index);
+    void CloseConnection(unsigned int index);
+
     class CTCPClient : public IClient
     {
     public:
@@ -59,7 +84,7 @@ namespace JSONRPC
       //when adding a member variable, make sure to copy it in CTCPClient::Copy
       CTCPClient(const CTCPClient& client);
       CTCPClient& operator=(const CTCPClient& client);
-      virtual ~CTCPClient() { };
+      virtual ~CTCPClient();
 
       virtual int  GetPermissionFlags();
       virtual int  GetAnnouncementFlags();
@@ -69,6 +94,32 @@ namespace JSONRPC
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
+      /*!
+       \brief Queues a notification which is shared with all other clients
+       \return False if the notification has been dropped because the client
+       does not read the data already queued for it
+       */
+      virtual bool Notify(const OutputBuffer &notification);
+
+      /*!
+       \brief Sends the given response, takes ownership of it
+       */
+      virtual void SendResponse(JSONRPC::CJSONRPCResponseStream *response);
+
+      /*!
+       \brief Writes as much of the queued output as the socket accepts
+       without blocking
+       \param readResponses Whether to continue serializing pending responses
+       (only allowed on the server thread)
+       \return False if the connection failed
+       */
+      bool Flush(bool readResponses);
+
+      /*!
+       \brief Returns the socket events the client is waiting for
+       */
+      int  GetEvents();
+
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
@@ -76,11 +127,26 @@ namespace JSONRPC
       sockaddr_storage m_cliaddr;
       socklen_t        m_addrlen;
       CCriticalSection m_critSection;
+      int              m_events;
+      bool             m_registered;
 
     protected:
       void Copy(const CTCPClient& client);
+      bool IsCongested() const;
+      void Queue(const OutputBuffer &data, bool notification);
     private:
+      bool Write();
+
       bool m_new;
+      bool m_error;
+      std::deque<OutputBuffer> m_output;
+      size_t m_outputOffset;
+      size_t m_outputSize;
+      std::deque<OutputBuffer> m_delayedOutput;
+      size_t m_delayedSize;
+      std::deque<JSONRPC::CJSONRPCResponseStream*> m_responses;
+      bool m_responseActive;
+      unsigned int m_dropped;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
@@ -100,6 +166,9 @@ namespace JSONRPC
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
+      virtual bool Notify(const OutputBuffer &notification);
+      virtual void SendResponse(JSONRPC::CJSONRPCResponseStream *response);
+
       virtual bool IsNew() const { return m_websocket == NULL; }
       virtual bool Closing() const { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
@@ -108,7 +177,9 @@ namespace JSONRPC
     };
 
     std::vector<CTCPClient*> m_connections;
+    CCriticalSection m_connectionsSection;
     std::vector<SOCKET> m_servers;
+    int m_epoll;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
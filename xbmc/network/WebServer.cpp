@@ -20,8 +20,15 @@
 
 #include "WebServer.h"
 #ifdef HAS_WEB_SERVER
+#ifdef _LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
+#include "utils/HttpRangeUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/Base64.h"
@@ -37,12 +44,19 @@
 
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
+#define SERVICE_UNAVAILABLE "<html><head><title>Service Unavailable</title></head><body>The server is busy handling other requests, please try again later</body></html>"
+
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN ((uint64_t) -1LL)
+#endif
 
 using namespace XFILE;
 using namespace std;
 using namespace JSONRPC;
 
 vector<IHTTPRequestHandler *> CWebServer::m_requestHandlers;
+map<IHTTPRequestHandler *, unsigned int> CWebServer::m_activeRequests;
+CCriticalSection CWebServer::m_activeRequestsSection;
 
 CWebServer::CWebServer()
 {
@@ -136,15 +150,26 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
       IHTTPRequestHandler *requestHandler = *it;
       if (requestHandler->CheckHTTPRequest(request))
       {
+        // Don't let slow handlers (e.g. file transfers)
+        // take up all the available threads
+        if (!AcquireRequestSlot(requestHandler))
+          return SendErrorResponse(connection, MHD_HTTP_SERVICE_UNAVAILABLE, methodType);
+
         // We found a matching IHTTPRequestHandler
         // so let's get a new instance for this request
         IHTTPRequestHandler *handler = requestHandler->GetInstance();
 
+        // The connection handler is kept until the request has been
+        // completed (see RequestCompleted) so that the request slot
+        // is only released after the whole response has been sent
+        ConnectionHandler *conHandler = new ConnectionHandler();
+        conHandler->slotHandler = requestHandler;
+        *con_cls = (void*)conHandler;
+
         // If we got a POST request we need to take
         // care of the POST data
         if (methodType == POST)
         {
-          ConnectionHandler *conHandler = new ConnectionHandler();
           conHandler->requestHandler = handler;
 
           // Get the content-type of the POST data
@@ -164,7 +189,7 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
               if (conHandler->postprocessor == NULL)
               {
                 delete conHandler->requestHandler;
-                delete conHandler;
+                conHandler->requestHandler = NULL;
 
                 return SendErrorResponse(connection, MHD_HTTP_INTERNAL_SERVER_ERROR, methodType);
               }
@@ -173,7 +198,6 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
           // otherwise we need to handle the POST data ourselves
           // which is done in the next call to AnswerToConnection
 
-          *con_cls = (void*)conHandler;
           return MHD_YES;
         }
         // No POST request so nothing special to handle
@@ -215,12 +239,16 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
       else
       {
         if (conHandler->postprocessor != NULL)
+        {
           MHD_destroy_post_processor(conHandler->postprocessor);
-        *con_cls = NULL;
+          conHandler->postprocessor = NULL;
+        }
+
+        // HandleRequest() takes care of deleting the request handler
+        IHTTPRequestHandler *handler = conHandler->requestHandler;
+        conHandler->requestHandler = NULL;
 
-        int ret = HandleRequest(conHandler->requestHandler, request);
-        delete conHandler;
-        return ret;
+        return HandleRequest(handler, request);
       }
     }
     // It's unusual to get more than one call
@@ -261,6 +289,50 @@ int CWebServer::HandlePostField(void *cls, enum MHD_ValueKind kind, const char *
   return MHD_YES;
 }
 
+void CWebServer::RequestCompleted(void *cls, struct MHD_Connection *connection, void **con_cls, enum MHD_RequestTerminationCode toe)
+{
+  if (con_cls == NULL || *con_cls == NULL)
+    return;
+
+  ConnectionHandler *conHandler = (ConnectionHandler *)*con_cls;
+  *con_cls = NULL;
+
+  // the request might have been aborted before it could be handled
+  if (conHandler->postprocessor != NULL)
+    MHD_destroy_post_processor(conHandler->postprocessor);
+  delete conHandler->requestHandler;
+
+  ReleaseRequestSlot(conHandler->slotHandler);
+  delete conHandler;
+}
+
+bool CWebServer::AcquireRequestSlot(IHTTPRequestHandler *handler)
+{
+  CSingleLock lock(m_activeRequestsSection);
+  unsigned int &activeRequests = m_activeRequests[handler];
+
+  unsigned int maximumRequests = handler->GetMaximumConcurrentRequests();
+  if (maximumRequests > 0 && activeRequests >= maximumRequests)
+  {
+    CLog::Log(LOGDEBUG, "WebServer: rejecting request because %u requests are already being handled by the same handler", activeRequests);
+    return false;
+  }
+
+  activeRequests++;
+  return true;
+}
+
+void CWebServer::ReleaseRequestSlot(IHTTPRequestHandler *handler)
+{
+  if (handler == NULL)
+    return;
+
+  CSingleLock lock(m_activeRequestsSection);
+  map<IHTTPRequestHandler *, unsigned int>::iterator it = m_activeRequests.find(handler);
+  if (it != m_activeRequests.end() && it->second > 0)
+    it->second--;
+}
+
 int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request)
 {
   if (handler == NULL)
@@ -305,6 +377,10 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       ret = CreateMemoryDownloadResponse(request.connection, handler->GetHTTPResponseData(), handler->GetHTTPResonseDataLength(), true, true, response);
       break;
 
+    case HTTPStreamedDownload:
+      ret = CreateStreamedDownloadResponse(request.connection, handler->GetHTTPResponseStream(), response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, handler->GetHTTPResonseCode(), request.method, response);
       break;
@@ -360,44 +436,130 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
 
   if (file->Open(strURL, READ_NO_CACHE))
   {
+    uint64_t fileLength = (uint64_t)file->GetLength();
+
+    // get the modification time of the file for conditional requests
+    bool hasLastModified = false;
+    CDateTime lastModified;
+    string etag;
+    struct __stat64 statBuffer;
+    if (file->Stat(&statBuffer) == 0)
+    {
+      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
+      if (time != NULL)
+      {
+        lastModified = *time;
+        hasLastModified = true;
+      }
+
+      etag = CreateETag((uint64_t)statBuffer.st_mtime, fileLength);
+    }
+
     bool getData = true;
+    uint64_t rangeFirst = 0, rangeLast = fileLength > 0 ? fileLength - 1 : 0;
+    bool ranged = false;
     if (methodType != HEAD)
     {
       if (methodType == GET)
       {
-        string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
-        if (!ifModifiedSince.empty())
+        // If-None-Match takes precedence over If-Modified-Since
+        string ifNoneMatch = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-None-Match");
+        if (!ifNoneMatch.empty())
+        {
+          if (!etag.empty() && (ifNoneMatch == "*" || ifNoneMatch.find(etag) != string::npos))
+            getData = false;
+        }
+        else
         {
-          CDateTime ifModifiedSinceDate;
-          ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
+          string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
+          if (!ifModifiedSince.empty() && hasLastModified)
+          {
+            CDateTime ifModifiedSinceDate;
+            ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
+
+            if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
+              getData = false;
+          }
+        }
 
-          struct __stat64 statBuffer;
-          if (file->Stat(&statBuffer) == 0)
+        if (!getData)
+        {
+          response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+          responseCode = MHD_HTTP_NOT_MODIFIED;
+        }
+        else
+        {
+          string range = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "Range");
+          // a range is only valid for the version of the file given in If-Range
+          string ifRange = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Range");
+          if (!range.empty() && !ifRange.empty() && ifRange != etag &&
+              (!hasLastModified || ifRange != lastModified.GetAsRFC1123DateTime()))
+            range.clear();
+
+          if (!range.empty())
           {
-            struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-            if (time != NULL)
+            HttpRangeResult rangeResult = HttpRangeUtils::ParseRange(range, fileLength, rangeFirst, rangeLast);
+            if (rangeResult == HttpRangeUnsatisfiable)
             {
-              CDateTime lastModified = *time;
-              if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
-              {
-                getData = false;
-                response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
-                responseCode = MHD_HTTP_NOT_MODIFIED;
-              }
+              getData = false;
+              response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+              if (response != NULL)
+                MHD_add_response_header(response, "Content-Range", HttpRangeUtils::GetUnsatisfiableContentRange(fileLength).c_str());
+              responseCode = MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
             }
+            else if (rangeResult == HttpRangeSatisfiable)
+              ranged = true;
           }
         }
       }
 
       if (getData)
-        response = MHD_create_response_from_callback(file->GetLength(),
-                                                     2048,
-                                                     &CWebServer::ContentReaderCallback, file,
-                                                     &CWebServer::ContentReaderFreeCallback);
+      {
+        uint64_t length = fileLength > 0 ? rangeLast - rangeFirst + 1 : 0;
+
+#if defined(_LINUX) && (MHD_VERSION >= 0x00090600)
+        // local files are handed to libmicrohttpd as a file descriptor
+        // so that it can send them without copying (using sendfile)
+        int fd = OpenLocalFile(strURL, length);
+        if (fd >= 0)
+        {
+          response = MHD_create_response_from_fd_at_offset((size_t)length, fd, (off_t)rangeFirst);
+          if (response == NULL)
+            close(fd);
+
+          file->Close();
+          delete file;
+          file = NULL;
+        }
+        else
+#endif
+        {
+          FileDownload *download = new FileDownload();
+          download->file = file;
+          download->offset = rangeFirst;
+
+          response = MHD_create_response_from_callback(length,
+                                                       32 * 1024,
+                                                       &CWebServer::ContentReaderCallback, download,
+                                                       &CWebServer::ContentReaderFreeCallback);
+          if (response == NULL)
+            delete download;
+        }
+
+        if (response != NULL && ranged)
+        {
+          MHD_add_response_header(response, "Content-Range", HttpRangeUtils::GetContentRange(rangeFirst, rangeLast, fileLength).c_str());
+          responseCode = MHD_HTTP_PARTIAL_CONTENT;
+        }
+      }
+
       if (response == NULL)
       {
-        file->Close();
-        delete file;
+        if (file != NULL)
+        {
+          file->Close();
+          delete file;
+        }
         return MHD_NO;
       }
     }
@@ -418,6 +580,8 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       MHD_add_response_header(response, "Content-Length", contentLength);
     }
 
+    MHD_add_response_header(response, "Accept-Ranges", "bytes");
+
     // set the Content-Type header
     CStdString ext = URIUtils::GetExtension(strURL);
     ext = ext.ToLower();
@@ -425,17 +589,11 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
     if (mime)
       MHD_add_response_header(response, "Content-Type", mime);
 
-    // set the Last-Modified header
-    struct __stat64 statBuffer;
-    if (file->Stat(&statBuffer) == 0)
-    {
-      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-      if (time != NULL)
-      {
-        CDateTime lastModified = *time;
-        MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
-      }
-    }
+    // set the Last-Modified and ETag headers
+    if (hasLastModified)
+      MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
+    if (!etag.empty())
+      MHD_add_response_header(response, "ETag", etag.c_str());
 
     // set the Expires header
     CDateTime expiryTime = CDateTime::GetCurrentDateTime();
@@ -461,6 +619,31 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   return MHD_YES;
 }
 
+int CWebServer::OpenLocalFile(const string &strURL, uint64_t length)
+{
+#if defined(_LINUX) && (MHD_VERSION >= 0x00090600)
+  // the length of a file descriptor response is limited to size_t
+  if ((uint64_t)(size_t)length != length)
+    return -1;
+
+  // only plain local files can be sent from a file descriptor
+  CStdString path = CSpecialProtocol::TranslatePath(strURL);
+  if (path.empty() || path[0] != '/')
+    return -1;
+
+  return open(path.c_str(), O_RDONLY);
+#else
+  return -1;
+#endif
+}
+
+string CWebServer::CreateETag(uint64_t lastModified, uint64_t size)
+{
+  CStdString etag;
+  etag.Format("\"%"PRIx64"-%"PRIx64"\"", lastModified, size);
+  return etag;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -478,6 +661,10 @@ int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int respo
         payloadSize = strlen(NOT_SUPPORTED);
         payload = (void *)NOT_SUPPORTED;
         break;
+      case MHD_HTTP_SERVICE_UNAVAILABLE:
+        payloadSize = strlen(SERVICE_UNAVAILABLE);
+        payload = (void *)SERVICE_UNAVAILABLE;
+        break;
     }
   }
 
@@ -495,6 +682,23 @@ int CWebServer::CreateMemoryDownloadResponse(struct MHD_Connection *connection,
   return MHD_NO;
 }
 
+int CWebServer::CreateStreamedDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response)
+{
+  if (stream == NULL)
+    return MHD_NO;
+
+  // the length isn't known up front so the response is sent chunked
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN,
+                                               16384,
+                                               &CWebServer::StreamReaderCallback, stream,
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response)
+    return MHD_YES;
+
+  delete stream;
+  return MHD_NO;
+}
+
 int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method)
 {
   struct MHD_Response *response = NULL;
@@ -522,10 +726,11 @@ int CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, int ma
 int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
 {
-  CFile *file = (CFile *)cls;
-  if((unsigned int)pos != file->GetPosition())
-    file->Seek(pos);
-  unsigned res = file->Read(buf, max);
+  FileDownload *download = (FileDownload *)cls;
+  int64_t position = (int64_t)(download->offset + pos);
+  if (position != download->file->GetPosition())
+    download->file->Seek(position);
+  unsigned res = download->file->Read(buf, max);
   if(res == 0)
     return -1;
   return res;
@@ -533,13 +738,34 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
-  CFile *file = (CFile *)cls;
-  file->Close();
+  FileDownload *download = (FileDownload *)cls;
+  download->file->Close();
 
-  delete file;
+  delete download->file;
+  delete download;
 }
 
-struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  IHTTPResponseStream *stream = (IHTTPResponseStream *)cls;
+  size_t res = stream->Read(buf, max);
+  if (res == 0)
+    return -1;
+  return res;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  delete (IHTTPResponseStream *)cls;
+}
+
+struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port, unsigned int threads)
 {
   // WARNING: when using MHD_USE_THREAD_PER_CONNECTION, set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
   // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
@@ -555,10 +781,11 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 #if (MHD_VERSION >= 0x00040002)
-                          MHD_OPTION_THREAD_POOL_SIZE, 4,
+                          MHD_OPTION_THREAD_POOL_SIZE, threads,
 #endif
                           MHD_OPTION_CONNECTION_LIMIT, 512,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
+                          MHD_OPTION_NOTIFY_COMPLETED, &CWebServer::RequestCompleted, this,
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
                           MHD_OPTION_END);
 }
@@ -568,7 +795,21 @@ bool CWebServer::Start(int port, const string &username, const string &password)
   SetCredentials(username, password);
   if (!m_running)
   {
-    m_daemon = StartMHD(MHD_USE_SELECT_INTERNALLY, port);
+    unsigned int flags = MHD_USE_SELECT_INTERNALLY;
+    unsigned int threads = g_advancedSettings.m_webserverThreads;
+    // a thread pool can't be combined with one thread per connection
+    if (threads == 0)
+      flags = MHD_USE_THREAD_PER_CONNECTION;
+#if defined(TARGET_LINUX) && (MHD_VERSION >= 0x00092000)
+    else if (g_advancedSettings.m_webserverUseEpoll)
+      flags |= MHD_USE_EPOLL_LINUX_ONLY;
+#endif
+
+    if (threads == 0)
+      CLog::Log(LOGDEBUG, "WebServer: starting the webserver with one thread per connection");
+    else
+      CLog::Log(LOGDEBUG, "WebServer: starting the webserver with %u threads", threads);
+    m_daemon = StartMHD(flags, port, threads);
 
     m_running = m_daemon != NULL;
     if (m_running)
@@ -28,11 +28,17 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <map>
 #include <vector>
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
 #include "httprequesthandler/IHTTPRequestHandler.h"
 
+namespace XFILE
+{
+  class CFile;
+}
+
 class CWebServer : public JSONRPC::ITransportLayer
 {
 public:
@@ -55,7 +61,7 @@ public:
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::map<std::string, std::string> &headerValues);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::multimap<std::string, std::string> &headerValues);
 private:
-  struct MHD_Daemon* StartMHD(unsigned int flags, int port);
+  struct MHD_Daemon* StartMHD(unsigned int flags, int port, unsigned int threads);
   static int AskForAuthentication (struct MHD_Connection *connection);
   static bool IsAuthenticated (CWebServer *server, struct MHD_Connection *connection);
 
@@ -88,12 +94,26 @@ private:
                              const char *transfer_encoding, const char *data, uint64_t off,
                              unsigned int size);
 #endif
+  static void RequestCompleted(void *cls, struct MHD_Connection *connection, void **con_cls, enum MHD_RequestTerminationCode toe);
+  static bool AcquireRequestSlot(IHTTPRequestHandler *handler);
+  static void ReleaseRequestSlot(IHTTPRequestHandler *handler);
   static int HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request);
   static void ContentReaderFreeCallback (void *cls);
+#if (MHD_VERSION >= 0x00090200)
+  static ssize_t StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
+#elif (MHD_VERSION >= 0x00040001)
+  static int StreamReaderCallback (void *cls, uint64_t pos, char *buf, int max);
+#else
+  static int StreamReaderCallback (void *cls, size_t pos, char *buf, int max);
+#endif
+  static void StreamReaderFreeCallback (void *cls);
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
   static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
+  static int OpenLocalFile(const std::string &strURL, uint64_t length);
+  static std::string CreateETag(uint64_t lastModified, uint64_t size);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
+  static int CreateStreamedDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response);
 
   static int SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method);
   
@@ -108,11 +128,22 @@ private:
   std::string m_Credentials64Encoded;
   CCriticalSection m_critSection;
   static std::vector<IHTTPRequestHandler *> m_requestHandlers;
+  static std::map<IHTTPRequestHandler *, unsigned int> m_activeRequests;
+  static CCriticalSection m_activeRequestsSection;
 
   typedef struct ConnectionHandler
   {
     IHTTPRequestHandler *requestHandler;
     struct MHD_PostProcessor *postprocessor;
+    // registered handler whose request slot is taken by the request
+    IHTTPRequestHandler *slotHandler;
   } ConnectionHandler;
+
+  typedef struct FileDownload
+  {
+    XFILE::CFile *file;
+    // position of the first byte of the response within the file
+    uint64_t offset;
+  } FileDownload;
 };
 #endif
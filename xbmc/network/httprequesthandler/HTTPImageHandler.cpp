@@ -21,7 +21,9 @@
 #include "HTTPImageHandler.h"
 #include "network/WebServer.h"
 #include "URL.h"
+#include "TextureCache.h"
 #include "filesystem/ImageFile.h"
+#include "settings/AdvancedSettings.h"
 
 using namespace std;
 
@@ -39,6 +41,13 @@ int CHTTPImageHandler::HandleHTTPRequest(const HTTPRequest &request)
     XFILE::CImageFile imageFile;
     if (imageFile.Exists(m_path))
     {
+      // serve an already cached image directly from the cache so
+      // that it can be sent as a local file
+      bool needsRecaching = false;
+      CStdString cachedFile = CTextureCache::Get().CheckCachedImage(m_path, false, needsRecaching);
+      if (!cachedFile.IsEmpty())
+        m_path = cachedFile;
+
       m_responseCode = MHD_HTTP_OK;
       m_responseType = HTTPFileDownload;
     }
@@ -56,3 +65,8 @@ int CHTTPImageHandler::HandleHTTPRequest(const HTTPRequest &request)
 
   return MHD_YES;
 }
+
+unsigned int CHTTPImageHandler::GetMaximumConcurrentRequests() const
+{
+  return g_advancedSettings.m_webserverMaxImageRequests;
+}
@@ -27,10 +27,17 @@
 #include "utils/log.h"
 
 #define MAX_STRING_POST_SIZE 20000
+// responses up to this size are sent in one piece, bigger ones are streamed
+#define MAX_STRING_RESPONSE_SIZE 65536
 
 using namespace std;
 using namespace JSONRPC;
 
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  delete m_responseStream;
+}
+
 bool CHTTPJsonRpcHandler::CheckHTTPRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -67,8 +74,28 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
     }
   }
 
+  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+
   if (isRequest)
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+  {
+    CJSONRPCResponseStream *stream = CJSONRPC::MethodCallStream(m_request, request.webserver, &client);
+    if (stream != NULL)
+    {
+      m_response.resize(MAX_STRING_RESPONSE_SIZE);
+      size_t size = stream->Read(&m_response[0], m_response.size());
+      if (size < m_response.size())
+      {
+        m_response.resize(size);
+        delete stream;
+      }
+      else
+      {
+        m_responseStream = new CResponseStream(m_response, stream);
+        m_response.clear();
+        m_responseType = HTTPStreamedDownload;
+      }
+    }
+  }
   else
   {
     // get the whole output of JSONRPC.Introspect
@@ -80,13 +107,20 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
   m_responseHeaderFields.insert(pair<string, string>("Content-Type", "application/json"));
 
   m_request.clear();
-  
-  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+
   m_responseCode = MHD_HTTP_OK;
 
   return MHD_YES;
 }
 
+IHTTPResponseStream* CHTTPJsonRpcHandler::GetHTTPResponseStream()
+{
+  IHTTPResponseStream *stream = m_responseStream;
+  m_responseStream = NULL;
+
+  return stream;
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
@@ -104,6 +138,33 @@ bool CHTTPJsonRpcHandler::appendPostData(const char *data, unsigned int size)
   return true;
 }
 
+CHTTPJsonRpcHandler::CResponseStream::CResponseStream(const std::string &head, CJSONRPCResponseStream *stream)
+  : m_head(head),
+    m_offset(0),
+    m_stream(stream)
+{ }
+
+CHTTPJsonRpcHandler::CResponseStream::~CResponseStream()
+{
+  delete m_stream;
+}
+
+size_t CHTTPJsonRpcHandler::CResponseStream::Read(char *buffer, size_t size)
+{
+  size_t read = 0;
+  if (m_offset < m_head.size())
+  {
+    read = min(size, m_head.size() - m_offset);
+    memcpy(buffer, m_head.c_str() + m_offset, read);
+    m_offset += read;
+  }
+
+  if (read < size)
+    read += m_stream->Read(buffer + read, size - read);
+
+  return read;
+}
+
 int CHTTPJsonRpcHandler::CHTTPClient::GetPermissionFlags()
 {
   return OPERATION_PERMISSION_ALL;
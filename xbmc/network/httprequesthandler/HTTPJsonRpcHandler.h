@@ -22,10 +22,16 @@
 #include "IHTTPRequestHandler.h"
 #include "interfaces/json-rpc/IClient.h"
 
+namespace JSONRPC
+{
+  class CJSONRPCResponseStream;
+}
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { };
+  CHTTPJsonRpcHandler() : m_responseStream(NULL) { };
+  virtual ~CHTTPJsonRpcHandler();
   
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPJsonRpcHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
@@ -33,6 +39,7 @@ public:
 
   virtual void* GetHTTPResponseData() const { return (void *)m_response.c_str(); };
   virtual size_t GetHTTPResonseDataLength() const { return m_response.size(); }
+  virtual IHTTPResponseStream* GetHTTPResponseStream();
 
   virtual int GetPriority() const { return 2; }
 
@@ -46,6 +53,21 @@ protected:
 private:
   std::string m_request;
   std::string m_response;
+  IHTTPResponseStream *m_responseStream;
+
+  class CResponseStream : public IHTTPResponseStream
+  {
+  public:
+    CResponseStream(const std::string &head, JSONRPC::CJSONRPCResponseStream *stream);
+    virtual ~CResponseStream();
+
+    virtual size_t Read(char *buffer, size_t size);
+
+  private:
+    std::string m_head;
+    size_t m_offset;
+    JSONRPC::CJSONRPCResponseStream *m_stream;
+  };
 
   class CHTTPClient : public JSONRPC::IClient
   {
@@ -23,6 +23,7 @@
 #include "URL.h"
 #include "filesystem/File.h"
 #include "network/WebServer.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/URIUtils.h"
 
@@ -107,3 +108,8 @@ int CHTTPVfsHandler::HandleHTTPRequest(const HTTPRequest &request)
 
   return MHD_YES;
 }
+
+unsigned int CHTTPVfsHandler::GetMaximumConcurrentRequests() const
+{
+  return g_advancedSettings.m_webserverMaxFileTransfers;
+}
@@ -35,6 +35,7 @@ public:
   virtual std::string GetHTTPResponseFile() const { return m_path; }
 
   virtual int GetPriority() const { return 2; }
+  virtual unsigned int GetMaximumConcurrentRequests() const;
 
 private:
   CStdString m_path;
@@ -50,7 +50,8 @@ enum HTTPResponseType
   HTTPMemoryDownloadNoFreeNoCopy,
   HTTPMemoryDownloadNoFreeCopy,
   HTTPMemoryDownloadFreeNoCopy,
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  HTTPStreamedDownload
 };
 
 typedef struct HTTPRequest
@@ -62,6 +63,20 @@ typedef struct HTTPRequest
   CWebServer *webserver;
 } HTTPRequest;
 
+/*!
+ \brief Body of a response which is generated while it is sent
+ */
+class IHTTPResponseStream
+{
+public:
+  virtual ~IHTTPResponseStream() { }
+
+  /*!
+   \return Number of bytes written into buffer, 0 at the end of the response
+   */
+  virtual size_t Read(char *buffer, size_t size) = 0;
+};
+
 class IHTTPRequestHandler
 {
 public:
@@ -75,9 +90,13 @@ public:
   virtual size_t GetHTTPResonseDataLength() const { return 0; }
   virtual std::string GetHTTPRedirectUrl() const { return ""; }
   virtual std::string GetHTTPResponseFile() const { return ""; }
+  // The caller takes over the ownership of the returned stream
+  virtual IHTTPResponseStream* GetHTTPResponseStream() { return NULL; }
 
   // The higher the more important
   virtual int GetPriority() const { return 0; }
+  // Maximum number of requests handled at the same time (0 = unlimited)
+  virtual unsigned int GetMaximumConcurrentRequests() const { return 0; }
 
   void AddPostField(const std::string &key, const std::string &value);
 #if (MHD_VERSION >= 0x00040001)
@@ -56,6 +56,9 @@ void CAdvancedSettings::Initialize()
   m_allChannelStereo = false;
   m_streamSilence = false;
   m_audioSinkBufferDurationMsec = 50;
+  m_audioDecodeAhead = 10;
+  m_audioRenderCacheSize = 0;
+  m_audioRenderCachePrefetch = 2;
 
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
@@ -104,6 +107,7 @@ void CAdvancedSettings::Initialize()
   m_videoAutoScaleMaxFps = 30.0f;
   m_videoAllowMpeg4VDPAU = false;
   m_videoAllowMpeg4VAAPI = false;  
+  m_videoDemuxReadAhead = 4096;
   m_videoDisableBackgroundDeinterlace = false;
   m_videoCaptureUseOcclusionQuery = -1; //-1 is auto detect
   m_DXVACheckCompatibility = false;
@@ -192,6 +196,11 @@ void CAdvancedSettings::Initialize()
 
   m_bHTTPDirectoryStatFilesize = false;
 
+  m_webserverThreads = 4;
+  m_webserverUseEpoll = false;
+  m_webserverMaxFileTransfers = 3;
+  m_webserverMaxImageRequests = 3;
+
   m_bFTPThumbs = false;
 
   m_musicThumbs = "folder.jpg|Folder.jpg|folder.JPG|Folder.JPG|cover.jpg|Cover.jpg|cover.jpeg|thumb.jpg|Thumb.jpg|thumb.JPG|Thumb.JPG";
@@ -205,6 +214,8 @@ void CAdvancedSettings::Initialize()
   m_strMusicLibraryAlbumFormatRight = "";
   m_prioritiseAPEv2tags = false;
   m_musicItemSeparator = " / ";
+  m_bMusicLibraryAnalyzeReplayGain = false;
+  m_musicLibraryReplayGainThreads = 0;
   m_videoItemSeparator = " / ";
 
   m_bVideoLibraryHideAllItems = false;
@@ -306,6 +317,13 @@ void CAdvancedSettings::Initialize()
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_jsonCacheValidation = true;
+  m_jsonTcpQueueSize = 1024;
+
+  m_announceAsynchronous = true;
+  m_announceCoalesceWindow = 250;
+  m_announceRateLimit = 0;
+  m_announceQueueSize = 1000;
 
   m_enableMultimediaKeys = false;
 
@@ -313,6 +331,8 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiDirtyRegionNoFlipTimeout = 0;
+  m_guiTextureUploadBudget = 8192;
+  m_guiParallelItemLayout = false;
   m_enableNetworkManager  = false;
   m_showNetworkPassPhrase = true;
   m_logEnableAirtunes = false;
@@ -400,6 +420,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "streamsilence", m_streamSilence);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
     XMLUtils::GetInt(pElement, "audiosinkbufferdurationmsec", m_audioSinkBufferDurationMsec);
+    XMLUtils::GetUInt(pElement, "decodeahead", m_audioDecodeAhead, 2, 60);
+    XMLUtils::GetUInt(pElement, "rendercachesize", m_audioRenderCacheSize, 0, 1024 * 1024);
+    XMLUtils::GetUInt(pElement, "rendercacheprefetch", m_audioRenderCachePrefetch, 0, 20);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -502,6 +525,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetFloat(pElement,"autoscalemaxfps",m_videoAutoScaleMaxFps, 0.0f, 1000.0f);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vaapi",m_videoAllowMpeg4VAAPI);    
+    XMLUtils::GetInt(pElement, "demuxreadahead", m_videoDemuxReadAhead, 0, 65536);
     XMLUtils::GetBoolean(pElement, "disablebackgrounddeinterlace", m_videoDisableBackgroundDeinterlace);
     XMLUtils::GetInt(pElement, "useocclusionquery", m_videoCaptureUseOcclusionQuery, -1, 1);
 
@@ -642,6 +666,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
+    XMLUtils::GetBoolean(pElement, "analyzereplaygain", m_bMusicLibraryAnalyzeReplayGain);
+    XMLUtils::GetUInt(pElement, "replaygainthreads", m_musicLibraryReplayGainThreads, 0, 16);
   }
 
   pElement = pRootElement->FirstChildElement("videolibrary");
@@ -702,6 +728,17 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
+    XMLUtils::GetBoolean(pElement, "cachevalidation", m_jsonCacheValidation);
+    XMLUtils::GetUInt(pElement, "tcpqueuesize", m_jsonTcpQueueSize, 16, 65536);
+  }
+
+  pElement = pRootElement->FirstChildElement("announcements");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "asynchronous", m_announceAsynchronous);
+    XMLUtils::GetUInt(pElement, "coalescewindow", m_announceCoalesceWindow, 0, 10000);
+    XMLUtils::GetUInt(pElement, "ratelimit", m_announceRateLimit, 0, 1000);
+    XMLUtils::GetUInt(pElement, "queuesize", m_announceQueueSize, 1, 100000);
   }
 
   pElement = pRootElement->FirstChildElement("samba");
@@ -716,6 +753,30 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   if (pElement)
     XMLUtils::GetBoolean(pElement, "statfilesize", m_bHTTPDirectoryStatFilesize);
 
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+  {
+    // 0 = one thread per connection
+    XMLUtils::GetUInt(pElement, "threads", m_webserverThreads, 0, 64);
+    XMLUtils::GetBoolean(pElement, "epoll", m_webserverUseEpoll);
+    // 0 = unlimited, only with one thread per connection
+    XMLUtils::GetUInt(pElement, "maxfiletransfers", m_webserverMaxFileTransfers);
+    XMLUtils::GetUInt(pElement, "maximagerequests", m_webserverMaxImageRequests);
+
+    // file transfers and image requests must always leave one of the
+    // pool threads to JSON-RPC and the web interface
+    if (m_webserverThreads == 1)
+      m_webserverThreads = 2;
+    if (m_webserverThreads > 0)
+    {
+      unsigned int maxRequests = m_webserverThreads - 1;
+      if (m_webserverMaxFileTransfers == 0 || m_webserverMaxFileTransfers > maxRequests)
+        m_webserverMaxFileTransfers = maxRequests;
+      if (m_webserverMaxImageRequests == 0 || m_webserverMaxImageRequests > maxRequests)
+        m_webserverMaxImageRequests = maxRequests;
+    }
+  }
+
   pElement = pRootElement->FirstChildElement("ftp");
   if (pElement)
   {
@@ -1076,6 +1137,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetUInt(pElement, "textureuploadbudget",      m_guiTextureUploadBudget);
+    XMLUtils::GetBoolean(pElement, "parallelitemlayout",    m_guiParallelItemLayout);
   }
 
   // load in the GUISettings overrides:
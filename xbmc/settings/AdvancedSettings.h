@@ -110,6 +110,9 @@ class CAdvancedSettings
     bool m_allChannelStereo;
     bool m_streamSilence;
     int m_audioSinkBufferDurationMsec;
+    unsigned int m_audioDecodeAhead; ///< seconds of the next track PAPlayer opens and decodes ahead of a transition
+    unsigned int m_audioRenderCacheSize; ///< size limit of the rendered audio cache in MB, 0 disables it
+    unsigned int m_audioRenderCachePrefetch; ///< number of upcoming playlist items rendered to the cache
     CStdString m_audioTranscodeTo;
     float m_limiterHold;
     float m_limiterRelease;
@@ -154,6 +157,7 @@ class CAdvancedSettings
     float m_videoAutoScaleMaxFps;
     bool  m_videoAllowMpeg4VDPAU;
     bool  m_videoAllowMpeg4VAAPI;
+    int   m_videoDemuxReadAhead; // kB of packets read ahead of dvdplayer, 0 to read on the player thread
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
     float m_videoDefaultLatency;
@@ -232,6 +236,11 @@ class CAdvancedSettings
 
     bool m_bHTTPDirectoryStatFilesize;
 
+    unsigned int m_webserverThreads;
+    bool m_webserverUseEpoll;
+    unsigned int m_webserverMaxFileTransfers;
+    unsigned int m_webserverMaxImageRequests;
+
     bool m_bFTPThumbs;
 
     CStdString m_musicThumbs;
@@ -245,6 +254,8 @@ class CAdvancedSettings
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
     CStdString m_musicItemSeparator;
+    bool m_bMusicLibraryAnalyzeReplayGain; ///< analyze the loudness of new songs after a library update
+    unsigned int m_musicLibraryReplayGainThreads; ///< number of songs analyzed in parallel, 0 for half the cores
     CStdString m_videoItemSeparator;
     std::vector<CStdString> m_musicTagsFromFileFilters;
 
@@ -355,12 +366,21 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    unsigned int m_guiTextureUploadBudget; ///< KB of large textures handed out for GPU upload per frame, 0 for unlimited
+    bool m_guiParallelItemLayout;          ///< resolve the labels of container items coming into view on the job manager
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    bool m_jsonCacheValidation;
+    unsigned int m_jsonTcpQueueSize; ///< output (in kB) queued for a JSON-RPC TCP client before its notifications are dropped
+
+    bool m_announceAsynchronous;           ///< deliver announcements on a thread per announcer
+    unsigned int m_announceCoalesceWindow; ///< ms within which identical announcements are coalesced
+    unsigned int m_announceRateLimit;      ///< announcements delivered per second and announcer, 0 for unlimited
+    unsigned int m_announceQueueSize;      ///< announcements queued per announcer before the oldest are dropped
 
     bool m_enableMultimediaKeys;
     std::vector<CStdString> m_settingsFiles;
@@ -39,6 +39,7 @@
 CAppParamParser::CAppParamParser()
 {
   m_testmode = false;
+  m_benchmarkRealtime = false;
 }
 
 void CAppParamParser::Parse(const char* argv[], int nArgs)
@@ -105,6 +106,9 @@ void CAppParamParser::DisplayHelp()
   printf("  --debug\t\tEnable debug logging\n");
   printf("  --version\t\tPrint version information\n");
   printf("  --test\t\tEnable test mode. [FILE] required.\n");
+  printf("  --decode-benchmark=<file>\tDemux and decode <file> without a player, print timings as JSON and exit\n");
+  printf("  --benchmark-realtime\tPace the benchmark in real time instead of as fast as possible\n");
+  printf("  --benchmark-output=<file>\tWrite the benchmark results to <file> instead of stdout\n");
   printf("  --settings=<filename>\t\tLoads specified file after advancedsettings.xml replacing any settings specified\n");
   printf("  \t\t\t\tspecified file must exist in special://xbmc/system/\n");
   exit(0);
@@ -135,6 +139,12 @@ void CAppParamParser::ParseArg(const CStdString &arg)
     g_application.SetEnableLegacyRes(true);
   else if (arg == "--test")
     m_testmode = true;
+  else if (arg.substr(0, 19) == "--decode-benchmark=")
+    m_benchmarkFile = arg.substr(19);
+  else if (arg == "--benchmark-realtime")
+    m_benchmarkRealtime = true;
+  else if (arg.substr(0, 19) == "--benchmark-output=")
+    m_benchmarkOutput = arg.substr(19);
   else if (arg.substr(0, 11) == "--settings=")
     g_advancedSettings.AddSettingsFile(arg.substr(11));
   else if (arg.length() != 0 && arg[0] != '-')
@@ -26,9 +26,15 @@ class CAppParamParser
   public:
     CAppParamParser();
     void Parse(const char* argv[], int nArgs);
+    const CStdString &GetDecodeBenchmarkFile() const { return m_benchmarkFile; }
+    const CStdString &GetDecodeBenchmarkOutput() const { return m_benchmarkOutput; }
+    bool IsDecodeBenchmarkRealtime() const { return m_benchmarkRealtime; }
 
   private:
     bool m_testmode;
+    bool m_benchmarkRealtime;
+    CStdString m_benchmarkFile;
+    CStdString m_benchmarkOutput;
     CFileItemList m_playlist;
     void ParseArg(const CStdString &arg);
     void DisplayHelp();
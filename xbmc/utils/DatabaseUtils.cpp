@@ -545,7 +545,7 @@ bool DatabaseUtils::GetFieldValue(const dbiplus::field_value &fieldValue, CVaria
   return false;
 }
 
-bool DatabaseUtils::GetDatabaseResults(MediaType mediaType, const FieldList &fields, const std::auto_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results)
+bool DatabaseUtils::GetDatabaseResults(MediaType mediaType, const FieldList &fields, const std::auto_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results, bool projected /* = false */)
 {
   if (dataset->num_rows() == 0)
     return true;
@@ -565,13 +565,19 @@ bool DatabaseUtils::GetDatabaseResults(MediaType mediaType, const FieldList &fie
     return true;
   }
 
-  if (resultSet.record_header.size() < fields.size())
+  if (resultSet.record_header.size() < fields.size() + (projected ? 1 : 0))
     return false;
 
   std::vector<int> fieldIndexLookup;
   fieldIndexLookup.reserve(fields.size());
   for (FieldList::const_iterator it = fields.begin(); it != fields.end(); it++)
-    fieldIndexLookup.push_back(GetFieldIndex(*it, mediaType));
+  {
+    // a projected dataset starts with the item's ID
+    if (projected)
+      fieldIndexLookup.push_back(fieldIndexLookup.size() + 1);
+    else
+      fieldIndexLookup.push_back(GetFieldIndex(*it, mediaType));
+  }
 
   results.reserve(resultSet.records.size() + offset);
   for (unsigned int index = 0; index < resultSet.records.size(); index++)
@@ -654,6 +660,29 @@ bool DatabaseUtils::GetDatabaseResults(MediaType mediaType, const FieldList &fie
   return true;
 }
 
+std::string DatabaseUtils::BuildOrderClause(const FieldList &fields, MediaType mediaType, bool descending /* = false */)
+{
+  if (fields.empty())
+    return "";
+
+  std::ostringstream sql;
+  sql << " ORDER BY ";
+  for (FieldList::const_iterator it = fields.begin(); it != fields.end(); it++)
+  {
+    std::string field = GetField(*it, mediaType, DatabaseQueryPartOrderBy);
+    if (field.empty())
+      return "";
+
+    if (it != fields.begin())
+      sql << ", ";
+    sql << field;
+    if (descending)
+      sql << " DESC";
+  }
+
+  return sql.str();
+}
+
 std::string DatabaseUtils::BuildLimitClause(int end, int start /* = 0 */)
 {
   std::ostringstream sql;
@@ -158,7 +158,21 @@ public:
   static bool GetSelectFields(const Fields &fields, MediaType mediaType, FieldList &selectFields);
   
   static bool GetFieldValue(const dbiplus::field_value &fieldValue, CVariant &variantValue);
-  static bool GetDatabaseResults(MediaType mediaType, const FieldList &fields, const std::auto_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
+  /*!
+   \brief Retrieves the values of the given fields from every row of the dataset
+   \param mediaType Media type of the rows
+   \param fields Fields to retrieve
+   \param dataset Dataset containing the rows
+   \param results Receives the values of every row
+   \param projected Whether the dataset only consists of the item's ID followed
+   by the given fields (in that order) instead of all columns of the media type's view
+   */
+  static bool GetDatabaseResults(MediaType mediaType, const FieldList &fields, const std::auto_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results, bool projected = false);
 
+  /*!
+   \brief Builds an ORDER BY clause ordering by the given fields
+   \return The ORDER BY clause or an empty string if one of the fields can't be used for ordering
+   */
+  static std::string BuildOrderClause(const FieldList &fields, MediaType mediaType, bool descending = false);
   static std::string BuildLimitClause(int end, int start = 0);
 };
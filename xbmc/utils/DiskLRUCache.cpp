@@ -0,0 +1,192 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DiskLRUCache.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#include <set>
+#include <stdio.h>
+
+using namespace std;
+using namespace XFILE;
+
+#define DISK_CACHE_INDEX "index.txt"
+// touches that are kept in memory before the index is written
+#define DISK_CACHE_TOUCHES 16
+
+CDiskLRUCache::CDiskLRUCache(const string &path, int64_t maxSize)
+  : m_path(path), m_maxSize(maxSize), m_loaded(false), m_sequence(0), m_touched(0)
+{
+}
+
+string CDiskLRUCache::GetEntryPath(const string &name)
+{
+  // loading removes files that are not in the index, so it has to happen
+  // before anyone writes an entry
+  CSingleLock lock(m_critSection);
+  Load();
+  return m_path + name;
+}
+
+bool CDiskLRUCache::Has(const string &name)
+{
+  CSingleLock lock(m_critSection);
+  Load();
+  return m_entries.find(name) != m_entries.end();
+}
+
+bool CDiskLRUCache::Touch(const string &name)
+{
+  CSingleLock lock(m_critSection);
+  Load();
+  CacheEntries::iterator entry = m_entries.find(name);
+  if (entry == m_entries.end())
+    return false;
+
+  entry->second.lastUsed = ++m_sequence;
+  if (++m_touched >= DISK_CACHE_TOUCHES)
+    Save();
+  return true;
+}
+
+void CDiskLRUCache::Add(const string &name, int64_t size)
+{
+  CSingleLock lock(m_critSection);
+  Load();
+  CacheEntry entry;
+  entry.size = size;
+  entry.lastUsed = ++m_sequence;
+  m_entries[name] = entry;
+  Trim();
+  Save();
+}
+
+void CDiskLRUCache::Remove(const string &name)
+{
+  CSingleLock lock(m_critSection);
+  Load();
+  CFile::Delete(m_path + name);
+  if (m_entries.erase(name) > 0)
+    Save();
+}
+
+void CDiskLRUCache::Load()
+{
+  if (m_loaded)
+    return;
+  m_loaded = true;
+
+  CDirectory::Create(m_path);
+
+  CFile index;
+  if (index.Open(m_path + DISK_CACHE_INDEX))
+  {
+    char line[256];
+    while (index.ReadString(line, sizeof(line)))
+    {
+      char name[64];
+      CacheEntry entry;
+      if (sscanf(line, "%63s %"PRId64" %"PRIu64, name, &entry.size, &entry.lastUsed) != 3)
+        continue;
+      m_entries[name] = entry;
+      if (entry.lastUsed > m_sequence)
+        m_sequence = entry.lastUsed;
+    }
+    index.Close();
+  }
+
+  set<string> files;
+  CFileItemList items;
+  CDirectory::GetDirectory(m_path, items, "", DIR_FLAG_NO_FILE_DIRS);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+
+    CStdString name = URIUtils::GetFileName(items[i]->GetPath());
+    if (name == DISK_CACHE_INDEX)
+      continue;
+    if (m_entries.find(name) == m_entries.end())
+      CFile::Delete(items[i]->GetPath());
+    else
+      files.insert(name);
+  }
+
+  // forget the entries whose files have been removed
+  for (CacheEntries::iterator entry = m_entries.begin(); entry != m_entries.end();)
+  {
+    if (files.find(entry->first) == files.end())
+      m_entries.erase(entry++);
+    else
+      ++entry;
+  }
+
+  // the size limit might have been lowered
+  Trim();
+  Save();
+}
+
+void CDiskLRUCache::Save()
+{
+  m_touched = 0;
+
+  CFile index;
+  if (!index.OpenForWrite(m_path + DISK_CACHE_INDEX, true))
+  {
+    CLog::Log(LOGERROR, "CDiskLRUCache: unable to write the index of %s", m_path.c_str());
+    return;
+  }
+
+  for (CacheEntries::const_iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+  {
+    CStdString line;
+    line.Format("%s %"PRId64" %"PRIu64"\n", entry->first.c_str(), entry->second.size, entry->second.lastUsed);
+    index.Write(line.c_str(), line.size());
+  }
+  index.Close();
+}
+
+void CDiskLRUCache::Trim()
+{
+  int64_t size = 0;
+  for (CacheEntries::const_iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+    size += entry->second.size;
+
+  // keep the latest entry even if it exceeds the limit on its own
+  while (size > m_maxSize && m_entries.size() > 1)
+  {
+    CacheEntries::iterator oldest = m_entries.begin();
+    for (CacheEntries::iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+    {
+      if (entry->second.lastUsed < oldest->second.lastUsed)
+        oldest = entry;
+    }
+
+    CLog::Log(LOGDEBUG, "CDiskLRUCache: removing %s%s", m_path.c_str(), oldest->first.c_str());
+    CFile::Delete(m_path + oldest->first);
+    size -= oldest->second.size;
+    m_entries.erase(oldest);
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+#include "threads/CriticalSection.h"
+
+/*!
+ \brief A folder of cache files with a size limit, like the keyframe indexes
+ of the demuxer or rendered audio
+
+ An index file in the folder remembers the size of the entries and when they
+ were last used. The least recently used entries are removed once the folder
+ exceeds its size limit, the latest one is kept even if it exceeds the limit
+ on its own. Files that are not in the index, like those of an interrupted
+ write, are removed when the folder is first used.
+ */
+class CDiskLRUCache
+{
+public:
+  CDiskLRUCache(const std::string &path, int64_t maxSize);
+
+  /*!
+   \brief Gets the path of an entry, which can then be read or written
+   \param name the file name of the entry
+   */
+  std::string GetEntryPath(const std::string &name);
+
+  /*!
+   \brief Whether the entry has been added, without marking it as used
+   */
+  bool Has(const std::string &name);
+
+  /*!
+   \brief Marks an entry that is read as recently used
+   The order only matters once the folder is full, so it is written along
+   with the next Add() or after a number of touches.
+   \return false if the entry is not in the cache
+   */
+  bool Touch(const std::string &name);
+
+  /*!
+   \brief Adds an entry that has been written, removing the least recently
+   used entries when the folder exceeds its size limit
+   */
+  void Add(const std::string &name, int64_t size);
+
+  /*!
+   \brief Removes an entry and its file, e.g. because it can't be read
+   */
+  void Remove(const std::string &name);
+
+private:
+  struct CacheEntry
+  {
+    int64_t  size;
+    uint64_t lastUsed; ///< sequence number of the last use
+  };
+  typedef std::map<std::string, CacheEntry> CacheEntries;
+
+  void Load();
+  void Save();
+  void Trim();
+
+  CCriticalSection m_critSection;
+  std::string  m_path;
+  int64_t      m_maxSize;
+  bool         m_loaded;
+  CacheEntries m_entries;
+  uint64_t     m_sequence;
+  unsigned int m_touched;  ///< touches not written to the index yet
+};
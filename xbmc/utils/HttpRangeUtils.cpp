@@ -0,0 +1,120 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ctype.h>
+#include <sstream>
+
+#include "HttpRangeUtils.h"
+
+#define HTTP_RANGE_UNIT "bytes="
+
+static std::string Trim(const std::string &value)
+{
+  size_t start = value.find_first_not_of(" \t");
+  if (start == std::string::npos)
+    return "";
+
+  return value.substr(start, value.find_last_not_of(" \t") - start + 1);
+}
+
+static bool ParsePosition(const std::string &value, uint64_t &position)
+{
+  if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+
+  std::istringstream stream(value);
+  stream >> position;
+  return !stream.fail();
+}
+
+HttpRangeResult HttpRangeUtils::ParseRange(const std::string &range, uint64_t totalLength, uint64_t &first, uint64_t &last)
+{
+  std::string value = Trim(range);
+  const std::string unit = HTTP_RANGE_UNIT;
+  if (value.size() <= unit.size())
+    return HttpRangeNone;
+
+  // the range unit is case-insensitive
+  for (size_t index = 0; index < unit.size(); index++)
+  {
+    if (tolower(value[index]) != unit[index])
+      return HttpRangeNone;
+  }
+
+  value = value.substr(unit.size());
+  // multiple ranges would need a multipart/byteranges response
+  if (value.find(',') != std::string::npos)
+    return HttpRangeNone;
+
+  size_t separator = value.find('-');
+  if (separator == std::string::npos)
+    return HttpRangeNone;
+
+  std::string strFirst = Trim(value.substr(0, separator));
+  std::string strLast = Trim(value.substr(separator + 1));
+
+  // "-suffixlength" requests the last bytes of the content
+  if (strFirst.empty())
+  {
+    uint64_t suffixLength;
+    if (!ParsePosition(strLast, suffixLength))
+      return HttpRangeNone;
+    if (suffixLength == 0 || totalLength == 0)
+      return HttpRangeUnsatisfiable;
+
+    first = suffixLength < totalLength ? totalLength - suffixLength : 0;
+    last = totalLength - 1;
+    return HttpRangeSatisfiable;
+  }
+
+  if (!ParsePosition(strFirst, first))
+    return HttpRangeNone;
+
+  if (strLast.empty())
+    last = totalLength > 0 ? totalLength - 1 : 0;
+  else
+  {
+    if (!ParsePosition(strLast, last))
+      return HttpRangeNone;
+    if (last < first)
+      return HttpRangeNone;
+    if (last >= totalLength)
+      last = totalLength > 0 ? totalLength - 1 : 0;
+  }
+
+  if (first >= totalLength)
+    return HttpRangeUnsatisfiable;
+
+  return HttpRangeSatisfiable;
+}
+
+std::string HttpRangeUtils::GetContentRange(uint64_t first, uint64_t last, uint64_t totalLength)
+{
+  std::ostringstream contentRange;
+  contentRange << "bytes " << first << "-" << last << "/" << totalLength;
+  return contentRange.str();
+}
+
+std::string HttpRangeUtils::GetUnsatisfiableContentRange(uint64_t totalLength)
+{
+  std::ostringstream contentRange;
+  contentRange << "bytes */" << totalLength;
+  return contentRange.str();
+}
@@ -0,0 +1,58 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+typedef enum {
+  HttpRangeNone = 0,      // no (usable) range, the whole content is sent
+  HttpRangeSatisfiable,   // a single range within the content
+  HttpRangeUnsatisfiable  // the range lies outside of the content
+} HttpRangeResult;
+
+class HttpRangeUtils
+{
+public:
+  /*!
+   \brief Parses the value of the "Range" header field of a HTTP request
+
+   Only a single byte range ("bytes=first-last", "bytes=first-" or
+   "bytes=-suffixlength") is supported. Multiple ranges and malformed
+   values are ignored as allowed by RFC 2616.
+
+   \param range Value of the "Range" header field
+   \param totalLength Length of the requested content
+   \param first Receives the position of the first byte of the range
+   \param last Receives the position of the last byte of the range (inclusive)
+   \return Whether the range can be satisfied, is unsatisfiable or should be ignored
+   */
+  static HttpRangeResult ParseRange(const std::string &range, uint64_t totalLength, uint64_t &first, uint64_t &last);
+
+  /*!
+   \brief Builds the value of the "Content-Range" header field of a partial response
+   */
+  static std::string GetContentRange(uint64_t first, uint64_t last, uint64_t totalLength);
+
+  /*!
+   \brief Builds the value of the "Content-Range" header field of an unsatisfiable range response
+   */
+  static std::string GetUnsatisfiableContentRange(uint64_t totalLength);
+};
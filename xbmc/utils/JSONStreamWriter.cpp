@@ -0,0 +1,139 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <locale>
+#include <string.h>
+
+#include "JSONStreamWriter.h"
+
+CJSONStreamWriter::CJSONStreamWriter(bool compact)
+  : m_offset(0)
+{
+#if YAJL_MAJOR == 2
+  m_gen = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_gen, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_gen, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_gen = yajl_gen_alloc(&conf, NULL);
+#endif
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  yajl_gen_clear(m_gen);
+  yajl_gen_free(m_gen);
+}
+
+bool CJSONStreamWriter::StartObject()
+{
+  return yajl_gen_status_ok == yajl_gen_map_open(m_gen);
+}
+
+bool CJSONStreamWriter::EndObject()
+{
+  return yajl_gen_status_ok == yajl_gen_map_close(m_gen);
+}
+
+bool CJSONStreamWriter::StartArray()
+{
+  return yajl_gen_status_ok == yajl_gen_array_open(m_gen);
+}
+
+bool CJSONStreamWriter::EndArray()
+{
+  return yajl_gen_status_ok == yajl_gen_array_close(m_gen);
+}
+
+bool CJSONStreamWriter::Key(const std::string &key)
+{
+#if YAJL_MAJOR == 2
+  return yajl_gen_status_ok == yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), (size_t)key.length());
+#else
+  return yajl_gen_status_ok == yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), key.length());
+#endif
+}
+
+bool CJSONStreamWriter::Value(const CVariant &value)
+{
+  // Set locale to classic ("C") to ensure valid JSON numbers
+  std::string currentLocale = setlocale(LC_NUMERIC, NULL);
+  setlocale(LC_NUMERIC, "C");
+
+  bool success = CJSONVariantWriter::InternalWrite(m_gen, value);
+
+  // Re-set locale to what it was before using yajl
+  setlocale(LC_NUMERIC, currentLocale.c_str());
+
+  return success;
+}
+
+size_t CJSONStreamWriter::GetSize() const
+{
+  const unsigned char *buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_gen, &buffer, &length);
+
+  return (size_t)length - m_offset;
+}
+
+size_t CJSONStreamWriter::Take(char *buffer, size_t size)
+{
+  const unsigned char *output;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_gen, &output, &length);
+
+  size_t copy = std::min(size, (size_t)length - m_offset);
+  memcpy(buffer, output + m_offset, copy);
+  m_offset += copy;
+
+  // everything has been taken so the generator can reuse its buffer
+  if (m_offset >= (size_t)length)
+  {
+    yajl_gen_clear(m_gen);
+    m_offset = 0;
+  }
+
+  return copy;
+}
+
+void CJSONStreamWriter::Take(std::string &output)
+{
+  const unsigned char *buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_gen, &buffer, &length);
+
+  output.append((const char *)buffer + m_offset, (size_t)length - m_offset);
+  yajl_gen_clear(m_gen);
+  m_offset = 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JSONVariantWriter.h"
+
+/*!
+ \brief Incremental JSON writer
+
+ Writes a JSON document piece by piece instead of from one complete
+ CVariant tree. The generated output can be taken out of the writer at
+ any time, so a large document never has to be held in memory as a whole.
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(bool compact);
+  ~CJSONStreamWriter();
+
+  bool StartObject();
+  bool EndObject();
+  bool StartArray();
+  bool EndArray();
+  bool Key(const std::string &key);
+  bool Value(const CVariant &value);
+
+  /*!
+   \brief Number of generated bytes that haven't been taken yet
+   */
+  size_t GetSize() const;
+
+  /*!
+   \brief Moves up to size bytes of the generated output into buffer
+   \return Number of bytes copied into buffer
+   */
+  size_t Take(char *buffer, size_t size);
+  void Take(std::string &output);
+
+private:
+  yajl_gen m_gen;
+  size_t m_offset;
+};
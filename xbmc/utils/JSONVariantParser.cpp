@@ -74,7 +74,10 @@ CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int lengt
 
   parser.push_buffer(json, length);
 
-  return callback.GetOutput();
+  // hand the parsed tree over without copying it
+  CVariant output;
+  output.swap(callback.GetOutput());
+  return output;
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
@@ -186,28 +189,35 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
 
 void CJSONVariantParser::PushObject(CVariant variant)
 {
+  PARSE_STATUS status = ParseVariable;
+  if (variant.isObject())
+    status = ParseObject;
+  else if (variant.isArray())
+    status = ParseArray;
+
+  // the values are swapped into place instead of being copied
   if (m_status == ParseObject)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    CVariant &value = (*m_parse[m_parse.size() - 1])[m_key];
+    value.swap(variant);
+    m_parse.push_back(&value);
   }
   else if (m_status == ParseArray)
   {
     CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    temp->push_back(CVariant());
+    CVariant &value = (*temp)[temp->size() - 1];
+    value.swap(variant);
+    m_parse.push_back(&value);
   }
   else if (m_parse.size() == 0)
   {
-    m_parse.push_back(new CVariant(variant));
+    CVariant *value = new CVariant();
+    value->swap(variant);
+    m_parse.push_back(value);
   }
 
-  if (variant.isObject())
-    m_status = ParseObject;
-  else if (variant.isArray())
-    m_status = ParseArray;
-  else
-    m_status = ParseVariable;
+  m_status = status;
 }
 
 void CJSONVariantParser::PopObject()
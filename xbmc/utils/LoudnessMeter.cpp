@@ -0,0 +1,290 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LoudnessMeter.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// taps of each phase of the oversampling filter
+#define TRUEPEAK_TAPS 12
+
+// mean square of a block at the absolute gate of -70 LUFS
+static const double AbsoluteGate = pow(10.0, (-70.0 + 0.691) / 10.0);
+
+CLoudnessMeter::CLoudnessMeter()
+{
+  m_sampleRate = 0;
+  m_channelCount = 0;
+  m_oversampling = 1;
+  m_segmentFrames = 0;
+  m_segmentPos = 0;
+  m_segmentCount = 0;
+  m_peak = 0.0f;
+  m_frames = 0;
+}
+
+bool CLoudnessMeter::Init(unsigned int sampleRate, const std::vector<float> &weights)
+{
+  if (sampleRate < 8000 || sampleRate > 384000 || weights.empty())
+    return false;
+
+  m_sampleRate = sampleRate;
+  m_channelCount = weights.size();
+  m_segmentFrames = (sampleRate + 5) / 10;
+  m_segmentPos = 0;
+  m_segmentCount = 0;
+  m_blocks.clear();
+  m_peak = 0.0f;
+  m_frames = 0;
+
+  // K-weighting: high shelf followed by a high pass, both given for 48kHz in
+  // BS.1770 and derived from their analog prototypes for other sample rates
+  double f0 = 1681.974450955533;
+  double G  = 3.999843853973347;
+  double Q  = 0.7071752369554196;
+  double K  = tan(M_PI * f0 / sampleRate);
+  double Vh = pow(10.0, G / 20.0);
+  double Vb = pow(Vh, 0.4996667741545416);
+  double a0 = 1.0 + K / Q + K * K;
+  m_shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+  m_shelf.b1 = 2.0 * (K * K - Vh) / a0;
+  m_shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+  m_shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+  m_shelf.a2 = (1.0 - K / Q + K * K) / a0;
+
+  f0 = 38.13547087602444;
+  Q  = 0.5003270373238773;
+  K  = tan(M_PI * f0 / sampleRate);
+  a0 = 1.0 + K / Q + K * K;
+  m_highpass.b0 = 1.0;
+  m_highpass.b1 = -2.0;
+  m_highpass.b2 = 1.0;
+  m_highpass.a1 = 2.0 * (K * K - 1.0) / a0;
+  m_highpass.a2 = (1.0 - K / Q + K * K) / a0;
+
+  // the true peak is estimated by oversampling to at least 192kHz through a
+  // windowed sinc interpolator, split into one set of taps per phase
+  if (sampleRate < 96000)
+    m_oversampling = 4;
+  else if (sampleRate < 192000)
+    m_oversampling = 2;
+  else
+    m_oversampling = 1;
+
+  unsigned int length = TRUEPEAK_TAPS * m_oversampling;
+  m_coefficients.assign(length, 0.0f);
+  if (m_oversampling > 1)
+  {
+    for (unsigned int phase = 0; phase < m_oversampling; phase++)
+    {
+      double sum = 0.0;
+      for (unsigned int tap = 0; tap < TRUEPEAK_TAPS; tap++)
+      {
+        unsigned int i = tap * m_oversampling + phase;
+        double x = ((double)i - (length - 1) / 2.0) / m_oversampling;
+        double sinc = x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+        double window = 0.42 - 0.5 * cos(2.0 * M_PI * i / (length - 1)) + 0.08 * cos(4.0 * M_PI * i / (length - 1));
+        m_coefficients[phase * TRUEPEAK_TAPS + tap] = (float)(sinc * window);
+        sum += sinc * window;
+      }
+      // normalize every phase to unity gain at DC
+      for (unsigned int tap = 0; tap < TRUEPEAK_TAPS; tap++)
+        m_coefficients[phase * TRUEPEAK_TAPS + tap] /= (float)sum;
+    }
+  }
+
+  m_channels.resize(m_channelCount);
+  for (unsigned int c = 0; c < m_channelCount; c++)
+  {
+    Channel &channel = m_channels[c];
+    channel.weight = weights[c];
+    for (unsigned int i = 0; i < 4; i++)
+      channel.z[i] = 0.0;
+    channel.sum = 0.0;
+    channel.history.assign(TRUEPEAK_TAPS - 1, 0.0f);
+  }
+
+  return true;
+}
+
+void CLoudnessMeter::AddFrames(const float *samples, unsigned int frames)
+{
+  if (m_channels.empty())
+    return;
+
+  m_frames += frames;
+  while (frames > 0)
+  {
+    unsigned int count = std::min(frames, m_segmentFrames - m_segmentPos);
+    ProcessSegment(samples, count);
+
+    samples += count * m_channelCount;
+    frames -= count;
+    m_segmentPos += count;
+    if (m_segmentPos == m_segmentFrames)
+      EndSegment();
+  }
+}
+
+void CLoudnessMeter::ProcessSegment(const float *samples, unsigned int frames)
+{
+  // every channel is copied behind the history of the oversampling filter,
+  // so the inner loops below run over contiguous memory
+  m_scratch.resize(TRUEPEAK_TAPS - 1 + frames);
+  float *input = &m_scratch[TRUEPEAK_TAPS - 1];
+
+  for (unsigned int c = 0; c < m_channelCount; c++)
+  {
+    Channel &channel = m_channels[c];
+
+    for (unsigned int i = 0; i < frames; i++)
+      input[i] = samples[i * m_channelCount + c];
+
+    std::copy(channel.history.begin(), channel.history.end(), m_scratch.begin());
+    float peak = MeasurePeak(input, frames);
+    if (peak > m_peak)
+      m_peak = peak;
+    std::copy(m_scratch.begin() + frames, m_scratch.begin() + frames + TRUEPEAK_TAPS - 1, channel.history.begin());
+
+    if (channel.weight == 0.0f)
+      continue;
+
+    // K-weighting (two biquads, transposed direct form II) and mean square
+    double z0 = channel.z[0], z1 = channel.z[1], z2 = channel.z[2], z3 = channel.z[3];
+    double sum = 0.0;
+    for (unsigned int i = 0; i < frames; i++)
+    {
+      double x = input[i];
+      double y = m_shelf.b0 * x + z0;
+      z0 = m_shelf.b1 * x - m_shelf.a1 * y + z1;
+      z1 = m_shelf.b2 * x - m_shelf.a2 * y;
+
+      double w = m_highpass.b0 * y + z2;
+      z2 = m_highpass.b1 * y - m_highpass.a1 * w + z3;
+      z3 = m_highpass.b2 * y - m_highpass.a2 * w;
+
+      sum += w * w;
+    }
+    channel.z[0] = z0;
+    channel.z[1] = z1;
+    channel.z[2] = z2;
+    channel.z[3] = z3;
+    channel.sum += sum;
+  }
+}
+
+float CLoudnessMeter::MeasurePeak(const float *samples, unsigned int frames)
+{
+  float peak = 0.0f;
+  if (m_oversampling == 1)
+  {
+    for (unsigned int i = 0; i < frames; i++)
+      peak = std::max(peak, fabsf(samples[i]));
+    return peak;
+  }
+
+  // each phase is computed as a sum of scaled, shifted copies of the input,
+  // which keeps the loops free of dependencies so they can be vectorized
+  m_filtered.resize(frames);
+  float *output = &m_filtered[0];
+  for (unsigned int phase = 0; phase < m_oversampling; phase++)
+  {
+    const float *coefficients = &m_coefficients[phase * TRUEPEAK_TAPS];
+    for (unsigned int i = 0; i < frames; i++)
+      output[i] = 0.0f;
+    for (unsigned int tap = 0; tap < TRUEPEAK_TAPS; tap++)
+    {
+      const float coefficient = coefficients[tap];
+      const float *input = samples - tap;
+      for (unsigned int i = 0; i < frames; i++)
+        output[i] += coefficient * input[i];
+    }
+    for (unsigned int i = 0; i < frames; i++)
+      peak = std::max(peak, fabsf(output[i]));
+  }
+  return peak;
+}
+
+void CLoudnessMeter::EndSegment()
+{
+  double energy = 0.0;
+  for (unsigned int c = 0; c < m_channelCount; c++)
+  {
+    Channel &channel = m_channels[c];
+    energy += channel.weight * channel.sum / m_segmentFrames;
+    channel.sum = 0.0;
+
+    // flush denormals left behind by the filters on silence
+    for (unsigned int i = 0; i < 4; i++)
+    {
+      if (fabs(channel.z[i]) < DBL_MIN)
+        channel.z[i] = 0.0;
+    }
+  }
+  m_segmentPos = 0;
+
+  // a block spans the last four segments
+  m_segments[m_segmentCount % 4] = energy;
+  if (++m_segmentCount < 4)
+    return;
+
+  double block = (m_segments[0] + m_segments[1] + m_segments[2] + m_segments[3]) / 4.0;
+  if (block >= AbsoluteGate)
+    m_blocks.push_back(block);
+}
+
+void CLoudnessMeter::Merge(const CLoudnessMeter &meter)
+{
+  m_blocks.insert(m_blocks.end(), meter.m_blocks.begin(), meter.m_blocks.end());
+  m_peak = std::max(m_peak, meter.m_peak);
+  m_frames += meter.m_frames;
+}
+
+bool CLoudnessMeter::GetIntegratedLoudness(double &loudness) const
+{
+  if (m_blocks.empty())
+    return false;
+
+  double sum = 0.0;
+  for (std::vector<double>::const_iterator block = m_blocks.begin(); block != m_blocks.end(); ++block)
+    sum += *block;
+
+  // relative gate 10 LU below the loudness of the blocks above the absolute gate
+  double threshold = sum / m_blocks.size() * 0.1;
+  sum = 0.0;
+  unsigned int count = 0;
+  for (std::vector<double>::const_iterator block = m_blocks.begin(); block != m_blocks.end(); ++block)
+  {
+    if (*block >= threshold)
+    {
+      sum += *block;
+      count++;
+    }
+  }
+
+  loudness = -0.691 + 10.0 * log10(sum / count);
+  return true;
+}
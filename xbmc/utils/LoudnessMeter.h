@@ -0,0 +1,116 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Measures loudness and true peak of an audio signal according to
+ EBU R128 / ITU-R BS.1770-3
+
+ Samples are fed as interleaved float frames. The signal is K-weighted per
+ channel, the mean square of overlapping 400ms blocks (100ms hop) is gated
+ at -70 LUFS (absolute) and 10 LU below the ungated loudness (relative).
+ The true peak is estimated by 4x oversampling below 96kHz.
+
+ The energies of all measured blocks are kept, so the meters of several
+ tracks can be merged to get the exact loudness of an album.
+ */
+class CLoudnessMeter
+{
+public:
+  CLoudnessMeter();
+
+  /*!
+   \brief Prepares the meter for a new signal
+   \param sampleRate Sample rate of the signal
+   \param weights Weight of each channel (1.0 for front and center, 1.41 for
+   surround and 0.0 for LFE channels)
+   \return False if the parameters are not supported
+   */
+  bool Init(unsigned int sampleRate, const std::vector<float> &weights);
+
+  /*!
+   \brief Measures the given interleaved frames
+   */
+  void AddFrames(const float *samples, unsigned int frames);
+
+  /*!
+   \brief Adds the measured blocks and peaks of another meter to this one
+   */
+  void Merge(const CLoudnessMeter &meter);
+
+  /*!
+   \brief Gets the gated integrated loudness in LUFS
+   \return False if no block was above the absolute gate (silence)
+   */
+  bool GetIntegratedLoudness(double &loudness) const;
+
+  /*!
+   \brief Gets the highest (true) peak of all channels, 1.0 being full scale
+   */
+  float GetTruePeak() const { return m_peak; }
+
+  /*!
+   \brief Gets the number of frames measured so far
+   */
+  uint64_t GetFrames() const { return m_frames; }
+
+  /*!
+   \brief Converts a loudness in LUFS to a ReplayGain 2.0 gain in dB (-18 LUFS reference)
+   */
+  static double GetReplayGain(double loudness) { return -18.0 - loudness; }
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  struct Channel
+  {
+    float  weight;
+    double z[4];        ///< state of the two K-weighting filter stages
+    double sum;         ///< sum of squares of the current 100ms segment
+    std::vector<float> history; ///< last input samples for the oversampling filter
+  };
+
+  void  ProcessSegment(const float *samples, unsigned int frames);
+  void  EndSegment();
+  float MeasurePeak(const float *samples, unsigned int frames);
+
+  unsigned int m_sampleRate;
+  unsigned int m_channelCount;
+  unsigned int m_oversampling;
+  unsigned int m_segmentFrames;
+  unsigned int m_segmentPos;
+  Biquad m_shelf;
+  Biquad m_highpass;
+  std::vector<Channel> m_channels;
+  std::vector<float> m_coefficients; ///< taps of the oversampling filter, grouped by phase
+  std::vector<float> m_scratch;
+  std::vector<float> m_filtered;
+  double m_segments[4];
+  unsigned int m_segmentCount;
+  std::vector<double> m_blocks;  ///< mean square of all blocks above the absolute gate
+  float m_peak;
+  uint64_t m_frames;
+};
@@ -24,6 +24,22 @@
 
 #include "Variant.h"
 
+// MSVC has no C99 64 bit string conversions
+#ifdef _WIN32
+#ifndef strtoll
+#define strtoll _strtoi64
+#endif
+#ifndef strtoull
+#define strtoull _strtoui64
+#endif
+#ifndef wcstoll
+#define wcstoll _wcstoi64
+#endif
+#ifndef wcstoull
+#define wcstoull _wcstoui64
+#endif
+#endif
+
 using namespace std;
 
 string trimRight(const string &str)
@@ -51,7 +67,8 @@ wstring trimRight(const wstring &str)
 int64_t str2int64(const string &str, int64_t fallback /* = 0 */)
 {
   char *end = NULL;
-  int64_t result = strtol(trimRight(str).c_str(), &end, 0);
+  string trimmed = trimRight(str);
+  int64_t result = strtoll(trimmed.c_str(), &end, 0);
   if (end == NULL || *end == '\0')
     return result;
 
@@ -61,7 +78,8 @@ int64_t str2int64(const string &str, int64_t fallback /* = 0 */)
 int64_t str2int64(const wstring &str, int64_t fallback /* = 0 */)
 {
   wchar_t *end = NULL;
-  int64_t result = wcstol(trimRight(str).c_str(), &end, 0);
+  wstring trimmed = trimRight(str);
+  int64_t result = wcstoll(trimmed.c_str(), &end, 0);
   if (end == NULL || *end == '\0')
     return result;
 
@@ -71,7 +89,8 @@ int64_t str2int64(const wstring &str, int64_t fallback /* = 0 */)
 uint64_t str2uint64(const string &str, uint64_t fallback /* = 0 */)
 {
   char *end = NULL;
-  uint64_t result = strtoul(trimRight(str).c_str(), &end, 0);
+  string trimmed = trimRight(str);
+  uint64_t result = strtoull(trimmed.c_str(), &end, 0);
   if (end == NULL || *end == '\0')
     return result;
 
@@ -81,7 +100,8 @@ uint64_t str2uint64(const string &str, uint64_t fallback /* = 0 */)
 uint64_t str2uint64(const wstring &str, uint64_t fallback /* = 0 */)
 {
   wchar_t *end = NULL;
-  uint64_t result = wcstoul(trimRight(str).c_str(), &end, 0);
+  wstring trimmed = trimRight(str);
+  uint64_t result = wcstoull(trimmed.c_str(), &end, 0);
   if (end == NULL || *end == '\0')
     return result;
 
@@ -91,7 +111,8 @@ uint64_t str2uint64(const wstring &str, uint64_t fallback /* = 0 */)
 double str2double(const string &str, double fallback /* = 0.0 */)
 {
   char *end = NULL;
-  double result = strtod(trimRight(str).c_str(), &end);
+  string trimmed = trimRight(str);
+  double result = strtod(trimmed.c_str(), &end);
   if (end == NULL || *end == '\0')
     return result;
 
@@ -101,7 +122,8 @@ double str2double(const string &str, double fallback /* = 0.0 */)
 double str2double(const wstring &str, double fallback /* = 0.0 */)
 {
   wchar_t *end = NULL;
-  double result = wcstod(trimRight(str).c_str(), &end);
+  wstring trimmed = trimRight(str);
+  double result = wcstod(trimmed.c_str(), &end);
   if (end == NULL || *end == '\0')
     return result;
 
@@ -113,6 +135,7 @@ CVariant CVariant::ConstNullVariant = CVariant::VariantTypeConstNull;
 CVariant::CVariant(VariantType type)
 {
   m_type = type;
+  m_stringLength = 0;
 
   switch (type)
   {
@@ -129,7 +152,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new string();
+      m_data.smallstring[0] = '\0';
       break;
     case VariantTypeWideString:
       m_data.wstring = new wstring();
@@ -149,84 +172,101 @@ CVariant::CVariant(VariantType type)
 CVariant::CVariant(int integer)
 {
   m_type = VariantTypeInteger;
+  m_stringLength = 0;
   m_data.integer = integer;
 }
 
 CVariant::CVariant(int64_t integer)
 {
   m_type = VariantTypeInteger;
+  m_stringLength = 0;
   m_data.integer = integer;
 }
 
 CVariant::CVariant(unsigned int unsignedinteger)
 {
   m_type = VariantTypeUnsignedInteger;
+  m_stringLength = 0;
   m_data.unsignedinteger = unsignedinteger;
 }
 
 CVariant::CVariant(uint64_t unsignedinteger)
 {
   m_type = VariantTypeUnsignedInteger;
+  m_stringLength = 0;
   m_data.unsignedinteger = unsignedinteger;
 }
 
 CVariant::CVariant(double value)
 {
   m_type = VariantTypeDouble;
+  m_stringLength = 0;
   m_data.dvalue = value;
 }
 
 CVariant::CVariant(float value)
 {
   m_type = VariantTypeDouble;
+  m_stringLength = 0;
   m_data.dvalue = (double)value;
 }
 
 CVariant::CVariant(bool boolean)
 {
   m_type = VariantTypeBoolean;
+  m_stringLength = 0;
   m_data.boolean = boolean;
 }
 
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  if (str.size() <= SmallStringSize)
+    setString(str.c_str(), str.size());
+  else
+  {
+    m_stringLength = HeapString;
+    m_data.string = new string(str);
+  }
 }
 
 CVariant::CVariant(const wchar_t *str)
 {
   m_type = VariantTypeWideString;
+  m_stringLength = 0;
   m_data.wstring = new wstring(str);
 }
 
 CVariant::CVariant(const wchar_t *str, unsigned int length)
 {
   m_type = VariantTypeWideString;
+  m_stringLength = 0;
   m_data.wstring = new wstring(str, length);
 }
 
 CVariant::CVariant(const wstring &str)
 {
   m_type = VariantTypeWideString;
+  m_stringLength = 0;
   m_data.wstring = new wstring(str);
 }
 
 CVariant::CVariant(const std::vector<std::string> &strArray)
 {
   m_type = VariantTypeArray;
+  m_stringLength = 0;
   m_data.array = new VariantArray;
   m_data.array->reserve(strArray.size());
   for (unsigned int index = 0; index < strArray.size(); index++)
@@ -236,6 +276,7 @@ CVariant::CVariant(const std::vector<std::string> &strArray)
 CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
   m_type = VariantTypeObject;
+  m_stringLength = 0;
   m_data.map = new VariantMap;
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); it++)
     m_data.map->insert(make_pair(it->first, CVariant(it->second)));
@@ -244,12 +285,14 @@ CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
 {
   m_type = VariantTypeObject;
+  m_stringLength = 0;
   m_data.map = new VariantMap(variantMap.begin(), variantMap.end());
 }
 
 CVariant::CVariant(const CVariant &variant)
 {
   m_type = VariantTypeNull;
+  m_stringLength = 0;
   *this = variant;
 }
 
@@ -258,9 +301,32 @@ CVariant::~CVariant()
   cleanup();
 }
 
+void CVariant::setString(const char *str, size_t length)
+{
+  if (length <= SmallStringSize)
+  {
+    m_stringLength = (unsigned char)length;
+    memcpy(m_data.smallstring, str, length);
+    m_data.smallstring[length] = '\0';
+  }
+  else
+  {
+    m_stringLength = HeapString;
+    m_data.string = new string(str, length);
+  }
+}
+
+string CVariant::getString() const
+{
+  if (m_stringLength == HeapString)
+    return *m_data.string;
+
+  return string(m_data.smallstring, m_stringLength);
+}
+
 void CVariant::cleanup()
 {
-  if (m_type == VariantTypeString)
+  if (m_type == VariantTypeString && m_stringLength == HeapString)
     delete m_data.string;
   else if (m_type == VariantTypeWideString)
     delete m_data.wstring;
@@ -332,7 +398,7 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(getString(), fallback);
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -353,7 +419,7 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(getString(), fallback);
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -374,7 +440,7 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(getString(), fallback);
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -395,7 +461,7 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(getString(), fallback);
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -418,7 +484,7 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (empty() || strcmp(c_str(), "0") == 0 || strcmp(c_str(), "false") == 0)
         return false;
       return true;
     case VariantTypeWideString:
@@ -437,7 +503,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return getString();
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -536,6 +602,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   cleanup();
 
   m_type = rhs.m_type;
+  m_stringLength = rhs.m_stringLength;
 
   switch (m_type)
   {
@@ -552,7 +619,10 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new string(*rhs.m_data.string);
+    if (m_stringLength == HeapString)
+      m_data.string = new string(*rhs.m_data.string);
+    else
+      memcpy(m_data.smallstring, rhs.m_data.smallstring, m_stringLength + 1);
     break;
   case VariantTypeWideString:
     m_data.wstring = new wstring(*rhs.m_data.wstring);
@@ -585,7 +655,7 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return size() == rhs.size() && memcmp(c_str(), rhs.c_str(), size()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -619,21 +689,26 @@ void CVariant::append(const CVariant &variant)
 
 const char *CVariant::c_str() const
 {
-  if (m_type == VariantTypeString)
+  if (m_type != VariantTypeString)
+    return NULL;
+  else if (m_stringLength == HeapString)
     return m_data.string->c_str();
   else
-    return NULL;
+    return m_data.smallstring;
 }
 
 void CVariant::swap(CVariant &rhs)
 {
-  VariantType  temp_type = m_type;
-  VariantUnion temp_data = m_data;
+  VariantType   temp_type = m_type;
+  unsigned char temp_length = m_stringLength;
+  VariantUnion  temp_data = m_data;
 
   m_type = rhs.m_type;
+  m_stringLength = rhs.m_stringLength;
   m_data = rhs.m_data;
 
   rhs.m_type = temp_type;
+  rhs.m_stringLength = temp_length;
   rhs.m_data = temp_data;
 }
 
@@ -708,7 +783,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return m_stringLength == HeapString ? m_data.string->size() : m_stringLength;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -722,7 +797,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return m_stringLength == HeapString ? m_data.string->empty() : m_stringLength == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -738,7 +813,12 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    if (m_stringLength == HeapString)
+      delete m_data.string;
+    m_stringLength = 0;
+    m_data.smallstring[0] = '\0';
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
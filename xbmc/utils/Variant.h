@@ -135,7 +135,19 @@ public:
   static CVariant ConstNullVariant;
 
 private:
+  // strings up to SmallStringSize characters are stored inline
+  // instead of in a separately allocated std::string. The buffer is as
+  // large as the 64 bit members, so the union does not grow.
+  enum
+  {
+    SmallStringSize = 7,
+    HeapString = 0xFF
+  };
+
   void cleanup();
+  void setString(const char *str, size_t length);
+  std::string getString() const;
+
   union VariantUnion
   {
     int64_t integer;
@@ -143,11 +155,13 @@ private:
     bool boolean;
     double dvalue;
     std::string *string;
+    char smallstring[SmallStringSize + 1];
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
   };
 
   VariantType m_type;
+  unsigned char m_stringLength; // length of an inline string or HeapString
   VariantUnion m_data;
 };
@@ -0,0 +1,173 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "YUVUtils.h"
+#include <string.h>
+#include "fastmemcpy.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+void CYUVUtils::CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  if (width == srcStride && srcStride == dstStride)
+  {
+    fast_memcpy(dst, src, width * height);
+    return;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    fast_memcpy(dst, src, width);
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+void CYUVUtils::InterleaveUV(uint8_t *dst, int dstStride,
+                             const uint8_t *srcU, int srcUStride,
+                             const uint8_t *srcV, int srcVStride,
+                             int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    int x = 0;
+#ifdef __SSE2__
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i u = _mm_loadu_si128((const __m128i*)(srcU + x));
+      __m128i v = _mm_loadu_si128((const __m128i*)(srcV + x));
+      _mm_storeu_si128((__m128i*)(dst + 2 * x),      _mm_unpacklo_epi8(u, v));
+      _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(u, v));
+    }
+#endif
+    for (; x < width; x++)
+    {
+      dst[2 * x]     = srcU[x];
+      dst[2 * x + 1] = srcV[x];
+    }
+    dst  += dstStride;
+    srcU += srcUStride;
+    srcV += srcVStride;
+  }
+}
+
+void CYUVUtils::DeinterleaveUV(uint8_t *dstU, int dstUStride,
+                               uint8_t *dstV, int dstVStride,
+                               const uint8_t *src, int srcStride,
+                               int width, int height)
+{
+#ifdef __SSE2__
+  const __m128i mask = _mm_set1_epi16(0x00ff);
+#endif
+  for (int y = 0; y < height; y++)
+  {
+    int x = 0;
+#ifdef __SSE2__
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(src + 2 * x));
+      __m128i b = _mm_loadu_si128((const __m128i*)(src + 2 * x + 16));
+      _mm_storeu_si128((__m128i*)(dstU + x), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+      _mm_storeu_si128((__m128i*)(dstV + x), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+#endif
+    for (; x < width; x++)
+    {
+      dstU[x] = src[2 * x];
+      dstV[x] = src[2 * x + 1];
+    }
+    src  += srcStride;
+    dstU += dstUStride;
+    dstV += dstVStride;
+  }
+}
+
+void CYUVUtils::PackYUV422(uint8_t *dst, int dstStride,
+                           const uint8_t *srcY, int srcYStride,
+                           const uint8_t *srcU, int srcUStride,
+                           const uint8_t *srcV, int srcVStride,
+                           int width, int height, bool uyvy)
+{
+  for (int y = 0; y < height; y++)
+  {
+    const uint8_t *u = srcU + (y >> 1) * srcUStride;
+    const uint8_t *v = srcV + (y >> 1) * srcVStride;
+    int x = 0;
+#ifdef __SSE2__
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i luma = _mm_loadu_si128((const __m128i*)(srcY + x));
+      __m128i chroma = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + x / 2)),
+                                         _mm_loadl_epi64((const __m128i*)(v + x / 2)));
+      if (uyvy)
+      {
+        _mm_storeu_si128((__m128i*)(dst + 2 * x),      _mm_unpacklo_epi8(chroma, luma));
+        _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(chroma, luma));
+      }
+      else
+      {
+        _mm_storeu_si128((__m128i*)(dst + 2 * x),      _mm_unpacklo_epi8(luma, chroma));
+        _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(luma, chroma));
+      }
+    }
+#endif
+    for (; x + 1 < width; x += 2)
+    {
+      uint8_t *d = dst + 2 * x;
+      if (uyvy)
+      {
+        d[0] = u[x / 2];
+        d[1] = srcY[x];
+        d[2] = v[x / 2];
+        d[3] = srcY[x + 1];
+      }
+      else
+      {
+        d[0] = srcY[x];
+        d[1] = u[x / 2];
+        d[2] = srcY[x + 1];
+        d[3] = v[x / 2];
+      }
+    }
+    // the last pixel of an odd width is repeated to fill its macropixel
+    if (x < width)
+    {
+      uint8_t *d = dst + 2 * x;
+      if (uyvy)
+      {
+        d[0] = u[x / 2];
+        d[1] = srcY[x];
+        d[2] = v[x / 2];
+        d[3] = srcY[x];
+      }
+      else
+      {
+        d[0] = srcY[x];
+        d[1] = u[x / 2];
+        d[2] = srcY[x];
+        d[3] = v[x / 2];
+      }
+    }
+    dst  += dstStride;
+    srcY += srcYStride;
+  }
+}
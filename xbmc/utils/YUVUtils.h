@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*! \brief Kernels for copying and repacking the planes of YUV images
+ These are used by the software decode and render paths. SSE2 versions are
+ used when the compiler targets SSE2, else plain C. Both give identical results.
+ */
+class CYUVUtils
+{
+public:
+  /*! \brief Copy a plane of width bytes by height rows between buffers of different strides */
+  static void CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height);
+
+  /*! \brief Interleave separate U and V planes into one UV plane as used by NV12
+   \param width the number of chroma samples per row of each source plane.
+   */
+  static void InterleaveUV(uint8_t *dst, int dstStride,
+                           const uint8_t *srcU, int srcUStride,
+                           const uint8_t *srcV, int srcVStride,
+                           int width, int height);
+
+  /*! \brief Split an NV12 UV plane into separate U and V planes
+   \param width the number of chroma samples per row of each destination plane.
+   */
+  static void DeinterleaveUV(uint8_t *dstU, int dstUStride,
+                             uint8_t *dstV, int dstVStride,
+                             const uint8_t *src, int srcStride,
+                             int width, int height);
+
+  /*! \brief Pack a YUV 4:2:0 planar image into YUY2 (or UYVY if uyvy is set)
+   Each chroma row is used for two rows of the output.
+   \param width the width of the image in pixels. For odd widths the last pixel
+   is repeated, so each row of dst takes (width + 1) / 2 macropixels.
+   */
+  static void PackYUV422(uint8_t *dst, int dstStride,
+                         const uint8_t *srcY, int srcYStride,
+                         const uint8_t *srcU, int srcUStride,
+                         const uint8_t *srcV, int srcVStride,
+                         int width, int height, bool uyvy);
+};
@@ -1394,6 +1394,24 @@ TEST(TestDatabaseUtils, GetFieldValue)
 //                                  DatabaseResults &results);
 // }
 
+TEST(TestDatabaseUtils, BuildOrderClause)
+{
+  FieldList fields;
+  std::string a = DatabaseUtils::BuildOrderClause(fields, MediaTypeEpisode);
+  EXPECT_STREQ("", a.c_str());
+
+  fields.push_back(FieldDateAdded);
+  fields.push_back(FieldId);
+  a = DatabaseUtils::BuildOrderClause(fields, MediaTypeEpisode);
+  EXPECT_STREQ(" ORDER BY episodeview.dateAdded, episodeview.idEpisode", a.c_str());
+
+  a = DatabaseUtils::BuildOrderClause(fields, MediaTypeEpisode, true);
+  EXPECT_STREQ(" ORDER BY episodeview.dateAdded DESC, episodeview.idEpisode DESC", a.c_str());
+
+  a = DatabaseUtils::BuildOrderClause(fields, MediaTypeArtist);
+  EXPECT_STREQ("", a.c_str());
+}
+
 TEST(TestDatabaseUtils, BuildLimitClause)
 {
   std::string a = DatabaseUtils::BuildLimitClause(100);
@@ -0,0 +1,126 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/DiskLRUCache.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#define TEST_CACHE_PATH "special://temp/disklrucache/"
+
+static void WriteEntry(CDiskLRUCache &cache, const std::string &name, unsigned int size)
+{
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(cache.GetEntryPath(name), true));
+  std::vector<char> data(size, 'x');
+  EXPECT_EQ((int)size, file.Write(&data[0], size));
+  file.Close();
+  cache.Add(name, size);
+}
+
+class TestDiskLRUCache : public testing::Test
+{
+protected:
+  TestDiskLRUCache()
+  {
+    XFILE::CDirectory::Remove(TEST_CACHE_PATH);
+  }
+
+  ~TestDiskLRUCache()
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(TEST_CACHE_PATH, items);
+    for (int i = 0; i < items.Size(); i++)
+      XFILE::CFile::Delete(items[i]->GetPath());
+    XFILE::CDirectory::Remove(TEST_CACHE_PATH);
+  }
+};
+
+TEST_F(TestDiskLRUCache, Trim)
+{
+  CDiskLRUCache cache(TEST_CACHE_PATH, 100);
+  WriteEntry(cache, "a", 40);
+  WriteEntry(cache, "b", 40);
+  EXPECT_TRUE(cache.Has("a"));
+
+  // "a" is the least recently used entry
+  WriteEntry(cache, "c", 40);
+  EXPECT_FALSE(cache.Has("a"));
+  EXPECT_FALSE(XFILE::CFile::Exists(TEST_CACHE_PATH "a"));
+  EXPECT_TRUE(cache.Has("b"));
+  EXPECT_TRUE(cache.Has("c"));
+}
+
+TEST_F(TestDiskLRUCache, Touch)
+{
+  CDiskLRUCache cache(TEST_CACHE_PATH, 100);
+  WriteEntry(cache, "a", 40);
+  WriteEntry(cache, "b", 40);
+  EXPECT_TRUE(cache.Touch("a"));
+  EXPECT_FALSE(cache.Touch("missing"));
+
+  WriteEntry(cache, "c", 40);
+  EXPECT_TRUE(cache.Has("a"));
+  EXPECT_FALSE(cache.Has("b"));
+  EXPECT_TRUE(cache.Has("c"));
+}
+
+TEST_F(TestDiskLRUCache, KeepLatest)
+{
+  CDiskLRUCache cache(TEST_CACHE_PATH, 100);
+  WriteEntry(cache, "a", 40);
+  WriteEntry(cache, "b", 200);
+  EXPECT_FALSE(cache.Has("a"));
+  EXPECT_TRUE(cache.Has("b"));
+}
+
+TEST_F(TestDiskLRUCache, Remove)
+{
+  CDiskLRUCache cache(TEST_CACHE_PATH, 100);
+  WriteEntry(cache, "a", 40);
+  cache.Remove("a");
+  EXPECT_FALSE(cache.Has("a"));
+  EXPECT_FALSE(XFILE::CFile::Exists(TEST_CACHE_PATH "a"));
+}
+
+TEST_F(TestDiskLRUCache, Reload)
+{
+  {
+    CDiskLRUCache cache(TEST_CACHE_PATH, 100);
+    WriteEntry(cache, "a", 40);
+    WriteEntry(cache, "b", 40);
+
+    // a file that is not in the index, like an interrupted write
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(cache.GetEntryPath("c.tmp"), true));
+    file.Close();
+  }
+
+  XFILE::CFile::Delete(TEST_CACHE_PATH "b");
+
+  CDiskLRUCache cache(TEST_CACHE_PATH, 100);
+  EXPECT_TRUE(cache.Has("a"));
+  EXPECT_FALSE(cache.Has("b"));
+  EXPECT_FALSE(XFILE::CFile::Exists(TEST_CACHE_PATH "c.tmp"));
+}
@@ -0,0 +1,77 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/HttpRangeUtils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestHttpRangeUtils, ParseRange)
+{
+  uint64_t first, last;
+
+  EXPECT_EQ(HttpRangeSatisfiable, HttpRangeUtils::ParseRange("bytes=0-499", 1000, first, last));
+  EXPECT_EQ(0U, first);
+  EXPECT_EQ(499U, last);
+
+  EXPECT_EQ(HttpRangeSatisfiable, HttpRangeUtils::ParseRange("Bytes=500-", 1000, first, last));
+  EXPECT_EQ(500U, first);
+  EXPECT_EQ(999U, last);
+
+  EXPECT_EQ(HttpRangeSatisfiable, HttpRangeUtils::ParseRange("bytes=-100", 1000, first, last));
+  EXPECT_EQ(900U, first);
+  EXPECT_EQ(999U, last);
+
+  EXPECT_EQ(HttpRangeSatisfiable, HttpRangeUtils::ParseRange("bytes=-2000", 1000, first, last));
+  EXPECT_EQ(0U, first);
+  EXPECT_EQ(999U, last);
+
+  EXPECT_EQ(HttpRangeSatisfiable, HttpRangeUtils::ParseRange(" bytes= 900 - 1500 ", 1000, first, last));
+  EXPECT_EQ(900U, first);
+  EXPECT_EQ(999U, last);
+}
+
+TEST(TestHttpRangeUtils, ParseRangeUnsatisfiable)
+{
+  uint64_t first, last;
+
+  EXPECT_EQ(HttpRangeUnsatisfiable, HttpRangeUtils::ParseRange("bytes=1000-", 1000, first, last));
+  EXPECT_EQ(HttpRangeUnsatisfiable, HttpRangeUtils::ParseRange("bytes=1000-2000", 1000, first, last));
+  EXPECT_EQ(HttpRangeUnsatisfiable, HttpRangeUtils::ParseRange("bytes=-0", 1000, first, last));
+  EXPECT_EQ(HttpRangeUnsatisfiable, HttpRangeUtils::ParseRange("bytes=0-", 0, first, last));
+}
+
+TEST(TestHttpRangeUtils, ParseRangeIgnored)
+{
+  uint64_t first, last;
+
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("", 1000, first, last));
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("bytes=", 1000, first, last));
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("items=0-10", 1000, first, last));
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("bytes=0-10,20-30", 1000, first, last));
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("bytes=500-100", 1000, first, last));
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("bytes=a-b", 1000, first, last));
+  EXPECT_EQ(HttpRangeNone, HttpRangeUtils::ParseRange("bytes=-", 1000, first, last));
+}
+
+TEST(TestHttpRangeUtils, GetContentRange)
+{
+  EXPECT_STREQ("bytes 0-499/1000", HttpRangeUtils::GetContentRange(0, 499, 1000).c_str());
+  EXPECT_STREQ("bytes */1000", HttpRangeUtils::GetUnsatisfiableContentRange(1000).c_str());
+}
@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONStreamWriter.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+static void CreateItem(unsigned int index, CVariant &item)
+{
+  item["songid"] = index;
+  item["label"] = StringUtils::Format("Song %u", index);
+  item["artist"].append("Artist");
+  item["duration"] = 180 + index % 120;
+  item["rating"] = 2.5;
+  item["file"] = StringUtils::Format("/music/album/%05u.flac", index);
+}
+
+TEST(TestJSONStreamWriter, Write)
+{
+  CVariant value;
+  value["string"] = "abc";
+  value["integer"] = -5;
+  value["double"] = 1.5;
+  value["array"].append(true);
+  value["array"].append(CVariant());
+
+  for (int compact = 0; compact < 2; compact++)
+  {
+    CJSONStreamWriter writer(compact == 1);
+    std::string output;
+
+    writer.StartObject();
+    writer.Key("value");
+    writer.Value(value);
+    writer.EndObject();
+    writer.Take(output);
+
+    CVariant expected;
+    expected["value"] = value;
+    EXPECT_STREQ(CJSONVariantWriter::Write(expected, compact == 1).c_str(), output.c_str());
+    EXPECT_EQ(0U, writer.GetSize());
+  }
+}
+
+TEST(TestJSONStreamWriter, TakeChunks)
+{
+  CVariant value;
+  for (unsigned int i = 0; i < 100; i++)
+  {
+    CVariant item;
+    CreateItem(i, item);
+    value.append(item);
+  }
+
+  CJSONStreamWriter writer(true);
+  writer.Value(value);
+
+  std::string output;
+  char buffer[7];
+  size_t size;
+  while ((size = writer.Take(buffer, sizeof(buffer))) > 0)
+    output.append(buffer, size);
+
+  EXPECT_STREQ(CJSONVariantWriter::Write(value, true).c_str(), output.c_str());
+}
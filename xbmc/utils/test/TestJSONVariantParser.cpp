@@ -19,9 +19,30 @@
  */
 
 #include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
 
 #include "gtest/gtest.h"
 
+#include <iostream>
+
+static std::string CreateSongs(unsigned int size)
+{
+  // keys are in the order CVariant sorts them so the output matches the input
+  std::string json = "{\"id\":1,\"jsonrpc\":\"2.0\",\"result\":{\"songs\":[";
+  for (unsigned int i = 0; i < size; i++)
+  {
+    if (i > 0)
+      json += ",";
+    json += StringUtils::Format("{\"file\":\"some artist - some album - %05u.flac\",\"genre\":[\"Rock\"],"
+                                "\"label\":\"Song %u\",\"songid\":%u}", i, i, i);
+  }
+  json += "]}}";
+
+  return json;
+}
+
 TEST(TestJSONVariantParser, Parse)
 {
   CVariant variant;
@@ -31,3 +52,55 @@ TEST(TestJSONVariantParser, Parse)
   variant = CJSONVariantParser::Parse(buf, sizeof(buf));
   EXPECT_TRUE(variant.isNull());
 }
+
+TEST(TestJSONVariantParser, RoundTrip)
+{
+  const unsigned int size = 100;
+
+  std::string json = CreateSongs(size);
+
+  CVariant variant = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  EXPECT_EQ(json, CJSONVariantWriter::Write(variant, true));
+
+  const CVariant &songs = variant["result"]["songs"];
+  ASSERT_EQ(size, songs.size());
+  for (unsigned int i = 0; i < size; i++)
+  {
+    EXPECT_EQ(i, songs[i]["songid"].asUnsignedInteger());
+    EXPECT_EQ(StringUtils::Format("Song %u", i), songs[i]["label"].asString());
+    EXPECT_STREQ("Rock", songs[i]["genre"][0].c_str());
+  }
+}
+
+// times parsing, writing and walking a large response, run with
+// --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(TestJSONVariantParser, DISABLED_Benchmark)
+{
+  const unsigned int size = 5000;
+  std::string json = CreateSongs(size);
+
+  CStopWatch watch;
+  watch.StartZero();
+  CVariant variant = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  float parseTime = watch.GetElapsedMilliseconds();
+
+  watch.StartZero();
+  std::string output = CJSONVariantWriter::Write(variant, true);
+  float writeTime = watch.GetElapsedMilliseconds();
+
+  watch.StartZero();
+  uint64_t sum = 0;
+  const CVariant &songs = variant["result"]["songs"];
+  for (CVariant::const_iterator_array it = songs.begin_array(); it != songs.end_array(); it++)
+  {
+    sum += (*it)["songid"].asUnsignedInteger();
+    sum += (*it)["label"].size();
+  }
+  float accessTime = watch.GetElapsedMilliseconds();
+
+  EXPECT_EQ(size, songs.size());
+  EXPECT_EQ(json, output);
+  EXPECT_LT(0U, sum);
+
+  std::cout << "Parse: " << parseTime << " ms, write: " << writeTime << " ms, access: " << accessTime << " ms for " << size << " items" << std::endl;
+}
@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/LoudnessMeter.h"
+
+#include <math.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void AddSine(CLoudnessMeter &meter, unsigned int sampleRate, unsigned int channels,
+                    double frequency, double amplitude, double phase, double seconds)
+{
+  unsigned int frames = (unsigned int)(sampleRate * seconds);
+  std::vector<float> samples(frames * channels);
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    float value = (float)(amplitude * sin(2.0 * M_PI * frequency * i / sampleRate + phase));
+    for (unsigned int c = 0; c < channels; c++)
+      samples[i * channels + c] = value;
+  }
+  // feed odd sized chunks to cover partial segments
+  for (unsigned int pos = 0; pos < frames; pos += 1000)
+    meter.AddFrames(&samples[pos * channels], std::min(1000U, frames - pos));
+}
+
+TEST(TestLoudnessMeter, Init)
+{
+  CLoudnessMeter meter;
+  std::vector<float> weights;
+  EXPECT_FALSE(meter.Init(48000, weights));
+  weights.push_back(1.0f);
+  EXPECT_FALSE(meter.Init(1000, weights));
+  EXPECT_TRUE(meter.Init(44100, weights));
+}
+
+TEST(TestLoudnessMeter, Sine)
+{
+  // a stereo 1kHz sine at -20dBFS measures -20 LUFS
+  unsigned int rates[] = { 44100, 48000, 96000 };
+  for (unsigned int i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+  {
+    CLoudnessMeter meter;
+    std::vector<float> weights(2, 1.0f);
+    ASSERT_TRUE(meter.Init(rates[i], weights));
+    AddSine(meter, rates[i], 2, 1000.0, 0.1, 0.0, 5.0);
+
+    double loudness;
+    ASSERT_TRUE(meter.GetIntegratedLoudness(loudness));
+    EXPECT_NEAR(-20.0, loudness, 0.1);
+    EXPECT_NEAR(2.0, CLoudnessMeter::GetReplayGain(loudness), 0.1);
+    EXPECT_NEAR(0.1f, meter.GetTruePeak(), 0.002f);
+    EXPECT_EQ((uint64_t)rates[i] * 5, meter.GetFrames());
+  }
+}
+
+TEST(TestLoudnessMeter, Gating)
+{
+  CLoudnessMeter meter;
+  std::vector<float> weights(2, 1.0f);
+  ASSERT_TRUE(meter.Init(48000, weights));
+
+  double loudness;
+  AddSine(meter, 48000, 2, 1000.0, 0.0, 0.0, 2.0);
+  EXPECT_FALSE(meter.GetIntegratedLoudness(loudness));
+
+  // neither silence nor a part 30dB below the rest affect the loudness
+  AddSine(meter, 48000, 2, 1000.0, 0.1, 0.0, 10.0);
+  AddSine(meter, 48000, 2, 1000.0, 0.00316, 0.0, 10.0);
+  ASSERT_TRUE(meter.GetIntegratedLoudness(loudness));
+  EXPECT_NEAR(-20.0, loudness, 0.2);
+}
+
+TEST(TestLoudnessMeter, ChannelWeights)
+{
+  // the LFE channel is ignored, surround channels are weighted by +1.5dB
+  CLoudnessMeter meter;
+  std::vector<float> weights;
+  weights.push_back(1.0f);
+  weights.push_back(0.0f);
+  weights.push_back(1.41f);
+  ASSERT_TRUE(meter.Init(48000, weights));
+  AddSine(meter, 48000, 3, 1000.0, 0.1, 0.0, 5.0);
+
+  double loudness;
+  ASSERT_TRUE(meter.GetIntegratedLoudness(loudness));
+  EXPECT_NEAR(-20.0 + 10.0 * log10(2.41 / 2.0), loudness, 0.1);
+}
+
+TEST(TestLoudnessMeter, TruePeak)
+{
+  // a sine at a quarter of the sample rate shifted by 45 degrees peaks
+  // between the samples at 3dB above the sample peak
+  CLoudnessMeter meter;
+  std::vector<float> weights(1, 1.0f);
+  ASSERT_TRUE(meter.Init(48000, weights));
+  AddSine(meter, 48000, 1, 12000.0, 0.5, M_PI / 4, 1.0);
+  EXPECT_GT(meter.GetTruePeak(), 0.48f);
+  EXPECT_LT(meter.GetTruePeak(), 0.52f);
+}
+
+TEST(TestLoudnessMeter, Merge)
+{
+  std::vector<float> weights(2, 1.0f);
+  CLoudnessMeter loud, quiet, album;
+  ASSERT_TRUE(loud.Init(44100, weights));
+  ASSERT_TRUE(quiet.Init(48000, weights));
+  ASSERT_TRUE(album.Init(44100, weights));
+  AddSine(loud, 44100, 2, 1000.0, 0.2, 0.0, 5.0);
+  AddSine(quiet, 48000, 2, 1000.0, 0.1, 0.0, 5.0);
+
+  album.Merge(loud);
+  album.Merge(quiet);
+
+  double loudness;
+  ASSERT_TRUE(album.GetIntegratedLoudness(loudness));
+  // mean of the energies of -14 and -20 LUFS
+  EXPECT_NEAR(10.0 * log10((pow(10.0, -1.4) + pow(10.0, -2.0)) / 2.0), loudness, 0.1);
+  EXPECT_NEAR(0.2f, album.GetTruePeak(), 0.004f);
+  EXPECT_EQ(loud.GetFrames() + quiet.GetFrames(), album.GetFrames());
+}
@@ -348,3 +348,38 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, SmallString)
+{
+  std::string shortstr("short"), longstr("a string which is too long to be stored inline");
+  CVariant a(shortstr), b(longstr), c;
+
+  EXPECT_STREQ(shortstr.c_str(), a.c_str());
+  EXPECT_EQ(shortstr, a.asString());
+  EXPECT_EQ(shortstr.size(), a.size());
+  EXPECT_STREQ(longstr.c_str(), b.c_str());
+  EXPECT_EQ(longstr, b.asString());
+  EXPECT_EQ(longstr.size(), b.size());
+
+  c = b;
+  EXPECT_TRUE(c == b);
+  c = a;
+  EXPECT_TRUE(c == a);
+  EXPECT_FALSE(c == b);
+
+  a.swap(b);
+  EXPECT_EQ(longstr, a.asString());
+  EXPECT_EQ(shortstr, b.asString());
+
+  a.clear();
+  EXPECT_TRUE(a.empty());
+  EXPECT_STREQ("", a.c_str());
+
+  CVariant d("1234567"), e("12345678"), f("123456789012345");
+  EXPECT_EQ(7U, d.size());
+  EXPECT_EQ(1234567, d.asInteger());
+  EXPECT_EQ(8U, e.size());
+  EXPECT_STREQ("12345678", e.c_str());
+  EXPECT_EQ(123456789012345LL, f.asInteger());
+  EXPECT_EQ(123456789012345ULL, f.asUnsignedInteger());
+}
@@ -0,0 +1,171 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/YUVUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+// widths are chosen to exercise both the vector loops and the remainders
+static const int widths[] = { 2, 16, 38, 64, 102 };
+
+// the last pixel of odd widths takes a macropixel of its own
+static const int oddWidths[] = { 1, 17, 39 };
+
+static void FillPattern(std::vector<uint8_t> &buffer, int seed)
+{
+  for (size_t i = 0; i < buffer.size(); i++)
+    buffer[i] = (uint8_t)(i * 7 + seed * 13 + (i >> 5));
+}
+
+TEST(TestYUVUtils, CopyPlane)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int width = widths[i], height = 5;
+    int srcStride = width + 3, dstStride = width + 9;
+    std::vector<uint8_t> src(srcStride * height), dst(dstStride * height, 0xAA);
+    FillPattern(src, width);
+
+    CYUVUtils::CopyPlane(&dst[0], dstStride, &src[0], srcStride, width, height);
+
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+        EXPECT_EQ(src[y * srcStride + x], dst[y * dstStride + x]);
+      for (int x = width; x < dstStride; x++)
+        EXPECT_EQ(0xAA, dst[y * dstStride + x]);
+    }
+  }
+}
+
+TEST(TestYUVUtils, InterleaveUV)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int width = widths[i], height = 4;
+    int srcStride = width + 1, dstStride = width * 2 + 4;
+    std::vector<uint8_t> u(srcStride * height), v(srcStride * height), dst(dstStride * height, 0xAA);
+    FillPattern(u, 1);
+    FillPattern(v, 2);
+
+    CYUVUtils::InterleaveUV(&dst[0], dstStride, &u[0], srcStride, &v[0], srcStride, width, height);
+
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        EXPECT_EQ(u[y * srcStride + x], dst[y * dstStride + 2 * x]);
+        EXPECT_EQ(v[y * srcStride + x], dst[y * dstStride + 2 * x + 1]);
+      }
+      for (int x = width * 2; x < dstStride; x++)
+        EXPECT_EQ(0xAA, dst[y * dstStride + x]);
+    }
+  }
+}
+
+TEST(TestYUVUtils, DeinterleaveUV)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int width = widths[i], height = 4;
+    int srcStride = width * 2 + 6, dstStride = width + 2;
+    std::vector<uint8_t> src(srcStride * height), u(dstStride * height, 0xAA), v(dstStride * height, 0xAA);
+    FillPattern(src, 3);
+
+    CYUVUtils::DeinterleaveUV(&u[0], dstStride, &v[0], dstStride, &src[0], srcStride, width, height);
+
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        EXPECT_EQ(src[y * srcStride + 2 * x],     u[y * dstStride + x]);
+        EXPECT_EQ(src[y * srcStride + 2 * x + 1], v[y * dstStride + x]);
+      }
+      for (int x = width; x < dstStride; x++)
+      {
+        EXPECT_EQ(0xAA, u[y * dstStride + x]);
+        EXPECT_EQ(0xAA, v[y * dstStride + x]);
+      }
+    }
+  }
+}
+
+static void CheckPackYUV422(const int *widths, size_t count, bool uyvy)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    int width = widths[i], height = 6;
+    int packed = (width + 1) & ~1;
+    int yStride = width + 5, cStride = packed / 2 + 3, dstStride = packed * 2 + 8;
+    std::vector<uint8_t> y(yStride * height), u(cStride * height / 2), v(cStride * height / 2);
+    std::vector<uint8_t> dst(dstStride * height, 0xAA);
+    FillPattern(y, 4);
+    FillPattern(u, 5);
+    FillPattern(v, 6);
+
+    CYUVUtils::PackYUV422(&dst[0], dstStride, &y[0], yStride, &u[0], cStride, &v[0], cStride, width, height, uyvy);
+
+    for (int row = 0; row < height; row++)
+    {
+      const uint8_t *d = &dst[row * dstStride];
+      for (int x = 0; x < width; x += 2)
+      {
+        uint8_t y0 = y[row * yStride + x];
+        uint8_t y1 = x + 1 < width ? y[row * yStride + x + 1] : y0;
+        uint8_t cu = u[(row / 2) * cStride + x / 2];
+        uint8_t cv = v[(row / 2) * cStride + x / 2];
+        if (uyvy)
+        {
+          EXPECT_EQ(cu, d[2 * x]);
+          EXPECT_EQ(y0, d[2 * x + 1]);
+          EXPECT_EQ(cv, d[2 * x + 2]);
+          EXPECT_EQ(y1, d[2 * x + 3]);
+        }
+        else
+        {
+          EXPECT_EQ(y0, d[2 * x]);
+          EXPECT_EQ(cu, d[2 * x + 1]);
+          EXPECT_EQ(y1, d[2 * x + 2]);
+          EXPECT_EQ(cv, d[2 * x + 3]);
+        }
+      }
+      for (int x = packed * 2; x < dstStride; x++)
+        EXPECT_EQ(0xAA, d[x]);
+    }
+  }
+}
+
+TEST(TestYUVUtils, PackYUY2)
+{
+  CheckPackYUV422(widths, sizeof(widths) / sizeof(widths[0]), false);
+}
+
+TEST(TestYUVUtils, PackUYVY)
+{
+  CheckPackYUV422(widths, sizeof(widths) / sizeof(widths[0]), true);
+}
+
+TEST(TestYUVUtils, PackOddWidth)
+{
+  CheckPackYUV422(oddWidths, sizeof(oddWidths) / sizeof(oddWidths[0]), false);
+  CheckPackYUV422(oddWidths, sizeof(oddWidths) / sizeof(oddWidths[0]), true);
+}
@@ -30,6 +30,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "TextureCache.h"
 #include "utils/log.h"
+#include "utils/CPUInfo.h"
 #include "video/VideoInfoTag.h"
 #include "video/VideoDatabase.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
@@ -110,8 +111,10 @@ bool CThumbExtractor::DoWork()
   return result;
 }
 
+// extraction is CPU bound, so run as many jobs at once as we have cores (the
+// job manager further limits the number of low priority jobs running).
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, std::max(1, g_cpuInfo.getCPUCount())), m_pStreamDetailsObs(NULL)
 {
   m_database = new CVideoDatabase();
 }
@@ -32,6 +32,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
+#include "GUILargeTextureManager.h"
 #include "utils/Variant.h"
 
 #include <climits>
@@ -111,6 +112,11 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+    unsigned int textures, bytes, deferred;
+    g_largeTextureManager.GetUploadStats(textures, bytes, deferred);
+    CStdString uploads;
+    uploads.Format("\nTEX: %u uploads (%u KB), %u deferred", textures, bytes / 1024, deferred);
+    info += uploads;
   }
 
   // render the skin debug info